@@ -178,6 +178,7 @@ group "core"
             {
                 '{COPYDIR} -n "%{wks.location}/assets" "%{wks.location}/bin/' .. outputs .. '/%{prj.name}"',
                 '{COPYDIR} -n "%{wks.location}/config" "%{wks.location}/bin/' .. outputs .. '/%{prj.name}"',
+                'python3 "%{wks.location}/scripts/pack_assets.py" --root "%{wks.location}" --output "%{wks.location}/bin/' .. outputs .. '/%{prj.name}/assets.pack"',     -- fonts, icons and default configs in one mapped file
                 '{MKDIR} "%{wks.location}/bin/' .. outputs .. '/%{prj.name}/kokoro"',
                 '{COPY} -n "%{wks.location}/kokoro/kokoro_tts.py" "%{wks.location}/bin/' .. outputs .. '/%{prj.name}/kokoro"',
                 '{COPY} -n "%{wks.location}/kokoro/setup_venv.sh" "%{wks.location}/bin/' .. outputs .. '/%{prj.name}/kokoro"',
@@ -218,6 +219,7 @@ group "core"
 
                 '{COPYDIR} -n "%{wks.location}/assets" "%{wks.location}/bin/' .. outputs .. '/%{prj.name}/assets"',
                 '{COPYDIR} -n "%{wks.location}/config" "%{wks.location}/bin/' .. outputs .. '/%{prj.name}/config"',
+                'python "%{wks.location}/scripts/pack_assets.py" --root "%{wks.location}" --output "%{wks.location}/bin/' .. outputs .. '/%{prj.name}/assets.pack"',
                 '{COPYDIR} -n "%{wks.location}/vendor/glfw/bin/' .. outputs .. '/glfw" "%{wks.location}/bin/' .. outputs .. '/%{prj.name}"',       -- copy GLFW
             }
 
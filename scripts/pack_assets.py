@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+# Bakes the assets and default configs needed at startup into a single file (assets.pack) that the application memory-maps.
+# Runtime reader: src/util/io/asset_pack.h
+#
+# File layout (little endian):
+#   header:     u32 magic ("ATPK"), u32 version, u32 entry_count, u32 name_table_size
+#   entries:    entry_count * { u64 offset, u64 stored_size, u64 size, u64 content_hash, u32 name_offset, u32 name_length, u32 flags, u32 reserved }
+#   name table: UTF-8 names relative to the pack root, '/' separated, not terminated
+#   data:       payloads, each aligned to 16 bytes, zlib compressed if flags & 1
+#
+# usage: pack_assets.py --root <project dir> --output <bin dir>/assets.pack [pattern ...]
+
+import argparse
+import glob
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = 0x4B505441                  # "ATPK"
+VERSION = 1
+FLAG_COMPRESSED = 1
+ALIGNMENT = 16
+MIN_SAVING = 0.9                    # only store compressed if it saves at least 10% (PNGs are already compressed)
+
+DEFAULT_PATTERNS = [
+    "assets/images/*.png",
+    "assets/fonts/Open_Sans/static/OpenSans-Regular.ttf",
+    "assets/fonts/Open_Sans/static/OpenSans-Bold.ttf",
+    "assets/fonts/Open_Sans/static/OpenSans-Italic.ttf",
+    "assets/fonts/Inconsolata/static/Inconsolata-Regular.ttf",
+    "config/*.yml",
+]
+
+
+def fnv1a_64(data):
+    value = 0xcbf29ce484222325
+    for byte in data:
+        value ^= byte
+        value = (value * 0x100000001b3) & 0xFFFFFFFFFFFFFFFF
+    return value
+
+
+def collect_files(root, patterns):
+    files = set()
+    for pattern in patterns:
+        matches = glob.glob(os.path.join(root, pattern))
+        if not matches:
+            print(f"pack_assets: pattern [{pattern}] matched no files", file=sys.stderr)
+        files.update(os.path.relpath(match, root).replace(os.sep, "/") for match in matches if os.path.isfile(match))
+    return sorted(files)
+
+
+def build_pack(root, names):
+    entries = []
+    payloads = []
+    name_table = bytearray()
+    for name in names:
+        with open(os.path.join(root, name), "rb") as file:
+            data = file.read()
+
+        compressed = zlib.compress(data, 9)
+        use_compressed = len(compressed) < len(data) * MIN_SAVING
+        stored = compressed if use_compressed else data
+        entries.append([0, len(stored), len(data), fnv1a_64(data), len(name_table), len(name.encode("utf-8")), FLAG_COMPRESSED if use_compressed else 0])
+        payloads.append(stored)
+        name_table += name.encode("utf-8")
+
+    header_size = 16 + len(entries) * 48 + len(name_table)
+    offset = (header_size + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+    for entry, payload in zip(entries, payloads):
+        entry[0] = offset
+        offset = (offset + len(payload) + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+
+    output = bytearray(struct.pack("<IIII", MAGIC, VERSION, len(entries), len(name_table)))
+    for entry in entries:
+        output += struct.pack("<QQQQIIII", *entry, 0)
+    output += name_table
+    for entry, payload in zip(entries, payloads):
+        output += b"\0" * (entry[0] - len(output))
+        output += payload
+    return bytes(output)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Bake startup assets into a single memory-mappable pack")
+    parser.add_argument("--root", required=True, help="directory the packed names are relative to (project root)")
+    parser.add_argument("--output", required=True, help="path of the pack file to write")
+    parser.add_argument("patterns", nargs="*", default=DEFAULT_PATTERNS, help="glob patterns relative to --root")
+    args = parser.parse_args()
+
+    names = collect_files(args.root, args.patterns)
+    pack = build_pack(args.root, names)
+
+    # skip the write if nothing changed, keeps the timestamp (and the font atlas cache) stable
+    if os.path.isfile(args.output):
+        with open(args.output, "rb") as file:
+            if file.read() == pack:
+                return 0
+
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    temp_path = args.output + ".tmp"
+    with open(temp_path, "wb") as file:
+        file.write(pack)
+    os.replace(temp_path, args.output)
+    print(f"pack_assets: wrote [{args.output}] with {len(names)} files ({len(pack)} bytes)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -5,12 +5,14 @@
 
 #include "util/crash_handler.h"
 #include "util/util.h"
+#include "util/io/asset_pack.h"
 #include "platform/window.h"
 #include "events/event.h"
 #include "events/application_event.h"
 #include "events/mouse_event.h"
 #include "events/key_event.h"
 #include "render/renderer.h"
+#include "render/image_cache.h"
 
 #if defined(RENDER_API_OPENGL)
     #include "render/open_GL/GL_renderer.h"
@@ -27,6 +29,11 @@ namespace AT {
     application* application::s_instance = nullptr;
     ref<window> application::s_window;
     bool application::s_running;
+    std::atomic<bool> application::s_redraw_requested = true;
+
+    #define LAZY_REDRAW_SETTLE_FRAMES           3
+    #define LAZY_REDRAW_IDLE_TIMEOUT            1.0             // seconds, keeps timers like auto-save ticking
+    #define LAZY_REDRAW_TEXT_INPUT_TIMEOUT      0.4             // seconds, lets the text cursor blink
 
     application::application(int argc, char* argv[]) {
 
@@ -35,6 +42,8 @@ namespace AT {
         s_instance = this;
     
         // ----------- general subsystems -----------
+        m_asset_pack = create_ref<io::asset_pack>(util::get_executable_path() / ASSET_PACK_FILE, util::get_executable_path());
+        m_asset_pack->extract_missing(util::get_executable_path() / CONFIG_DIR);     // default configs on first start
     #if defined(PLATFORM_LINUX)
         util::init_qt();
     #endif
@@ -48,6 +57,7 @@ namespace AT {
     #elif defined(RENDER_API_VULKAN)
         m_renderer = create_ref<AT::render::vulkan::VK_renderer>(s_window);
     #endif
+        m_image_cache = create_ref<AT::render::image_cache>(m_asset_pack);
 
         // ----------- user defined system -----------
         m_imgui_config = create_ref<UI::imgui_config>();
@@ -60,6 +70,7 @@ namespace AT {
         m_dashboard.reset();
         AT::crash_handler::unsubscribe(m_crash_sub);
 		m_imgui_config.reset();
+        m_image_cache.reset();              // textures must be deleted while the render context is alive
         
         m_renderer->resource_free();         // need to call free manually because some destructors need the applications access to the renderer (eg: image)
 		m_renderer.reset();
@@ -75,8 +86,16 @@ namespace AT {
     
         // ---------------------------------------- finished setup ----------------------------------------
         bool long_startup_process = false;
+        bool vsync = false;
+        bool precise_frame_pacing = false;
 		AT::serializer::yaml(config::get_filepath_from_configtype(util::get_executable_path(), config::file::app_settings), "general_settings", AT::serializer::option::load_from_file)
-			.entry(KEY_VALUE(long_startup_process));
+			.entry(KEY_VALUE(long_startup_process))
+			.entry("lazy_redraw", m_lazy_redraw)
+			.entry(KEY_VALUE(vsync))
+			.entry(KEY_VALUE(precise_frame_pacing));
+
+        set_vsync(vsync);
+        set_pacing_policy(precise_frame_pacing ? util::pacing_policy::precise : util::pacing_policy::low_power);
 
         if (long_startup_process) {
 
@@ -119,11 +138,21 @@ namespace AT {
         // ---------------------------------------- main loop ----------------------------------------
         while (s_running) {
     
-            PROFILE_SCOPE("run")
-            s_window->poll_events();				// update internal state
+            PROFILE_SCOPE("run");
+            const bool idle = m_lazy_redraw && m_settle_frames == 0 && !s_redraw_requested.exchange(false);
+            if (idle) {                             // nothing changed, sleep until input, a window event, a worker signal or the timeout
+                const f32 wait_start = static_cast<f32>(glfwGetTime());
+                s_window->wait_events(ImGui::GetIO().WantTextInput ? LAZY_REDRAW_TEXT_INPUT_TIMEOUT : LAZY_REDRAW_IDLE_TIMEOUT);
+                m_idle_time = static_cast<f32>(glfwGetTime()) - wait_start;
+            } else
+                s_window->poll_events();			// update internal state
+
+            m_image_cache->upload_pending();
             m_dashboard->update(m_delta_time);
             m_renderer->draw_frame(m_delta_time);
             limit_fps();
+            if (m_settle_frames > 0)
+                m_settle_frames--;
         }
     
         LOG(Trace, "Exiting main run loop")
@@ -143,7 +172,21 @@ namespace AT {
     }
 
 
-    void application::set_fps_settings(u32 target_fps)              { target_duration = static_cast<f32>(1.0 / target_fps); }
+    void application::set_fps_settings(u32 target_fps)              { m_frame_pacer.set_target_fps(target_fps); }
+
+
+    void application::set_vsync(const bool vsync) {
+
+        s_window->set_vsync(vsync);                 // swap blocks until vblank, the pacer only measures then
+        m_frame_pacer.set_vsync(vsync);
+    }
+
+
+    void application::request_redraw() {
+
+        s_redraw_requested.store(true, std::memory_order_relaxed);
+        glfwPostEmptyEvent();
+    }
 
     // ==================================================================== PRIVATE ====================================================================
 
@@ -155,26 +198,31 @@ namespace AT {
 
     void application::limit_fps() {
     
-        m_work_time = static_cast<f32>(glfwGetTime()) - m_last_frame_time;
-        if (m_work_time < target_duration) {
-    
-            // PROFILE_SCOPE("sleep");
-            m_sleep_time = (target_duration - m_work_time) * 1000;
-            util::high_precision_sleep(m_sleep_time / 1000);
-        } else
-            m_sleep_time = 0;
+        m_work_time = math::max(static_cast<f32>(glfwGetTime()) - m_last_frame_time - m_idle_time, 0.f);     // the idle wait for events counts as sleep
+        m_idle_time = 0.f;
+        m_frame_pacer.wait();                       // absolute deadlines, no busy-wait in [low_power]
     
         f32 time = static_cast<f32>(glfwGetTime());
+        m_sleep_time = math::max((time - m_last_frame_time - m_work_time) * 1000, 0.f);
         m_delta_time = std::min<f32>(time - m_last_frame_time, 100000);
         m_absolute_time += m_delta_time;
         m_last_frame_time = time;
         m_fps = static_cast<u32>(1.0 / (m_work_time + (m_sleep_time * 0.001)) + 0.5); // Round to nearest integer
+
+        auto& metrik = m_renderer->get_general_performance_metrik_ref();         // history for the performance overlay
+        metrik.work_time = m_work_time * 1000;
+        metrik.sleep_time = m_sleep_time;
+        metrik.renderer_draw_time[metrik.current_index] = metrik.work_time;
+        metrik.waiting_idle_time[metrik.current_index] = metrik.sleep_time;
+        metrik.next_iteration();
     }
     
     // ==================================================================== event handling ====================================================================
     
     void application::on_event(event& event) {
     
+        m_settle_frames = LAZY_REDRAW_SETTLE_FRAMES;
+
         // application events
         event_dispatcher dispatcher(event);
         dispatcher.dispatch<window_close_event>(BIND_FUNCTION(application::on_window_close));
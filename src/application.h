@@ -3,6 +3,7 @@
 
 #include "config/imgui_config.h"
 #include "dashboard/dashboard.h"
+#include "util/timing/frame_pacer.h"
 
 namespace AT {
 
@@ -14,7 +15,8 @@ namespace AT {
     class window_focus_event;
     class dashboard;
     namespace UI        { class imgui_config; }
-    namespace render    { class renderer; }
+    namespace render    { class renderer; class image_cache; }
+    namespace io        { class asset_pack; }
 
     class application {
     public:
@@ -24,6 +26,8 @@ namespace AT {
 
         DEFAULT_GETTER_C(f64,											    delta_time);
         DEFAULT_GETTER(ref<AT::render::renderer>,					        renderer);
+        DEFAULT_GETTER(ref<AT::render::image_cache>,                        image_cache);
+        DEFAULT_GETTER(ref<AT::io::asset_pack>,                             asset_pack);
         DEFAULT_GETTER_S(ref<window>,							            window);
         DEFAULT_GETTER_REF(ref<UI::imgui_config>,                           imgui_config);
         DEFAULT_GETTER(ref<dashboard>,                                      dashboard);
@@ -31,6 +35,12 @@ namespace AT {
         FORCEINLINE static application& get()								{ return *s_instance; }
         FORCEINLINE static void close_application()							{ s_running = false; }
 
+        // Wakes the main loop from its idle wait so the next frame is drawn. Thread-safe, used by workers to publish progress/completion.
+        static void request_redraw();
+
+        // Requests the next frame without waking the loop, called by animated widgets while they are visible (UI thread only).
+        FORCEINLINE static void request_animation_frame()                  { s_redraw_requested.store(true, std::memory_order_relaxed); }
+
         bool update(f32 delta_time);
         bool draw(f32 delta_time);
         void run();
@@ -38,12 +48,18 @@ namespace AT {
         // ---------------------- fps control ---------------------- 
         void set_fps_settings(u32 target_fps);
         void set_fps_settings(const bool set_for_engine_focused, const u32 new_limit);
+        void set_pacing_policy(const util::pacing_policy policy)          { m_frame_pacer.set_policy(policy); }
+        void set_vsync(const bool vsync);
+        FORCEINLINE const util::frame_pacer& get_frame_pacer() const       { return m_frame_pacer; }
+        DEFAULT_GETTER_C(u32,                                               fps);
 
     protected:
 
         ref<UI::imgui_config>               m_imgui_config;
         std::vector<event>			        m_event_queue;		// TODO: change to queue
         ref<AT::render::renderer>           m_renderer{};
+        ref<AT::render::image_cache>        m_image_cache{};
+        ref<AT::io::asset_pack>             m_asset_pack{};
 
     private:
 
@@ -61,19 +77,23 @@ namespace AT {
         static application*			        s_instance;
         static ref<window>		            s_window;
         static bool					        s_running;
+        static std::atomic<bool>            s_redraw_requested;
 
         ref<dashboard>                      m_dashboard;
         u64                                 m_crash_sub = 0;
         bool						        m_focus = true;
         bool                                m_is_titlebar_hovered = false;
+        bool                                m_lazy_redraw = true;               // wait for events instead of drawing at [m_target_fps] while idle
+        u32                                 m_settle_frames = 0;                // frames still drawn after the last event so ImGui can settle hover/layout state
         u32							        m_target_fps = 60;
         u32							        m_nonefocus_fps = 30;
         u32							        m_fps{};
         f32							        m_delta_time = 0.f;
         f32							        m_absolute_time = 0.f;
         f32							        m_work_time{}, m_sleep_time{};
-        f32							        target_duration{};
+        f32							        m_idle_time = 0.f;                  // seconds spent in [window::wait_events()] this frame
         f32							        m_last_frame_time = 0.f;
+        util::frame_pacer                   m_frame_pacer{};
     };
 
 }
@@ -0,0 +1,178 @@
+#include "util/pch.h"
+
+#include <imgui.h>
+#include <imgui_internal.h>
+
+#include "util/io/io.h"
+#include "util/io/serializer_binary.h"
+
+#include "font_atlas_cache.h"
+
+namespace AT::UI {
+
+	#define FONT_ATLAS_CACHE_VERSION		2u							// schema version stored in the [serializer::binary] header
+	#define FONT_ATLAS_CACHE_EXTENSION		".fontatlas"
+
+	// Per-font data needed to recreate an ImFont without its TTF
+	struct cached_font_metrics {
+		f32		size = 0.f;
+		f32		ascent = 0.f;
+		f32		descent = 0.f;
+	};
+
+
+	font_atlas_cache::font_atlas_cache(const std::filesystem::path& directory, const u32 max_files)
+		: m_directory(directory), m_max_files(max_files) {}
+
+
+	bool font_atlas_cache::load(ImFontAtlas* atlas, const std::vector<font_request>& requests, std::unordered_map<std::string, ImFont*>& fonts) const {
+
+		const u64 key = compute_key(requests);
+		const std::filesystem::path file = get_cache_file(key);
+		if (!std::filesystem::exists(file))
+			return false;
+
+		serializer::binary archive(file, "font_atlas", serializer::option::load_from_file);
+		u32 font_count = 0;
+		u64 stored_key = 0;
+		archive.entry(stored_key).entry(font_count);
+		if (!archive.is_valid() || archive.get_version() != FONT_ATLAS_CACHE_VERSION || stored_key != key || font_count != requests.size())
+			return false;
+
+		int width = 0, height = 0;
+		ImVec2 uv_scale, uv_white_pixel;
+		std::vector<ImVec4> uv_lines;
+		std::vector<u8> pixels;
+		archive.entry(width).entry(height).entry(uv_scale).entry(uv_white_pixel).entry(uv_lines).entry(pixels);
+		if (!archive.is_valid() || width <= 0 || height <= 0 || pixels.size() != static_cast<size_t>(width) * height || uv_lines.size() != IM_ARRAYSIZE(atlas->TexUvLines))
+			return false;
+
+		std::vector<cached_font_metrics> metrics(font_count);
+		std::vector<std::vector<ImFontGlyph>> glyphs(font_count);
+		for (u32 x = 0; x < font_count; x++)
+			archive.entry(metrics[x]).entry(glyphs[x]);
+		if (!archive.is_valid())
+			return false;
+
+		// everything is read and valid, replace the atlas content
+		atlas->Clear();
+		atlas->Flags |= ImFontAtlasFlags_NoMouseCursors;						// cursor shapes are custom rects that only exist during a real build
+		atlas->TexWidth = width;
+		atlas->TexHeight = height;
+		atlas->TexPixelsAlpha8 = static_cast<unsigned char*>(IM_ALLOC(pixels.size()));
+		std::memcpy(atlas->TexPixelsAlpha8, pixels.data(), pixels.size());
+		atlas->TexUvScale = uv_scale;
+		atlas->TexUvWhitePixel = uv_white_pixel;
+		std::memcpy(atlas->TexUvLines, uv_lines.data(), sizeof(atlas->TexUvLines));
+
+		fonts.clear();
+		for (u32 x = 0; x < font_count; x++) {
+
+			ImFont* font = IM_NEW(ImFont);
+			font->ContainerAtlas = atlas;
+			font->FontSize = metrics[x].size;
+			font->Ascent = metrics[x].ascent;
+			font->Descent = metrics[x].descent;
+			font->Glyphs.resize(static_cast<int>(glyphs[x].size()));
+			std::memcpy(font->Glyphs.Data, glyphs[x].data(), glyphs[x].size() * sizeof(ImFontGlyph));
+			font->BuildLookupTable();											// also resolves the fallback and ellipsis glyphs
+			atlas->Fonts.push_back(font);
+			fonts[requests[x].name] = font;
+		}
+		atlas->TexReady = true;
+
+		LOG(Trace, "Loaded font atlas [" << width << "x" << height << "] with [" << font_count << "] fonts from cache")
+		return true;
+	}
+
+
+	void font_atlas_cache::save(ImFontAtlas* atlas, const std::vector<font_request>& requests) const {
+
+		unsigned char* pixels = nullptr;
+		int width = 0, height = 0;
+		atlas->GetTexDataAsAlpha8(&pixels, &width, &height);					// builds the atlas if needed
+		VALIDATE(pixels && atlas->Fonts.Size == static_cast<int>(requests.size()), return, "", "Font atlas does not match the requested fonts, not caching it")
+
+		io::create_directory(m_directory);
+		const u64 key = compute_key(requests);
+		const std::filesystem::path file = get_cache_file(key);
+		const std::filesystem::path temp_file = file.string() + ".tmp";
+		{
+			serializer::binary archive(temp_file, "font_atlas", serializer::option::save_to_file, FONT_ATLAS_CACHE_VERSION);
+			u32 font_count = static_cast<u32>(requests.size());
+			u64 stored_key = key;
+			ImVec2 uv_scale = atlas->TexUvScale, uv_white_pixel = atlas->TexUvWhitePixel;
+			std::vector<ImVec4> uv_lines(std::begin(atlas->TexUvLines), std::end(atlas->TexUvLines));
+			std::vector<u8> pixel_data(pixels, pixels + static_cast<size_t>(width) * height);
+			archive.entry(stored_key).entry(font_count)
+				.entry(width).entry(height).entry(uv_scale).entry(uv_white_pixel).entry(uv_lines).entry(pixel_data);
+
+			for (const ImFont* font : atlas->Fonts) {
+				cached_font_metrics metrics{ font->FontSize, font->Ascent, font->Descent };
+				std::vector<ImFontGlyph> glyphs(font->Glyphs.begin(), font->Glyphs.end());
+				archive.entry(metrics).entry(glyphs);
+			}
+			VALIDATE(archive.flush(), return, "", "Failed to write font atlas cache [" << temp_file.generic_string() << "]")
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temp_file, file, error);						// readers never see a half written file
+		VALIDATE(!error, std::filesystem::remove(temp_file, error); return, "", "Failed to move font atlas cache into place: " << error.message())
+
+		LOG(Trace, "Cached font atlas [" << width << "x" << height << "] as [" << file.filename().generic_string() << "]")
+		remove_old_files();
+	}
+
+
+	u64 font_atlas_cache::compute_key(const std::vector<font_request>& requests) const {
+
+		std::size_t seed = 0;
+		math::hash_combine(seed, IMGUI_VERSION_NUM, FONT_ATLAS_CACHE_VERSION);
+		for (const auto& request : requests) {
+
+			math::hash_combine(seed, request.name, request.file.generic_string(), request.size);
+			if (request.content_hash)
+				math::hash_combine(seed, request.content_hash);
+			else {
+				std::error_code error;
+				const auto file_size = std::filesystem::file_size(request.file, error);
+				const auto write_time = std::filesystem::last_write_time(request.file, error).time_since_epoch().count();
+				math::hash_combine(seed, static_cast<u64>(file_size), static_cast<int64>(write_time));
+			}
+
+			if (request.glyph_ranges)
+				for (const ImWchar* range = request.glyph_ranges; *range; range++)
+					math::hash_combine(seed, static_cast<u32>(*range));
+			else
+				math::hash_combine(seed, 0u);
+		}
+		return static_cast<u64>(seed);
+	}
+
+
+	std::filesystem::path font_atlas_cache::get_cache_file(const u64 key) const {
+
+		std::ostringstream name;
+		name << std::hex << std::setw(16) << std::setfill('0') << key << FONT_ATLAS_CACHE_EXTENSION;
+		return m_directory / name.str();
+	}
+
+
+	// Keeps the [m_max_files] most recently written atlases, so switching back and forth between sizes stays cached
+	void font_atlas_cache::remove_old_files() const {
+
+		std::error_code error;
+		std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> files;
+		for (const auto& entry : std::filesystem::directory_iterator(m_directory, error))
+			if (entry.is_regular_file() && entry.path().extension() == FONT_ATLAS_CACHE_EXTENSION)
+				files.emplace_back(entry.last_write_time(error), entry.path());
+
+		if (files.size() <= m_max_files)
+			return;
+
+		std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+		for (size_t x = m_max_files; x < files.size(); x++)
+			std::filesystem::remove(files[x].second, error);
+	}
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <imgui.h>
+
+
+namespace AT::UI {
+
+	// One font that should end up in the atlas
+	struct font_request {
+		std::string					name{};							// key in imgui_config::m_fonts
+		std::filesystem::path		file{};							// TTF/OTF file
+		f32							size = 0.f;						// pixel size
+		const ImWchar*				glyph_ranges = nullptr;			// zero terminated pairs, nullptr = ImGui default (Latin + Latin-1)
+		u64							content_hash = 0;				// hash of the font data if known (asset pack), replaces file size/time in the key
+	};
+
+	// Caches fully rasterized ImGui font atlases on disk, so startup and font size changes do not rasterize TTF files.
+	// A cache file stores the alpha8 texture, the atlas UV data and the glyph tables of every font. It is keyed by
+	// the ImGui version and every request (file, content hash or file size + modification time, pixel size, glyph ranges).
+	// Restoring a cached atlas fills [ImFontAtlas] directly and marks it as built, the renderer then only uploads the texture.
+	class font_atlas_cache {
+	public:
+
+		// @param directory Where cache files are stored, created on first save.
+		// @param max_files Oldest files beyond this count are deleted when saving.
+		font_atlas_cache(const std::filesystem::path& directory, const u32 max_files = 8);
+
+		// Loads the atlas for [requests] into [atlas] if a matching cache file exists.
+		// @param atlas Cleared and filled on success, untouched otherwise.
+		// @param requests The fonts the atlas must contain, in order.
+		// @param fonts Receives the restored fonts by request name on success.
+		// @return true if the atlas was restored from the cache.
+		bool load(ImFontAtlas* atlas, const std::vector<font_request>& requests, std::unordered_map<std::string, ImFont*>& fonts) const;
+
+		// Builds [atlas] (if not built yet) and writes it to the cache.
+		// @param atlas Must contain exactly the fonts of [requests], in order.
+		// @param requests The fonts that were added to the atlas.
+		void save(ImFontAtlas* atlas, const std::vector<font_request>& requests) const;
+
+	private:
+
+		u64 compute_key(const std::vector<font_request>& requests) const;
+		std::filesystem::path get_cache_file(const u64 key) const;
+		void remove_old_files() const;
+
+		std::filesystem::path				m_directory{};
+		u32									m_max_files = 8;
+	};
+
+}
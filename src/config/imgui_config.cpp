@@ -7,6 +7,7 @@
 
 #include "util/system.h"
 #include "util/io/serializer_yaml.h"
+#include "util/io/asset_pack.h"
 #include "util/ui/pannel_collection.h"
 #include "util/ui/window_images.embed"
 
@@ -14,6 +15,7 @@
 #include "render/renderer.h"
 //#include "render/image.h"
 
+#include "font_atlas_cache.h"
 #include "imgui_config.h"
 
 
@@ -67,24 +69,53 @@ namespace AT::UI {
 		std::filesystem::path font_path = base_path / "Open_Sans" / "static";
 		std::filesystem::path Inconsolata_path = base_path / "Inconsolata" / "static";
 
-		io.FontAllowUserScaling = true;
-		m_fonts["regular"] =		io.Fonts->AddFontFromFileTTF((font_path/ "OpenSans-Regular.ttf").string().c_str(), g_font_size);
-		m_fonts["bold"] =			io.Fonts->AddFontFromFileTTF((font_path/ "OpenSans-Bold.ttf").string().c_str(), g_font_size);
-		m_fonts["italic"] =			io.Fonts->AddFontFromFileTTF((font_path/ "OpenSans-Italic.ttf").string().c_str(), g_font_size);
+		// Only rasterize what is actually displayed: Latin-1 plus typographic punctuation (dashes, quotes, ellipsis) for text and code blocks,
+		// plain ASCII for the giant font which only shows fixed strings. Must outlive the atlas build, hence static.
+		static const ImWchar text_ranges[] = { 0x0020, 0x00FF, 0x2010, 0x205E, 0 };
+		static const ImWchar ascii_ranges[] = { 0x0020, 0x007E, 0 };
+
+		std::vector<font_request> requests = {
+			{ "regular",					font_path / "OpenSans-Regular.ttf",				g_font_size,				text_ranges },
+			{ "bold",						font_path / "OpenSans-Bold.ttf",				g_font_size,				text_ranges },
+			{ "italic",					font_path / "OpenSans-Italic.ttf",				g_font_size,				text_ranges },
+
+			{ "regular_big",				font_path / "OpenSans-Regular.ttf",				g_big_font_size,			text_ranges },
+			{ "bold_big",					font_path / "OpenSans-Bold.ttf",				g_big_font_size,			text_ranges },
+			{ "italic_big",				font_path / "OpenSans-Italic.ttf",				g_big_font_size,			text_ranges },
 
-		m_fonts["regular_big"] =	io.Fonts->AddFontFromFileTTF((font_path / "OpenSans-Regular.ttf").string().c_str(), g_big_font_size);
-		m_fonts["bold_big"] =		io.Fonts->AddFontFromFileTTF((font_path / "OpenSans-Bold.ttf").string().c_str(), g_big_font_size);
-		m_fonts["italic_big"] =		io.Fonts->AddFontFromFileTTF((font_path / "OpenSans-Italic.ttf").string().c_str(), g_big_font_size);
+			{ "header_0",					font_path / "OpenSans-Regular.ttf",				g_font_size_header_2,		text_ranges },
+			{ "header_1",					font_path / "OpenSans-Regular.ttf",				g_font_size_header_1,		text_ranges },
+			{ "header_2",					font_path / "OpenSans-Regular.ttf",				g_font_size_header_0,		text_ranges },
 
-		m_fonts["header_0"] =		io.Fonts->AddFontFromFileTTF((font_path / "OpenSans-Regular.ttf").string().c_str(), g_font_size_header_2);
-		m_fonts["header_1"] =		io.Fonts->AddFontFromFileTTF((font_path / "OpenSans-Regular.ttf").string().c_str(), g_font_size_header_1);
-		m_fonts["header_2"] =		io.Fonts->AddFontFromFileTTF((font_path / "OpenSans-Regular.ttf").string().c_str(), g_font_size_header_0);
+			{ "giant",					font_path / "OpenSans-Bold.ttf",				60.f,						ascii_ranges },
 
-		m_fonts["giant"] =			io.Fonts->AddFontFromFileTTF((font_path / "OpenSans-Bold.ttf").string().c_str(), 60.f);
+			//Inconsolata-Regular
+			{ "monospace_regular",		Inconsolata_path / "Inconsolata-Regular.ttf",	g_font_size * 0.92f,		text_ranges },
+			{ "monospace_regular_big",	Inconsolata_path / "Inconsolata-Regular.ttf",	g_big_font_size * 1.92f,	text_ranges },
+		};
 
-		//Inconsolata-Regular
-		m_fonts["monospace_regular"] = io.Fonts->AddFontFromFileTTF((Inconsolata_path / "Inconsolata-Regular.ttf").string().c_str(), g_font_size * 0.92f);
-		m_fonts["monospace_regular_big"] = io.Fonts->AddFontFromFileTTF((Inconsolata_path / "Inconsolata-Regular.ttf").string().c_str(), g_big_font_size * 1.92f);
+		const ref<AT::io::asset_pack> assets = application::get().get_asset_pack();
+		if (assets)
+			for (auto& request : requests)
+				request.content_hash = assets->get_content_hash(request.file);
+
+		io.FontAllowUserScaling = true;
+		font_atlas_cache cache(AT::util::get_executable_path() / "cache" / "font_atlas");
+		if (!cache.load(io.Fonts, requests, m_fonts)) {
+
+			std::vector<u8> font_data;
+			for (const auto& request : requests) {
+
+				if (assets && assets->read(request.file, font_data)) {
+					void* owned_data = IM_ALLOC(font_data.size());					// the atlas takes ownership and frees it with IM_FREE
+					std::memcpy(owned_data, font_data.data(), font_data.size());
+					m_fonts[request.name] = io.Fonts->AddFontFromMemoryTTF(owned_data, static_cast<int>(font_data.size()), request.size, nullptr, request.glyph_ranges);
+				} else
+					m_fonts[request.name] = io.Fonts->AddFontFromFileTTF(request.file.string().c_str(), request.size, nullptr, request.glyph_ranges);
+			}
+
+			cache.save(io.Fonts, requests);				// builds the atlas, the renderer only uploads it
+		}
 
 		io.FontDefault = m_fonts["regular"];
 
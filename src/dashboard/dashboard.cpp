@@ -15,9 +15,15 @@
 #include "events/mouse_event.h"
 #include "events/key_event.h"
 #include "util/ui/pannel_collection.h"
+#include "util/ui/document_editor.h"
 #include "util/io/serializer_data.h"
 #include "util/io/serializer_yaml.h"
+#include "dashboard/project_file.h"
+#include "dashboard/project_journal.h"
+#include "util/audio/peaks.h"
+#include "util/audio/dsp.h"
 #include "util/system.h"
+#include "render/image_cache.h"
 #include "config/imgui_config.h"
 #include "application.h"
 
@@ -26,6 +32,8 @@
 
 namespace AT {
 
+    #define PROJECT_JOURNAL_COMPACT_SIZE    (4 * 1024 * 1024)   // journal bytes after which autosave rewrites the project file
+
 #ifdef _WIN32
     #include <Windows.h>
     #pragma comment(lib, "winmm.lib")
@@ -37,8 +45,11 @@ namespace AT {
         util::init_qt();
     #endif
 
+        m_project_writer = create_ref<project_writer>();
+
 		const std::filesystem::path icon_path = util::get_executable_path() / ASSET_DIR / "images";
-#define LOAD_ICON(name)			m_##name##_icon = create_ref<image>(icon_path / #name ".png", image_format::RGBA)
+		const ref<render::image_cache> images = application::get().get_image_cache();		// decoded in the background, the icons show up once uploaded
+#define LOAD_ICON(name)			m_##name##_icon = images->get(icon_path / #name ".png", image_format::RGBA)
 		LOAD_ICON(generate);
 		LOAD_ICON(audio);
 		LOAD_ICON(stop);
@@ -114,6 +125,9 @@ namespace AT {
 
         // save all relevant data
         serialize(serializer::option::save_to_file);
+        for (auto& proj : m_open_projects)                              // replayed on the next open, the writer finishes before it is destroyed
+            if (proj.save_id && m_project_paths.contains(proj.name))
+                journal_changes(proj, m_project_paths.at(proj.name));
         AT::UI::g_font_size = m_font_size;
         application::get().get_imgui_config_ref()->serialize(serializer::option::save_to_file);
 
@@ -126,6 +140,7 @@ namespace AT {
         if (m_worker_future.valid()) {
             m_worker_future.wait();
         }
+        m_audio_renders.clear();                                // waits for running renders, an export finishes its file
 
         // Acquire GIL if Python is initialized
         if (Py_IsInitialized())
@@ -151,7 +166,7 @@ namespace AT {
 
             project_path = m_project_paths.at(proj.name);
             LOG(Trace, "saving project [" << proj.name << "] to [" << project_path.generic_string() << "]")
-            serialize_project(proj, project_path, serializer::option::save_to_file);
+            write_project_file(snapshot_project(proj), project_path, ".crash.tmp");     // written here, the writer thread may be the one that crashed (and may be mid-write of [.tmp])
         }
         LOG(Trace, "Done saving")
     }
@@ -159,17 +174,22 @@ namespace AT {
 
     void dashboard::update(f32 delta_time)  {
 
+        PROFILE_FUNCTION();
+
         if (m_func_queue.size()) {
             for (auto& func : m_func_queue)
                 func();
             m_func_queue.clear();
         }
 
+        poll_saves();
+        poll_audio_renders();
+
         if (m_last_save_time.is_older_than(util::get_system_time(), m_save_interval_sec)) {
 
             LOG(Trace, "Auto saving")
 
-            save_open_projects();
+            autosave_open_projects();
             m_last_save_time = util::get_system_time();
         }
     }
@@ -177,6 +197,15 @@ namespace AT {
 
     void dashboard::on_event(event& event)  {
         
+        if (event.get_event_type() == window_resize_event::get_static_type())             // wrap widths change with the window, re-measure lazily
+            m_text_layouts.invalidate_all();
+
+        if (event.get_category_flag() & EC_Keyboard) {
+            auto& key_event = static_cast<AT::key_event&>(event);
+            if (key_event.get_keycode() == key_code::key_F3 && key_event.m_key_state == key_state::press)
+                m_performance_overlay.toggle();
+        }
+
         //  ignore if no proj open      is keyboard event
         if (!m_open_projects.empty() && event.get_category_flag() & EC_Keyboard) {
 
@@ -233,6 +262,13 @@ namespace AT {
                     
                 if (ImGui::BeginTabItem(proj.name.c_str(), &keep_project, tab_flags)) {                       // Create a tab for each project
 
+                    if (proj.saving.valid()) {                                                              // written by the writer thread, editing continues meanwhile
+
+                        UI::loading_indicator_circle("##saving_indicator", ImGui::GetTextLineHeight() * 0.4f, 8, 7.f);
+                        ImGui::SameLine();
+                        ImGui::TextDisabled("Saving...");
+                    }
+
                     ImGui::BeginChild("current_project", ImVec2(0, 0), true);
                     draw_project(proj);
                     ImGui::EndChild();
@@ -250,7 +286,13 @@ namespace AT {
                         auto it = std::find_if(m_open_projects.begin(), m_open_projects.end(), [&project_name](const auto& p) { return p.name == project_name; });
                         if (it == m_open_projects.end())
                             return;
+
+                        if (it->save_id && m_project_paths.contains(project_name))
+                            journal_changes(*it, m_project_paths.at(project_name));
                         
+                        for (const auto& sec : it->sections)
+                            for (const auto& field : sec.input_fields)
+                                m_text_layouts.erase(field.ID);
                         m_open_projects.erase(it);
                         if (m_current_project == project_name)                  // Update current project if we removed the active one
                             m_current_project = m_open_projects.empty() ? "" : m_open_projects[0].name;
@@ -262,6 +304,8 @@ namespace AT {
         ImGui::EndChild();
 
         ImGui::End();
+
+        m_performance_overlay.draw();
     }
 
 
@@ -425,6 +469,32 @@ namespace AT {
                 });
                 UI::end_table();
 
+                draw_title("AUDIO EFFECTS");
+                UI::begin_table("settings", false);
+                UI::table_row_slider("Playback Speed", m_effects.speed, .5f, 2.f, .05f);
+                UI::table_row_slider("Gain (dB)", m_effects.gain_db, -24.f, 24.f, .5f);
+                UI::table_row_slider("EQ Low (dB)", m_effects.eq_bands[0].gain_db, -12.f, 12.f, .5f);
+                UI::table_row_slider("EQ Mid (dB)", m_effects.eq_bands[1].gain_db, -12.f, 12.f, .5f);
+                UI::table_row_slider("EQ High (dB)", m_effects.eq_bands[2].gain_db, -12.f, 12.f, .5f);
+                UI::table_row("Trim Silence", m_effects.trim_silence);
+                if (!m_effects.trim_silence) ImGui::BeginDisabled();
+                UI::table_row_slider("Trim Threshold (dB)", m_effects.trim_threshold_db, -80.f, -20.f, 1.f);
+                if (!m_effects.trim_silence) ImGui::EndDisabled();
+                UI::table_row([]() {
+                    ImGui::Text("Output Sample Rate");
+                    UI::help_marker("Resamples playback and exported files, the model generates 24 kHz");
+                }, [&]() {
+                    const auto rate_label = [](const u32 rate) { return (rate == 0) ? "Model" : (rate == 44100) ? "44.1 kHz" : "48 kHz"; };
+                    ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
+                    if (ImGui::BeginCombo("##Output Sample Rate", rate_label(m_effects.output_sample_rate))) {
+                        for (const u32 rate : { 0u, 44100u, 48000u })
+                            if (ImGui::Selectable(rate_label(rate), m_effects.output_sample_rate == rate))
+                                m_effects.output_sample_rate = rate;
+                        ImGui::EndCombo();
+                    }
+                });
+                UI::end_table();
+
                 // UI::shift_cursor_pos(0.f, 20.f);
                 // ImGui::TextColored(ImVec4(0.8f, 0.8f, 0.8f, 1.0f), "SAVE/LOAD");
                 // ImGui::Separator();
@@ -445,10 +515,17 @@ namespace AT {
                     ImGui::BeginDisabled();
                 UI::table_row([]() { ImGui::Text("Apply new font size"); }, [this]() {
                     if (ImGui::Button("Apply"))
-                        m_func_queue.emplace_back([this]() {application::get().get_imgui_config_ref()->resize_fonts(m_font_size); });
+                        m_func_queue.emplace_back([this]() {
+                            application::get().get_imgui_config_ref()->resize_fonts(m_font_size);
+                            m_text_layouts.invalidate_all();
+                        });
                 });
                 if (m_font_size == AT::UI::g_font_size)
                     ImGui::EndDisabled();
+                bool performance_overlay = m_performance_overlay.get_open();
+                UI::table_row("Performance Overlay (F3)", performance_overlay);
+                if (performance_overlay != m_performance_overlay.get_open())
+                    m_performance_overlay.set_open(performance_overlay);
                 UI::end_table();
 
                 UI::shift_cursor_pos(0.f, 20.f);
@@ -610,6 +687,19 @@ namespace AT {
 
                     LOG(Trace, "Saving Project [" << m_current_project << "] to [" << proj_path << "]")
                 }
+
+                if (!m_open_projects.empty() && ImGui::Button("Export YAML", ImVec2(bu_width, 0))) {
+
+                    const std::filesystem::path export_dir = util::file_dialog("Select export location for [" + m_current_project + "]", {}, true);
+                    VALIDATE(!export_dir.empty(), break, "", "Failed to select a location")
+
+                    const std::filesystem::path export_path = export_dir / (m_current_project + FILE_EXTENSION_CONFIG);
+                    for (auto& proj : m_open_projects)
+                        if (m_current_project == proj.name)
+                            serialize_project_yaml(proj, export_path, serializer::option::save_to_file);
+
+                    LOG(Trace, "Exported Project [" << m_current_project << "] to [" << export_path << "]")
+                }
                 
                 // Current project info (if any project is open)
                 if (!m_open_projects.empty()) {
@@ -629,7 +719,7 @@ namespace AT {
                                     proj.name = edit_buffer;
                                     m_current_project = edit_buffer;
                                     is_editing = false;
-                                    proj.saved = false; // Mark as unsaved
+                                    proj.mark_layout_changed();         // Mark as unsaved
                                 }
                                 if (!ImGui::IsItemActive() && ImGui::IsKeyPressed(ImGuiKey_Escape)) {
                                     // Cancel editing on Escape
@@ -706,11 +796,13 @@ namespace AT {
                     if (ImGui::MenuItem("Move Up", nullptr, false, true)) 
                         m_func_queue.push_back([this, &project_data, index]() { 
                             std::swap(project_data.sections[index], project_data.sections[index - 1]); 
+                            project_data.mark_structure_changed();
                         });
                     
                     if (ImGui::MenuItem("Make First", nullptr, false, true)) 
                         m_func_queue.push_back([this, &project_data, index]() { 
                             std::swap(project_data.sections[index], project_data.sections[0]); 
+                            project_data.mark_structure_changed();
                         });
                 } else {
                     ImGui::BeginDisabled();
@@ -723,11 +815,13 @@ namespace AT {
                     if (ImGui::MenuItem("Move Down", nullptr, false, true))
                         m_func_queue.push_back([this, &project_data, index]() { 
                             std::swap(project_data.sections[index], project_data.sections[index + 1]); 
+                            project_data.mark_structure_changed();
                         });
                     
                     if (ImGui::MenuItem("Make Last", nullptr, false, true))
                         m_func_queue.push_back([this, &project_data, index]() { 
                             std::swap(project_data.sections[index], project_data.sections[project_data.sections.size() - 1]); 
+                            project_data.mark_structure_changed();
                         });
                 } else {
                     ImGui::BeginDisabled();
@@ -744,15 +838,33 @@ namespace AT {
                 ImGui::PopStyleColor();
                 ImGui::Separator();
                 
+                if (ImGui::MenuItem("Edit as Document", nullptr, sec.document != nullptr))
+                    m_func_queue.push_back([this, &project_data, index]() {
+                        section& section_data = project_data.sections[index];
+                        if (section_data.document) {
+                            apply_document(section_data);
+                            section_data.document.reset();
+                            project_data.mark_structure_changed();
+                        } else
+                            open_document(section_data);
+                    });
+
                 if (ImGui::MenuItem("Duplicate")) 
                     m_func_queue.push_back([this, &project_data, index]() {
+                        if (project_data.sections[index].document)
+                            apply_document(project_data.sections[index]);
                         auto it = project_data.sections.begin() + index;
-                        project_data.sections.insert(it + 1, *it);
+                        it = project_data.sections.insert(it + 1, *it);
+                        it->document.reset();
+                        project_data.mark_structure_changed();
                     });
                 
                 if (ImGui::MenuItem("Delete")) 
                     m_func_queue.push_back([this, &project_data, index]() { 
+                        for (const auto& field : project_data.sections[index].input_fields)
+                            m_text_layouts.erase(field.ID);
                         project_data.sections.erase(project_data.sections.begin() + index); 
+                        project_data.mark_structure_changed();
                     });
                 
                 ImGui::EndPopup();
@@ -769,13 +881,85 @@ namespace AT {
             
             project_data.sections.push_back(section{});
             project_data.sections.back().input_fields.push_back(input_field{});
-            project_data.saved = false;
+            project_data.mark_structure_changed();
         }
     }
 
     
+    // Edits get a globally unique revision, so duplicated fields (which share content and ID) can never match a stale layout
+    static u64 s_next_field_revision = 1;
+
+    static int on_input_field_edit(ImGuiInputTextCallbackData* data) {
+
+        static_cast<input_field*>(data->UserData)->revision = s_next_field_revision++;
+        return 0;
+    }
+
+
+    // Height of the text box of [field] estimated from its byte length at [glyph_width] per byte, reads none of the text.
+    // Used for rows that were not measured at the current layout yet.
+    static f32 estimate_field_height(const input_field& field, const f32 wrap_width, const f32 padding, const f32 glyph_width) {
+
+        const f32 line_count = math::max(1.f, std::ceil(static_cast<f32>(field.content.size()) * glyph_width / math::max(wrap_width, 1.f)));
+        return math::max(line_count * ImGui::GetFontSize() + padding, ImGui::GetTextLineHeight() * 1.5f);
+    }
+
+
+    // Height of the text box of [field] wrapped at [wrap_width], measured only when the layout cache entry is outdated.
+    f32 dashboard::get_field_height(const input_field& field, const f32 wrap_width, const f32 padding) {
+
+        const UI::text_layout& layout = m_text_layouts.get(field.ID, field.revision, field.content.view(), wrap_width);
+        return math::max(layout.height + padding, ImGui::GetTextLineHeight() * 1.5f);
+    }
+
+
+    void dashboard::open_document(section& section_data) {
+
+        std::string text;
+        for (const auto& field : section_data.input_fields) {
+            if (field.content.empty())
+                continue;
+            if (!text.empty())
+                text += "\n\n";
+            text += field.content.view();
+        }
+        section_data.document = create_ref<UI::document_editor>(std::move(text));
+    }
+
+
+    void dashboard::apply_document(section& section_data) {
+
+        std::unordered_multimap<std::string, input_field> previous_fields;
+        for (auto& field : section_data.input_fields)
+            previous_fields.emplace(std::string(field.content.view()), std::move(field));
+
+        section_data.input_fields.clear();
+        for (auto& paragraph : section_data.document->get_paragraphs()) {
+
+            const auto it = previous_fields.find(paragraph);
+            if (it != previous_fields.end()) {                                  // unchanged paragraph: keep the field and its generated audio
+                section_data.input_fields.push_back(std::move(it->second));
+                previous_fields.erase(it);
+            } else {
+                section_data.input_fields.push_back(input_field{});
+                section_data.input_fields.back().content = std::move(paragraph);
+                section_data.input_fields.back().dirty = true;
+                section_data.dirty_fields = true;
+            }
+        }
+        if (section_data.input_fields.empty())
+            section_data.input_fields.push_back(input_field{});
+        section_data.document_dirty = false;
+
+        for (const auto& [content, field] : previous_fields)
+            m_text_layouts.erase(field.ID);
+    }
+
+
     void dashboard::draw_section(project& project_data, section& section_data) {
-        
+
+        PROFILE_FUNCTION();
+
         // Section styling
         ImGui::PushID(&section_data);
         const auto imgui_style = ImGui::GetStyle();
@@ -786,42 +970,118 @@ namespace AT {
         const float width = ImGui::GetContentRegionAvail().x;
         const f32 padding_x = imgui_style.FramePadding.y * 2.0f;
         const ImVec2 icon_button_size = ImVec2(15 + (AT::UI::g_font_size / 10));
-        f32 button_size = (icon_button_size.x * 2) + (imgui_style.ItemSpacing.x * 4) + 20 + icon_button_size.x + 29; 
-        // Generate + Audio buttons
+        const ImVec2 waveform_size = ImVec2(icon_button_size.x * 4, icon_button_size.y + imgui_style.FramePadding.y * 2);
+        f32 button_size = (icon_button_size.x * 2) + (imgui_style.ItemSpacing.x * 5) + 20 + icon_button_size.x + 29 + waveform_size.x; 
+        // Generate + Audio buttons + waveform
 
-        constexpr size_t TITLE_SIZE = 512;
-        static char title_buffer[TITLE_SIZE];
-        strncpy(title_buffer, section_data.title.c_str(), TITLE_SIZE - 1);
-        title_buffer[TITLE_SIZE - 1] = '\0';
         ImGui::PushStyleColor(ImGuiCol_FrameBg, UI::get_default_gray_ref());
         ImGui::PushFont(application::get().get_imgui_config_ref()->get_font("header_0"));
-        if (ImGui::InputText("##input_field_title", title_buffer, TITLE_SIZE, ImGuiInputTextFlags_NoHorizontalScroll | ImGuiInputTextFlags_AllowTabInput))
-            section_data.title = title_buffer;
+        if (UI::input_text("##input_field_title", section_data.title, ImGuiInputTextFlags_NoHorizontalScroll | ImGuiInputTextFlags_AllowTabInput))
+            project_data.mark_layout_changed();
         ImGui::PopFont();
         ImGui::PopStyleColor();
 
-        for (size_t i = 0; i < section_data.input_fields.size(); i++) {                                                             // Input fields
+        if (section_data.document) {                                                                // long-text mode, the fields are rebuilt when leaving it or saving
+
+            const f32 editor_height = math::max(ImGui::GetWindowHeight() * 0.7f, ImGui::GetTextLineHeight() * 10);
+            if (section_data.document->draw("##document", ImVec2(width, editor_height)))
+                project_data.mark_document_changed(section_data);                                   // journaling splits the document first
+
+            if (ImGui::Button("Split into Fields"))
+                m_func_queue.push_back([this, &project_data, &section_data]() {
+                    apply_document(section_data);
+                    section_data.document.reset();
+                    project_data.mark_structure_changed();
+                });
+
+            ImGui::PopStyleColor();
+            ImGui::PopID();
+            return;
+        }
+
+        const auto audio_pack = get_audio_pack();
+
+        // Virtualization: only rows intersecting the clip rect are submitted and measured. Rows that were not measured at the current
+        // layout are summed with an estimate, so opening a project or resizing the window does not lay out (or page in) every text.
+        const size_t field_count = section_data.input_fields.size();
+        const f32 button_row_height = math::max(icon_button_size.y, ImGui::GetFontSize()) + imgui_style.FramePadding.y * 2;
+        const auto get_row_height = [&](const f32 field_height) { return math::max(field_height, button_row_height) + imgui_style.ItemSpacing.y; };
+        auto& row_offsets = section_data.row_offsets;
+        const row_layout_key rows_key{ width, ImGui::GetFontSize(), m_text_layouts.get_generation(), project_data.structure_revision };
+        if (row_offsets.size() != field_count + 1 || rows_key != section_data.rows_key) {
+
+            // a structure change keeps the heights (they move with their field), a layout change outdates all of them
+            const bool heights_valid = rows_key.wrap_width == section_data.rows_key.wrap_width && rows_key.font_size == section_data.rows_key.font_size
+                && rows_key.layout_generation == section_data.rows_key.layout_generation;
+            constexpr std::string_view glyph_sample = "the quick brown fox jumps over the lazy dog";                              // average advance of prose
+            const f32 glyph_width = ImGui::CalcTextSize(glyph_sample.data(), glyph_sample.data() + glyph_sample.size()).x / static_cast<f32>(glyph_sample.size());
+
+            row_offsets.resize(field_count + 1);
+            row_offsets[0] = 0.f;
+            for (size_t i = 0; i < field_count; i++) {
+
+                auto& field = section_data.input_fields[i];
+                if (!heights_valid || field.row_height <= 0.f)
+                    field.row_height = get_row_height(estimate_field_height(field, width, padding_x, glyph_width));
+                row_offsets[i + 1] = row_offsets[i] + field.row_height;
+            }
+            section_data.rows_key = rows_key;
+        }
+
+        const f32 section_top = ImGui::GetCursorScreenPos().y;
+        const ImDrawList* draw_list = ImGui::GetWindowDrawList();
+        const auto first_visible = std::upper_bound(row_offsets.begin(), row_offsets.end(), draw_list->GetClipRectMin().y - section_top);
+        const auto end_visible = std::lower_bound(row_offsets.begin(), row_offsets.end(), draw_list->GetClipRectMax().y - section_top);
+        const size_t first_row = math::min<size_t>((first_visible == row_offsets.begin()) ? 0 : (first_visible - row_offsets.begin() - 1), field_count);
+        const size_t end_row = math::max(first_row, math::min<size_t>(end_visible - row_offsets.begin(), field_count));
+
+        // Measure the visible rows and shift every offset below them by the difference to the previous (estimated) height
+        f32 shift = 0.f;
+        for (size_t i = first_row; i < end_row; i++) {
 
             auto& field = section_data.input_fields[i];
-            ImGui::PushID(&field); // Ensure unique ID if multiple fields exist
+            const f32 measured_height = get_row_height(get_field_height(field, width, padding_x));
+            shift += measured_height - field.row_height;
+            field.row_height = measured_height;
+            row_offsets[i + 1] += shift;
+        }
+        if (shift != 0.f) {
+
+            for (size_t i = end_row + 1; i <= field_count; i++)
+                row_offsets[i] += shift;
+            application::request_redraw();                                                                                          // rows may have moved into view, settle in the next frame
+        }
 
-            const ImVec2 text_size = ImGui::CalcTextSize(field.content.c_str(), nullptr, false, width);                 // Calculate required height based on wrapped text
-            const float height = math::max(text_size.y + padding_x, ImGui::GetTextLineHeight() * 1.5f);                 // Set height (text height + frame padding)
+        if (first_row > 0)                                                                                                          // space of the rows above the clip rect
+            ImGui::Dummy(ImVec2(1, row_offsets[first_row] - imgui_style.ItemSpacing.y));
 
-            constexpr size_t BUFFER_SIZE = 4096;
-            static char buffer[BUFFER_SIZE];
-            strncpy(buffer, field.content.c_str(), BUFFER_SIZE - 1);
-            buffer[BUFFER_SIZE - 1] = '\0';
+        for (size_t i = first_row; i < end_row; i++) {                                                                              // Input fields
+
+            auto& field = section_data.input_fields[i];
+            ImGui::PushID(&field); // Ensure unique ID if multiple fields exist
+
+            const float height = get_field_height(field, width, padding_x);                                             // cached wrapped text height + frame padding
 
             const bool field_generating = field.generating;
             if (field_generating)
                 ImGui::BeginDisabled();
 
-            if (ImGui::InputTextMultiline("##InputField", buffer, BUFFER_SIZE, ImVec2(width - button_size, height), ImGuiInputTextFlags_NoHorizontalScroll | ImGuiInputTextFlags_AllowTabInput)) {
-
-                field.content = buffer;
-                project_data.saved = false;
+            // Only the active field is drawn from [edit()], for every other field it would copy the text out of the mapped project
+            // (or out of the snapshot of a running save) just to display it. Inactive fields get a temporary copy of the view instead.
+            const ImVec2 input_size(width - button_size, height);
+            const ImGuiInputTextFlags input_flags = ImGuiInputTextFlags_NoHorizontalScroll | ImGuiInputTextFlags_AllowTabInput | ImGuiInputTextFlags_CallbackEdit;
+            bool edited = false;
+            if (ImGui::GetActiveID() == ImGui::GetID("##InputField"))
+                edited = UI::input_text_multiline("##InputField", field.content.edit(), input_size, input_flags, on_input_field_edit, &field);
+            else {
+
+                m_inactive_field_text.assign(field.content.view());
+                edited = UI::input_text_multiline("##InputField", m_inactive_field_text, input_size, input_flags, on_input_field_edit, &field);
+                if (edited)
+                    field.content.edit() = m_inactive_field_text;
             }
+            if (edited)
+                project_data.mark_field_changed(section_data, field);
 
             if (ImGui::IsItemVisible() && ImGui::BeginPopupContextItem()) {
                 // Reordering section
@@ -832,8 +1092,9 @@ namespace AT {
                 
                 if (i > 0) {
                     if (ImGui::MenuItem("Make First", nullptr, false, true)) 
-                        m_func_queue.push_back([this, &section_data, i]() { 
+                        m_func_queue.push_back([this, &project_data, &section_data, i]() { 
                             std::swap(section_data.input_fields[i], section_data.input_fields[0]); 
+                            project_data.mark_structure_changed();
                         });
                 } else {
                     ImGui::BeginDisabled();
@@ -843,8 +1104,9 @@ namespace AT {
                 
                 if (i < project_data.sections.size() - 1) {
                     if (ImGui::MenuItem("Make Last", nullptr, false, true))
-                        m_func_queue.push_back([this, &section_data, i]() { 
+                        m_func_queue.push_back([this, &project_data, &section_data, i]() { 
                             std::swap(section_data.input_fields[i], section_data.input_fields[section_data.input_fields.size() - 1]); 
+                            project_data.mark_structure_changed();
                         });
                 } else {
                     ImGui::BeginDisabled();
@@ -861,15 +1123,25 @@ namespace AT {
                 ImGui::Separator();
                 
                 if (ImGui::MenuItem("Duplicate")) 
-                    m_func_queue.push_back([this, &section_data, i]() {
+                    m_func_queue.push_back([this, &project_data, &section_data, i]() {
                         auto it = section_data.input_fields.begin() + i;
                         section_data.input_fields.insert(it + 1, *it);
+                        project_data.mark_structure_changed();
                     });
                 
                 if (ImGui::MenuItem("Delete")) 
-                    m_func_queue.push_back([this, &section_data, i]() { 
+                    m_func_queue.push_back([this, &project_data, &section_data, i]() { 
+                        m_text_layouts.erase(section_data.input_fields[i].ID);
                         section_data.input_fields.erase(section_data.input_fields.begin() + i); 
+                        project_data.mark_structure_changed();
                     });
+
+                if (ImGui::MenuItem("Export Audio", nullptr, false, audio_pack && audio_pack->contains(field.ID))) {
+
+                    const std::filesystem::path target_dir = util::file_dialog("Select export location", {}, true);
+                    if (!target_dir.empty())
+                        export_audio(field, target_dir / (util::to_string(field.ID) + ".wav"));
+                }
                 
                 ImGui::EndPopup();
             }
@@ -882,14 +1154,13 @@ namespace AT {
 
                 {                                                       // Add to generation queue
                     std::lock_guard<std::mutex> lock(m_queue_mutex);
-                    m_generation_queue.push(field.ID);
+                    m_generation_queue.push({ field.ID, audio_pack });
                 }
                 m_queue_condition.notify_one();
             }
             
             ImGui::SameLine();
-            const std::filesystem::path audio_path = get_audio_path() / (util::to_string(field.ID) + ".wav");
-            const bool has_audio = std::filesystem::exists(audio_path);
+            const bool has_audio = audio_pack && audio_pack->contains(field.ID);
 
             if (!has_audio)      ImGui::BeginDisabled();
             if (ImGui::ImageButton("##play_audio", (field.playing_audio) ? m_stop_icon->get() : m_audio_icon->get(), icon_button_size, ImVec2(0, 0), ImVec2(1, 1), ImVec4(0, 0, 0, 0), ImVec4(1, 1, 1, 1)))
@@ -899,6 +1170,11 @@ namespace AT {
                     play_audio(field);            // can only be pressed if audio found
             if (!has_audio)      ImGui::EndDisabled();
 
+            ImGui::SameLine();
+            const audio::clip peak_clip = has_audio ? audio_pack->get_clip(field.ID, audio::record_type::peaks) : audio::clip{};
+            const audio::peak_view peaks(peak_clip.data);
+            UI::waveform("##waveform", peaks.get_level_for_width(static_cast<u32>(waveform_size.x)), waveform_size);
+
             if (field_generating)
                 ImGui::EndDisabled();
 
@@ -908,7 +1184,7 @@ namespace AT {
                 if (ImGui::Button("^")) {
 
                     std::swap(section_data.input_fields[i], section_data.input_fields[i -1]);
-                    project_data.saved = false;
+                    project_data.mark_structure_changed();
                 }
             }
 
@@ -918,17 +1194,20 @@ namespace AT {
                 if (ImGui::Button("v")) {
 
                     std::swap(section_data.input_fields[i], section_data.input_fields[i +1]);
-                    project_data.saved = false;
+                    project_data.mark_structure_changed();
                 }
             }
             
             ImGui::PopID();
         }
+
+        if (end_row < field_count)                                                                                                  // space of the rows below the clip rect
+            ImGui::Dummy(ImVec2(1, row_offsets[field_count] - row_offsets[end_row] - imgui_style.ItemSpacing.y));
         
         if (ImGui::Button("+ Add Field")) {                                     // Add field button
             
             section_data.input_fields.push_back(input_field{});
-            project_data.saved = false;
+            project_data.mark_structure_changed();
         }
         
         
@@ -938,7 +1217,7 @@ namespace AT {
             std::lock_guard<std::mutex> lock(m_queue_mutex);
             for (size_t i = 0; i < section_data.input_fields.size(); i++) {
 
-                m_generation_queue.push(section_data.input_fields[i].ID);       // Add to generation queue
+                m_generation_queue.push({ section_data.input_fields[i].ID, audio_pack });      // Add to generation queue
                 section_data.input_fields[i].generating = true;                 // set all fields to generate
             }
             m_queue_condition.notify_one();
@@ -955,7 +1234,7 @@ namespace AT {
     void dashboard::generation_worker() {
 
         while (!m_worker_should_exit) {
-            UUID generation_task_ID;
+            generation_task task{};
             bool has_task = false;
 
             { // Get next task
@@ -967,7 +1246,7 @@ namespace AT {
                 if (m_worker_should_exit) break;
 
                 if (!m_generation_queue.empty()) {
-                    generation_task_ID = m_generation_queue.front();
+                    task = std::move(m_generation_queue.front());
                     m_generation_queue.pop();
                     has_task = true;
                 }
@@ -975,6 +1254,8 @@ namespace AT {
 
             if (!has_task) continue;
 
+            const UUID generation_task_ID = task.ID;
+
             
             LOG(Trace, "Trying to find Corresponding string for [" << generation_task_ID << "]")
 
@@ -986,7 +1267,7 @@ namespace AT {
                 for (size_t section_index = 0; section_index < m_open_projects[project_index].sections.size(); section_index++) {
                     for (size_t field_index = 0; field_index < m_open_projects[project_index].sections[section_index].input_fields.size(); field_index++) {
                         if (generation_task_ID == m_open_projects[project_index].sections[section_index].input_fields[field_index].ID) {
-                            text_to_generate = m_open_projects[project_index].sections[section_index].input_fields[field_index].content;
+                            text_to_generate = m_open_projects[project_index].sections[section_index].input_fields[field_index].content.view();
                             found = true;
                             break;
                         }
@@ -998,12 +1279,24 @@ namespace AT {
 
             VALIDATE(found, continue, "Found text corresponding to ID [" << generation_task_ID << "]", "Could not find text corresponding to ID [" << generation_task_ID << "]")
             
-            // Generate audio
-            std::filesystem::path output_path = get_audio_path() / (util::to_string(generation_task_ID) + ".wav");
-            LOG(Trace, "generating audio as [" << output_path.string() << "]")
-            std::filesystem::create_directories(output_path.parent_path());
-            bool success = call_python_generate_tts(text_to_generate, output_path.string());
-            VALIDATE(success, , "Successfully generated audio as [" << output_path.string() << "]", "Could not generate audio for [" << output_path.string() << "]")
+            const auto& audio_pack = task.audio_pack;                      // not [get_audio_pack()], the current tab may have changed since the task was queued
+            const u64 generation_hash = audio::compute_generation_hash(text_to_generate, m_voice, m_voice_speed);
+            if (audio_pack->contains(generation_task_ID, generation_hash)) {
+
+                LOG(Trace, "Audio for [" << generation_task_ID << "] is up to date, skipping generation")
+
+            } else {
+
+                // Generate audio into a temporary file, then move it into the pack (the suffix keeps the pack's directory watcher from importing it)
+                std::filesystem::path output_path = audio_pack->get_path().parent_path() / (util::to_string(generation_task_ID) + ".generating.wav");
+                LOG(Trace, "generating audio as [" << output_path.string() << "]")
+                std::filesystem::create_directories(output_path.parent_path());
+                bool success = call_python_generate_tts(text_to_generate, output_path.string());
+                VALIDATE(success, , "Successfully generated audio as [" << output_path.string() << "]", "Could not generate audio for [" << output_path.string() << "]")
+
+                if (success && audio_pack->append_file(generation_task_ID, generation_hash, output_path))
+                    std::filesystem::remove(output_path);
+            }
             
             // need new search because user could re-arange the fields while generating
             found = false;
@@ -1020,6 +1313,7 @@ namespace AT {
                 }
                 if (found) break;
             }
+            application::request_redraw();                                  // show the new waveform/play button without waiting for input
             
         }
     }
@@ -1103,23 +1397,53 @@ namespace AT {
     // --------------------------------------------------------------------------------------------------------------
 
     void dashboard::play_audio(input_field& field) {
-        const std::filesystem::path audio_path = get_audio_path() / (util::to_string(field.ID) + ".wav");
-        
-    #ifdef PLATFORM_LINUX
+
+        const auto audio_pack = get_audio_pack();
+        const audio::clip audio_clip = audio_pack->get_clip(field.ID);
+        VALIDATE(audio_clip.is_valid(), return, "", "No audio found for [" << field.ID << "]")
+
         stop_audio(); // Stop any existing playback
         m_current_audio_field = static_cast<u64>(field.ID);
         field.playing_audio = true;
 
+        if (m_effects.is_neutral()) {                                           // played straight from the pack mapping
+            start_playback(audio_clip, {});
+            return;
+        }
+
+        // decoding, stretching and resampling a long clip takes longer than a frame, [poll_audio_renders()] starts the player once it is done
+        m_audio_renders.push_back({ static_cast<u64>(field.ID), audio_clip, true, false, std::async(std::launch::async, [audio_clip, effects = m_effects]() {
+
+            auto processed_audio = create_ref<std::vector<u8>>();
+            VALIDATE(audio::render_clip(audio_clip.data, effects, *processed_audio), processed_audio.reset(), "", "Failed to apply effects, playing unprocessed audio")
+            application::request_redraw();
+            return processed_audio;
+        }) });
+    }
+
+
+    void dashboard::start_playback(const audio::clip& audio_clip, ref<std::vector<u8>> processed_audio) {
+
+        const std::span<const u8> payload = processed_audio ? std::span<const u8>(*processed_audio) : audio_clip.data;
+
+    #ifdef PLATFORM_LINUX
+        // players read the WAV from stdin, the data is written into the pipe straight from the pack mapping
         const std::vector<std::vector<std::string>> commands = {
-            {"paplay", audio_path.string()},
-            {"aplay", "-D", "default", audio_path.string()},
-            {"mpg123", audio_path.string()}
+            {"paplay"},
+            {"aplay", "-D", "default", "-"},
+            {"mpg123", "-"},
         };
 
         for (const auto& cmd : commands) {
+            int pipe_fd[2];
+            VALIDATE(pipe(pipe_fd) == 0, break, "", "Failed to create pipe for audio playback")
+
             pid_t pid = fork();
             if (pid == 0) {
-                // Child process: Redirect output and execute player
+                // Child process: Read from pipe, redirect output and execute player
+                dup2(pipe_fd[0], STDIN_FILENO);
+                close(pipe_fd[0]);
+                close(pipe_fd[1]);
                 freopen("/dev/null", "w", stdout);
                 freopen("/dev/null", "w", stderr);
                 
@@ -1133,7 +1457,9 @@ namespace AT {
                 execvp(args[0], args.data());
                 _exit(EXIT_FAILURE); // Exit if exec fails
             }
-            else if (pid > 0) {
+
+            close(pipe_fd[0]);
+            if (pid > 0) {
                 // Parent process: Check if player started successfully
                 int status;
                 usleep(10000); // Brief delay to catch quick failures
@@ -1141,8 +1467,26 @@ namespace AT {
                     m_audio_pid = pid;
                     m_audio_playing = true;
                     
-                    // Start monitor thread to detect completion
-                    m_audio_monitor = std::thread([this, pid, audio_path, id = field.ID]() {
+                    // Start monitor thread to feed the player and detect completion
+                    m_audio_monitor = std::thread([this, pid, write_fd = pipe_fd[1], audio_clip, processed_audio, payload]() {
+
+                        // a stopped player closes the pipe, get EPIPE instead of a SIGPIPE (which the crash handler would catch)
+                        sigset_t signal_set;
+                        sigemptyset(&signal_set);
+                        sigaddset(&signal_set, SIGPIPE);
+                        pthread_sigmask(SIG_BLOCK, &signal_set, nullptr);
+
+                        size_t bytes_written = 0;
+                        while (bytes_written < payload.size()) {
+                            const ssize_t result = write(write_fd, payload.data() + bytes_written, payload.size() - bytes_written);
+                            if (result < 0 && errno == EINTR)
+                                continue;
+                            if (result <= 0)
+                                break;
+                            bytes_written += static_cast<size_t>(result);
+                        }
+                        close(write_fd);
+
                         // Wait for the audio process to finish
                         int status;
                         waitpid(pid, &status, 0);
@@ -1171,6 +1515,7 @@ namespace AT {
                             }
                             
                             m_audio_playing = false;
+                            application::request_redraw();
                         }
                     });
                     m_audio_monitor.detach();
@@ -1178,14 +1523,57 @@ namespace AT {
                     return;
                 }
             }
+            close(pipe_fd[1]);
         }
-        LOG(Error, "No working audio player found for: " << audio_path.string());
+        LOG(Error, "No working audio player found for: " << m_current_audio_field);
     #else
-        PlaySound(audio_path.string().c_str(), NULL, SND_FILENAME | SND_ASYNC);
+        m_playing_clip = audio_clip;                // PlaySound() reads from memory asynchronously, keep the source alive
+        m_playing_buffer = processed_audio;
+        PlaySound(reinterpret_cast<LPCSTR>(payload.data()), NULL, SND_MEMORY | SND_ASYNC);
     #endif
     }
 
 
+    bool dashboard::export_audio(const input_field& field, const std::filesystem::path& target) {
+
+        const auto audio_pack = get_audio_pack();
+        if (m_effects.is_neutral())
+            return audio_pack->export_clip(field.ID, target);           // straight from the mapping
+
+        const audio::clip audio_clip = audio_pack->get_clip(field.ID);
+        VALIDATE(audio_clip.is_valid(), return false, "", "No audio found for [" << field.ID << "]")
+
+        // rendered and written off the UI thread, the outcome is only logged
+        m_audio_renders.push_back({ static_cast<u64>(field.ID), audio_clip, false, false, std::async(std::launch::async, [audio_clip, effects = m_effects, target, ID = field.ID]() {
+
+            std::vector<u8> processed_audio;
+            VALIDATE(audio::render_clip(audio_clip.data, effects, processed_audio), return ref<std::vector<u8>>{}, "", "Failed to apply effects to [" << ID << "]")
+
+            std::ofstream file(target, std::ios::binary | std::ios::trunc);
+            VALIDATE(file.is_open(), return ref<std::vector<u8>>{}, "", "Could not open [" << target.generic_string() << "] for export")
+            file.write(reinterpret_cast<const char*>(processed_audio.data()), processed_audio.size());
+            VALIDATE(!file.fail(), , "Exported [" << ID << "] to [" << target.generic_string() << "]", "Could not write [" << target.generic_string() << "]")
+            return ref<std::vector<u8>>{};
+        }) });
+        return true;
+    }
+
+
+    void dashboard::poll_audio_renders() {
+
+        std::erase_if(m_audio_renders, [this](audio_render& render) {
+
+            if (render.processed.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                return false;
+
+            ref<std::vector<u8>> processed_audio = render.processed.get();
+            if (render.play && !render.cancelled)
+                start_playback(render.clip, std::move(processed_audio));
+            return true;
+        });
+    }
+
+
     void dashboard::stop_audio() {
         
         if (m_current_audio_field) {                // make sure we need to reset at all
@@ -1221,6 +1609,11 @@ namespace AT {
     #else
         PlaySound(NULL, NULL, 0);                   // Stop Windows audio
     #endif
+        m_playing_clip = {};
+        m_playing_buffer.reset();
+
+        for (auto& render : m_audio_renders)        // a playback still rendering is dropped once it finished
+            render.cancelled |= render.play;
     }
 
     // --------------------------------------------------------------------------------------------------------------
@@ -1231,6 +1624,38 @@ namespace AT {
 
         std::filesystem::create_directories(path.parent_path() / "audio");        // make sure audio path exists
 
+        if (option == serializer::option::save_to_file) {
+
+            const auto registered_path = m_project_paths.find(project_data.name);
+            if (project_data.save_id && registered_path != m_project_paths.end() && registered_path->second == path)
+                journal_changes(project_data, path);                            // kept if writing the project file fails
+
+            project_data.saving = m_project_writer->compact(path, snapshot_project(project_data)).share();       // reported by [poll_saves()]
+            project_data.journal_size = 0;
+
+        } else if (is_binary_project(path)) {
+
+            VALIDATE(load_binary_project(project_data, path), return, "", "Failed to load project [" << path.generic_string() << "]")
+            project_data.journal_size = replay_journal(project_data, path);
+            m_project_writer->open(path, project_data.save_id);
+
+        } else {
+
+            LOG(Info, "Importing YAML project [" << path.generic_string() << "], it is converted to the binary format on the next save")
+            serialize_project_yaml(project_data, path, option);
+        }
+
+        project_data.saved = true;          // set to saved, doesn't matter if loading/saving
+    }
+
+
+    void dashboard::serialize_project_yaml(project& project_data, const std::filesystem::path path, const serializer::option option) {
+
+        if (option == serializer::option::save_to_file)
+            for (auto& sec : project_data.sections)
+                if (sec.document)
+                    apply_document(sec);
+
         serializer::yaml(path, "project_data", option)
             .entry(KEY_VALUE(project_data.name))
             .entry(KEY_VALUE(project_data.description))
@@ -1240,12 +1665,13 @@ namespace AT {
                 .entry(KEY_VALUE(project_data.sections[x].collapsed))
                 .vector(KEY_VALUE(project_data.sections[x].input_fields), [&](serializer::yaml& yaml, u64 y) {
 
-                    yaml.entry(KEY_VALUE(project_data.sections[x].input_fields[y].content))
+                    std::string content(project_data.sections[x].input_fields[y].content.view());         // exporting does not detach the field from the mapping
+                    yaml.entry(KEY_VALUE(content))
                     .entry(KEY_VALUE(project_data.sections[x].input_fields[y].ID));
+                    if (option == serializer::option::load_from_file)
+                        project_data.sections[x].input_fields[y].content = std::move(content);
                 });
 			});
-        
-        project_data.saved = true;          // set to saved, doesn't matter if loading/saving
     }
 
 
@@ -1256,6 +1682,14 @@ namespace AT {
             .entry(KEY_VALUE(m_auto_save))
             .entry(KEY_VALUE(m_save_interval_sec))
             .entry(KEY_VALUE(m_auto_open_last))
+            .entry(KEY_VALUE(m_effects.speed))
+            .entry(KEY_VALUE(m_effects.gain_db))
+            .entry("eq_low_gain_db", m_effects.eq_bands[0].gain_db)
+            .entry("eq_mid_gain_db", m_effects.eq_bands[1].gain_db)
+            .entry("eq_high_gain_db", m_effects.eq_bands[2].gain_db)
+            .entry(KEY_VALUE(m_effects.trim_silence))
+            .entry(KEY_VALUE(m_effects.trim_threshold_db))
+            .entry(KEY_VALUE(m_effects.output_sample_rate))
             .unordered_map(KEY_VALUE(m_project_paths));
     }
 
@@ -1267,7 +1701,7 @@ namespace AT {
         for (auto& proj : m_open_projects) {
 
             std::filesystem::path project_path{};
-            if (proj.saved || !m_project_paths.contains(proj.name))        // Save projects that need it and have a path registered
+            if ((proj.saved && !proj.journal_size) || !m_project_paths.contains(proj.name))    // Save projects that need it (or have autosaved changes in a journal) and have a path registered
                 continue;
 
             project_path = m_project_paths.at(proj.name);
@@ -1277,6 +1711,121 @@ namespace AT {
         }
 
         LOG(Trace, "saved [" << save_counter << "] projects")
+        compact_audio_packs();
+    }
+
+
+    void dashboard::autosave_open_projects() {
+
+        PROFILE_FUNCTION();
+
+        serialize(serializer::option::save_to_file);
+        for (auto& proj : m_open_projects) {
+
+            if (!m_project_paths.contains(proj.name))
+                continue;
+
+            const std::filesystem::path& project_path = m_project_paths.at(proj.name);
+            if (!proj.save_id) {                                            // no binary project file to journal against yet (new or imported from YAML)
+
+                if (!proj.saved)
+                    proj.saving = m_project_writer->compact(project_path, snapshot_project(proj)).share();
+                proj.saved = true;
+                continue;
+            }
+
+            journal_changes(proj, project_path);
+            if (proj.journal_size > PROJECT_JOURNAL_COMPACT_SIZE) {
+
+                LOG(Trace, "Journal of [" << proj.name << "] reached [" << proj.journal_size << "] bytes, compacting")
+                proj.saving = m_project_writer->compact(project_path, snapshot_project(proj)).share();
+                proj.journal_size = 0;
+            }
+            proj.saved = true;
+        }
+
+        compact_audio_packs();
+    }
+
+
+    void dashboard::journal_changes(project& project_data, const std::filesystem::path& path) {
+
+        for (auto& sec : project_data.sections)
+            if (sec.document && sec.document_dirty) {
+                apply_document(sec);
+                project_data.mark_structure_changed();
+            }
+
+        std::vector<u8> records = collect_journal_records(project_data);
+        project_data.journal_size += records.size();
+        m_project_writer->append(path, std::move(records));
+    }
+
+
+    project dashboard::snapshot_project(project& project_data) {
+
+        PROFILE_FUNCTION();
+
+        for (auto& sec : project_data.sections)
+            if (sec.document)
+                apply_document(sec);
+
+    #if defined(PLATFORM_WINDOWS)
+        detach_project(project_data);                                       // a file that is still mapped can not be replaced on Windows
+    #endif
+
+        project_data.save_id = static_cast<u64>(UUID());
+        project snapshot{};
+        snapshot.name = project_data.name;
+        snapshot.description = project_data.description;
+        snapshot.source = project_data.source;                              // keeps the viewed field contents valid until the write is done
+        snapshot.save_id = project_data.save_id;
+        snapshot.sections.reserve(project_data.sections.size());
+        for (const auto& sec : project_data.sections) {
+
+            section& copy = snapshot.sections.emplace_back();
+            copy.title = sec.title;
+            copy.collapsed = sec.collapsed;
+            copy.input_fields = sec.input_fields;                           // contents are shared, edits copy them (see [util::mapped_string])
+        }
+        return snapshot;
+    }
+
+
+    void dashboard::poll_saves() {
+
+        for (auto& proj : m_open_projects) {
+
+            if (!proj.saving.valid() || proj.saving.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                continue;
+
+            if (!proj.saving.get()) {
+
+                LOG(Error, "Saving project [" << proj.name << "] failed, the previous file and its journal are unchanged")
+                proj.saved = false;
+                proj.mark_structure_changed();                              // the next save or autosave writes everything again
+                for (auto& sec : proj.sections) {
+                    for (auto& field : sec.input_fields)
+                        field.dirty = true;
+                    sec.dirty_fields = true;
+                }
+            }
+            proj.saving = {};
+        }
+    }
+
+
+    void dashboard::compact_audio_packs() {
+
+        std::vector<ref<audio::audio_pack>> packs;
+        {
+            std::lock_guard<std::mutex> lock(m_audio_pack_mutex);
+            for (const auto& [pack_path, pack] : m_audio_packs)
+                packs.push_back(pack);
+        }
+        for (const auto& pack : packs)                                      // reclaim superseded takes, copying the pack is left to the writer thread
+            if (pack->needs_compaction())
+                m_project_writer->compact_audio_pack(pack);
     }
 
 
@@ -1291,7 +1840,8 @@ namespace AT {
         LOG(Trace, "open [" << project_name << "] from [" << project_path << "]")
         project loaded_project{};
         serialize_project(loaded_project, project_path, serializer::option::load_from_file);
-        m_open_projects.push_back(loaded_project);
+        m_open_projects.push_back(std::move(loaded_project));
+        open_audio_pack(project_path.parent_path() / "audio");             // build the availability index now instead of on the first frame
     }
 
 
@@ -1304,4 +1854,35 @@ namespace AT {
     }
 
 
+    ref<audio::audio_pack> dashboard::get_audio_pack() {
+
+        {
+            std::lock_guard<std::mutex> lock(m_audio_pack_mutex);
+            const auto project_path = m_project_paths.find(m_current_project);
+            const bool has_path = (project_path != m_project_paths.end());
+            if (m_current_audio_pack && (has_path ? project_path->second.native() == m_current_audio_pack_key : m_current_audio_pack_key.empty()))
+                return m_current_audio_pack;
+        }
+
+        const auto pack = open_audio_pack(get_audio_path());
+
+        std::lock_guard<std::mutex> lock(m_audio_pack_mutex);
+        m_current_audio_pack = pack;
+        m_current_audio_pack_key = m_project_paths.contains(m_current_project) ? m_project_paths.at(m_current_project).native() : std::filesystem::path::string_type{};
+        return pack;
+    }
+
+
+    ref<audio::audio_pack> dashboard::open_audio_pack(const std::filesystem::path& audio_dir) {
+
+        const std::filesystem::path pack_path = audio_dir / ("clips" AUDIO_PACK_EXTENTION);
+
+        std::lock_guard<std::mutex> lock(m_audio_pack_mutex);
+        auto& pack = m_audio_packs[pack_path.generic_string()];
+        if (!pack)
+            pack = create_ref<audio::audio_pack>(pack_path);
+        return pack;
+    }
+
+
 }
@@ -1,7 +1,12 @@
 #pragma once
 
 #include "util/data_structures/UUID.h"
+#include "util/data_structures/mapped_string.h"
 #include "render/image.h"
+#include "util/audio/audio_pack.h"
+#include "util/audio/dsp.h"
+#include "util/ui/text_layout_cache.h"
+#include "util/ui/performance_overlay.h"
 // #include "util/io/serializer_data.h"
 
 // Forward declarations for Python
@@ -17,18 +22,40 @@ namespace AT {
     namespace serializer {
         enum class option;
     }
+    namespace UI {
+        class document_editor;
+    }
+    class project_writer;
 
     struct input_field {
         bool                        generating = false;
         bool                        playing_audio = false;
         UUID                        ID{};
-        std::string                 content{};
+        util::mapped_string         content{};              // views the mapped project file until the field is first edited or drawn in an editor
+        u64                         revision = 0;           // changes with every edit of [content], keys the text layout cache (not serialized)
+        f32                         row_height = 0.f;       // height of the row incl. spacing as last measured or estimated, 0 until first laid out (not serialized)
+        bool                        dirty = false;          // [content] changed since the last journal write (not serialized)
+    };
+
+    // What the row offsets of a section were summed for, they are rebuilt when any of it changes (see [dashboard::draw_section()])
+    struct row_layout_key {
+        f32                         wrap_width = 0.f;
+        f32                         font_size = 0.f;
+        u32                         layout_generation = 0;  // [UI::text_layout_cache::get_generation()]
+        u64                         structure_revision = 0; // [project::structure_revision]
+
+        bool operator==(const row_layout_key&) const = default;
     };
 
     struct section {
         std::string                 title{};
         std::vector<input_field>    input_fields{};
         bool                        collapsed = false;
+        std::vector<f32>            row_offsets{};          // prefix sum of [input_field::row_height], row [i] spans [row_offsets[i], row_offsets[i + 1]) (not serialized)
+        row_layout_key              rows_key{};             // layout [row_offsets] belong to (not serialized)
+        ref<UI::document_editor>    document{};             // set while the section is edited as one document, paragraphs become [input_fields] (not serialized)
+        bool                        dirty_fields = false;   // some [input_field::dirty] is set, only these sections are scanned for the journal (not serialized)
+        bool                        document_dirty = false; // [document] was edited since it was last split into fields (not serialized)
     };
 
     struct project {
@@ -36,6 +63,28 @@ namespace AT {
         std::string                 name{};
         std::string                 description;
         std::vector<section>        sections{};
+        ref<io::mapped_file>        source{};           // project file the field contents still point into, see [load_binary_project()] (not serialized)
+        u64                         save_id = 0;        // id of the project file the journal extends, 0 until saved in the binary format
+        bool                        structure_dirty = false;    // name, titles or field order changed since the last journal write (not serialized)
+        u64                         structure_revision = 0;     // bumped when fields or sections are added, removed or reordered, sections re-sum their row offsets when it moves (not serialized)
+        u64                         journal_size = 0;   // bytes journaled since the project file was last written (not serialized)
+        std::shared_future<bool>    saving{};           // valid while the writer thread saves the project file, see [dashboard::poll_saves()] (not serialized)
+
+        FORCEINLINE void mark_layout_changed() { saved = false; structure_dirty = true; }                 // name or titles, the rows stay as they are
+        FORCEINLINE void mark_structure_changed() { mark_layout_changed(); structure_revision++; }
+
+        FORCEINLINE void mark_document_changed(section& section_data) {
+
+            saved = false;
+            section_data.document_dirty = true;
+        }
+
+        FORCEINLINE void mark_field_changed(section& section_data, input_field& field) {
+
+            saved = false;
+            field.dirty = true;
+            section_data.dirty_fields = true;
+        }
     };
 
     enum class sidebar_status {
@@ -50,6 +99,20 @@ namespace AT {
         std::string message{};
     };
 
+    // A clip rendered through the effect chain off the UI thread, see [dashboard::poll_audio_renders()]
+    struct audio_render {
+        u64                                 field_ID = 0;
+        audio::clip                         clip{};                 // source of the render, played unprocessed if rendering fails
+        bool                                play = true;            // false for exports, they write their file on the render thread
+        bool                                cancelled = false;      // playback was stopped or replaced while rendering
+        std::future<ref<std::vector<u8>>>   processed{};
+    };
+
+    struct generation_task {
+        UUID                        ID{};
+        ref<audio::audio_pack>      audio_pack{};       // pack of the project that owns the field, resolved on the UI thread when queued
+    };
+
 
     class dashboard {
     public:
@@ -71,6 +134,9 @@ namespace AT {
         // UI
         void draw_project(project& project_data);
         void draw_section(project& project_data, section& section_data);
+        f32 get_field_height(const input_field& field, const f32 wrap_width, const f32 padding);
+        void open_document(section& section_data);
+        void apply_document(section& section_data);                                // splits the document into fields, keeps the ID (and audio) of unchanged paragraphs
 	    void draw_sidebar();
 
         // Python integration
@@ -80,14 +146,25 @@ namespace AT {
         void generation_worker();
 
         // audio
-        void play_audio(input_field& field);
+        void play_audio(input_field& field);                                        // starts the player at once, or after the effect chain rendered the clip
+        void start_playback(const audio::clip& audio_clip, ref<std::vector<u8>> processed_audio);
         void stop_audio();
+        bool export_audio(const input_field& field, const std::filesystem::path& target);
+        void poll_audio_renders();                                                  // starts playback of finished renders, drops finished exports
 
-        void serialize_project(project& project_data, const std::filesystem::path path, const serializer::option option);
+        void serialize_project(project& project_data, const std::filesystem::path path, const serializer::option option);       // binary, loads YAML projects of older versions too, saving returns before the file is written
+        void serialize_project_yaml(project& project_data, const std::filesystem::path path, const serializer::option option);  // human-readable import/export
         void serialize(const serializer::option option);
         void save_open_projects();
+        void autosave_open_projects();                                              // journals the changes, compacts journals that grew too large
+        void journal_changes(project& project_data, const std::filesystem::path& path);
+        project snapshot_project(project& project_data);                           // shares the field contents, cheap enough for the UI thread
+        void compact_audio_packs();
+        void poll_saves();                                                          // reports finished background saves, marks failed ones unsaved again
         void load_project(const std::string& project_name, const std::filesystem::path& project_path);
         std::filesystem::path get_audio_path();
+        ref<audio::audio_pack> get_audio_pack();                                    // pack of the current project, cached so drawing does not build paths
+        ref<audio::audio_pack> open_audio_pack(const std::filesystem::path& audio_dir);
 
     #ifdef PLATFORM_LINUX
         pid_t                                                           m_audio_pid = 0;
@@ -95,14 +172,26 @@ namespace AT {
         std::thread                                                     m_audio_monitor;
     #endif                              
         u64                                                             m_current_audio_field = 0;
+        audio::clip                                                     m_playing_clip{};                               // keeps the mapping alive while the player reads from it
+        ref<std::vector<u8>>                                            m_playing_buffer{};                             // processed audio while the player reads from it
+        audio::effect_settings                                          m_effects{};                                    // applied at playback and export
+        std::vector<audio_render>                                       m_audio_renders{};                              // running effect renders, waited for on shutdown
+        std::unordered_map<std::string, ref<audio::audio_pack>>         m_audio_packs{};                                // key: generic path of the pack
+        std::mutex                                                      m_audio_pack_mutex;
+        ref<audio::audio_pack>                                          m_current_audio_pack{};
+        std::filesystem::path::string_type                              m_current_audio_pack_key{};                     // project path the cached pack belongs to
         std::string                                                     m_current_project{};
         std::vector<project>                                            m_open_projects{};               // projects currently opened
         std::unordered_map<std::string, std::filesystem::path>          m_project_paths{};
+        ref<project_writer>                                             m_project_writer{};                             // journal appends and project file writes, off the UI thread
 
         sidebar_status                                                  m_sidebar_status = sidebar_status::project_manager;     // start at PM because that is always the first step
         std::vector<popup>                                              m_popups{};
+        UI::text_layout_cache                                           m_text_layouts{};                               // wrapped layout of every input field, key: field ID
+        std::string                                                     m_inactive_field_text{};                        // reused buffer the inactive input fields are drawn from
+        UI::performance_overlay                                         m_performance_overlay{};                        // toggled with F3
 
-        std::queue<UUID>                                                m_generation_queue{};
+        std::queue<generation_task>                                     m_generation_queue{};
         std::mutex                                                      m_queue_mutex;
         std::future<void>                                               m_worker_future;
         std::atomic<bool>                                               m_worker_should_exit{false};
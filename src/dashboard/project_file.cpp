@@ -0,0 +1,204 @@
+#include "util/pch.h"
+
+#include "util/io/serializer_binary.h"
+#include "util/io/checksum.h"
+#include "dashboard/dashboard.h"
+
+#include "project_file.h"
+
+namespace AT {
+
+    #define PROJECT_FILE_SECTION_NAME       "project_data"
+    #define PROJECT_FILE_VERSION            1u                  // schema version stored in the [serializer::binary] header
+    #define PROJECT_SECTION_COLLAPSED       1u
+
+    struct project_file_header {
+        u64         section_count = 0;
+        u64         field_count = 0;
+        u64         text_size = 0;
+        u64         name_offset = 0;
+        u64         name_length = 0;
+        u64         description_offset = 0;
+        u64         description_length = 0;
+        u64         checksum = 0;                               // over the section and field table
+    };
+
+    struct section_record {
+        u64         title_offset = 0;
+        u64         title_length = 0;
+        u64         first_field = 0;
+        u32         field_count = 0;
+        u32         flags = 0;
+    };
+
+    struct field_record {
+        u64         ID = 0;
+        u64         text_offset = 0;
+        u64         text_length = 0;
+    };
+
+    static_assert(sizeof(project_file_header) == 64 && sizeof(section_record) == 32 && sizeof(field_record) == 24, "project file layout changed, bump PROJECT_FILE_VERSION");
+
+
+    template<typename T>
+    static FORCEINLINE std::span<const u8> as_bytes(const std::vector<T>& vector) { return { reinterpret_cast<const u8*>(vector.data()), vector.size() * sizeof(T) }; }
+
+
+    // The text is not hashed, a mapped project would otherwise fault in every page of it on open.
+    // Damaged text can only produce wrong characters, every offset into it is bounds-checked on load.
+    static u64 compute_checksum(const std::vector<section_record>& sections, const std::vector<field_record>& fields) {
+
+        const u64 hash = io::compute_checksum(as_bytes(sections));
+        return io::compute_checksum(as_bytes(fields), hash);
+    }
+
+
+    bool is_binary_project(const std::filesystem::path& path) { return serializer::binary::is_binary_file(path, PROJECT_FILE_SECTION_NAME); }
+
+
+    bool save_binary_project(const project& project_data, const std::filesystem::path& path) {
+
+        PROFILE_FUNCTION();
+
+        size_t field_count = 0;
+        size_t text_size = project_data.name.size() + project_data.description.size();
+        for (const auto& sec : project_data.sections) {
+
+            field_count += sec.input_fields.size();
+            text_size += sec.title.size();
+            for (const auto& field : sec.input_fields)
+                text_size += field.content.size();
+        }
+
+        std::vector<section_record> sections;
+        std::vector<field_record> fields;
+        std::vector<char> text;
+        sections.reserve(project_data.sections.size());
+        fields.reserve(field_count);
+        text.reserve(text_size);
+
+        const auto append_text = [&text](const std::string_view string) {
+            text.insert(text.end(), string.begin(), string.end());
+            return static_cast<u64>(text.size() - string.size());
+        };
+
+        project_file_header header{};
+        header.name_offset = append_text(project_data.name);
+        header.name_length = project_data.name.size();
+        header.description_offset = append_text(project_data.description);
+        header.description_length = project_data.description.size();
+
+        // titles go in front of all field contents, loading copies them and would otherwise touch pages all over the mapped text
+        for (const auto& sec : project_data.sections) {
+
+            VALIDATE(sec.input_fields.size() <= UINT32_MAX, return false, "", "Section [" << sec.title << "] has too many fields")
+            section_record& record = sections.emplace_back();
+            record.title_offset = append_text(sec.title);
+            record.title_length = sec.title.size();
+            record.field_count = static_cast<u32>(sec.input_fields.size());
+            record.flags = sec.collapsed ? PROJECT_SECTION_COLLAPSED : 0;
+        }
+
+        for (size_t x = 0; x < project_data.sections.size(); x++) {
+
+            sections[x].first_field = fields.size();
+            for (const auto& field : project_data.sections[x].input_fields)
+                fields.push_back({ static_cast<u64>(field.ID), append_text(field.content.view()), field.content.size() });
+        }
+
+        header.section_count = sections.size();
+        header.field_count = fields.size();
+        header.text_size = text.size();
+        header.checksum = compute_checksum(sections, fields);
+
+        u64 save_id = project_data.save_id;
+        serializer::binary archive(path, PROJECT_FILE_SECTION_NAME, serializer::option::save_to_file, PROJECT_FILE_VERSION);
+        archive.entry(header)
+            .entry(save_id)
+            .entry(sections)
+            .entry(fields)
+            .entry(text);
+        VALIDATE(archive.flush(), return false, "", "Could not write project [" << path.generic_string() << "]")
+
+        LOG(Trace, "Saved project [" << project_data.name << "] with [" << header.field_count << "] fields and [" << header.text_size << "] bytes of text")
+        return true;
+    }
+
+
+    bool load_binary_project(project& project_data, const std::filesystem::path& path) {
+
+        PROFILE_FUNCTION();
+
+        serializer::binary archive(path, PROJECT_FILE_SECTION_NAME, serializer::option::load_from_file);
+        VALIDATE(archive.is_valid(), return false, "", "[" << path.generic_string() << "] is not a binary project file")
+        const u32 version = archive.get_version();
+        VALIDATE(version == PROJECT_FILE_VERSION, return false, "", "Project file [" << path.generic_string() << "] has unsupported version [" << version << "]")
+
+        project_file_header header{};
+        u64 save_id = 0;
+        archive.entry(header)
+            .entry(save_id);
+
+        // the table sizes are checked against the rest of the file by [serializer::binary] before anything is allocated, the text stays in the mapping
+        std::vector<section_record> sections;
+        std::vector<field_record> fields;
+        size_t text_size = 0;
+        archive.entry(sections)
+            .entry(fields)
+            .entry(text_size);
+        const std::span<const u8> text_bytes = archive.view(text_size);
+        VALIDATE(archive.is_valid() && sections.size() == header.section_count && fields.size() == header.field_count && text_size == header.text_size,
+            return false, "", "Could not read project [" << path.generic_string() << "]")
+
+        const std::string_view text(reinterpret_cast<const char*>(text_bytes.data()), text_bytes.size());
+        VALIDATE(compute_checksum(sections, fields) == header.checksum, return false, "", "Project file [" << path.generic_string() << "] is damaged (checksum mismatch)")
+
+        const auto in_text = [&text](const u64 offset, const u64 length) { return offset <= text.size() && length <= text.size() - offset; };
+        bool tables_valid = in_text(header.name_offset, header.name_length) && in_text(header.description_offset, header.description_length);
+        for (const auto& record : sections)
+            tables_valid &= in_text(record.title_offset, record.title_length) && record.first_field <= fields.size() && record.field_count <= fields.size() - record.first_field;
+        for (const auto& record : fields)
+            tables_valid &= in_text(record.text_offset, record.text_length);
+        VALIDATE(tables_valid, return false, "", "Project file [" << path.generic_string() << "] has an invalid section or field table")
+
+        project loaded{};
+        loaded.save_id = save_id;
+        loaded.name = text.substr(header.name_offset, header.name_length);
+        loaded.description = text.substr(header.description_offset, header.description_length);
+        loaded.sections.resize(sections.size());
+        for (size_t x = 0; x < sections.size(); x++) {
+
+            section& sec = loaded.sections[x];
+            sec.title = text.substr(sections[x].title_offset, sections[x].title_length);
+            sec.collapsed = (sections[x].flags & PROJECT_SECTION_COLLAPSED) != 0;
+            sec.input_fields.resize(sections[x].field_count);
+            for (u32 y = 0; y < sections[x].field_count; y++) {
+
+                const field_record& record = fields[sections[x].first_field + y];
+                sec.input_fields[y].ID = UUID(record.ID);
+                sec.input_fields[y].content = util::mapped_string::from_view(text.substr(record.text_offset, record.text_length));
+            }
+        }
+        loaded.source = archive.get_file();                     // keeps the field contents valid
+
+        project_data = std::move(loaded);
+        LOG(Trace, "Loaded project [" << project_data.name << "] with [" << header.field_count << "] fields from [" << path.generic_string() << "]")
+        return true;
+    }
+
+
+    void detach_project(project& project_data) {
+
+        if (!project_data.source)
+            return;
+
+        PROFILE_FUNCTION();
+
+        for (auto& sec : project_data.sections)
+            for (auto& field : sec.input_fields)
+                field.content.detach();
+
+        project_data.source.reset();
+    }
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+
+namespace AT {
+
+    struct project;
+
+    // Binary project file, the format [PROJECT_EXTENTION] files are saved in. YAML stays available for import and export.
+    //
+    // File layout, after the [serializer::binary] file header (magic, byte order, schema version):
+    //   [project_file_header] [u64 save_id] [section table] [field table] [text]
+    //   section table:  u64 count, count * { u64 title_offset, u64 title_length, u64 first_field, u32 field_count, u32 flags }
+    //   field table:    u64 count, count * { u64 ID, u64 text_offset, u64 text_length }
+    //   text:           u64 size, every string of the project as UTF-8 back to back, addressed by offset/length
+    //   save_id:        random per save, ties the edit journal to the file it extends, see [project_journal.h]
+    //
+    // Strings are stored as they are (no escaping), so newlines and '$' survive a round trip.
+    // Every table is a single [serializer::binary] entry and the header holds a checksum over the section and field table.
+    // Loading maps the file and leaves the text in the mapping: field contents are views into it until they are edited,
+    // so opening a project only touches the tables and the pages of the text that are actually read.
+
+    // @return true if the file at [path] has the binary project header, false for YAML projects of older versions.
+    bool is_binary_project(const std::filesystem::path& path);
+
+    // Writes [project_data] in the binary format, replacing the file at [path].
+    // @return true if every table was written.
+    bool save_binary_project(const project& project_data, const std::filesystem::path& path);
+
+    // Maps a binary project file. The field contents of the loaded project view the mapping held in [project::source].
+    // @param project_data Receives the project, left untouched if the file is damaged, truncated or has an unknown version.
+    // @return true on success.
+    bool load_binary_project(project& project_data, const std::filesystem::path& path);
+
+    // Copies every field content that still views the mapped project file and releases the mapping.
+    // Required before the file the project was loaded from is overwritten.
+    void detach_project(project& project_data);
+
+}
@@ -0,0 +1,574 @@
+#include "util/pch.h"
+
+#if defined(PLATFORM_LINUX)
+    #include <unistd.h>     // fdatasync()
+#elif defined(PLATFORM_WINDOWS)
+    #include <io.h>         // _commit()
+#endif
+
+#include "util/io/mapped_file.h"
+#include "util/io/checksum.h"
+#include "dashboard/project_file.h"
+#include "dashboard/dashboard.h"
+#include "application.h"
+
+#include "project_journal.h"
+
+namespace AT {
+
+    #define JOURNAL_MAGIC                   0x524A5441u         // "ATJR" read as little-endian u32
+    #define JOURNAL_VERSION                 1u
+    #define JOURNAL_RECORD_MARKER           0x4345524Au         // "JREC"
+    #define JOURNAL_EXTENSION               ".journal"
+
+    enum class journal_record : u32 {
+        layout = 1,
+        field = 2,
+    };
+
+    struct journal_header {
+        u32         magic = JOURNAL_MAGIC;
+        u32         version = JOURNAL_VERSION;
+        u64         save_id = 0;
+    };
+
+    struct record_header {
+        u32         marker = JOURNAL_RECORD_MARKER;
+        u32         type = 0;
+        u64         size = 0;
+        u64         checksum = 0;
+    };
+
+    static_assert(sizeof(journal_header) == 16 && sizeof(record_header) == 24, "journal layout changed, bump JOURNAL_VERSION");
+
+
+    static std::filesystem::path get_journal_path(const std::filesystem::path& path) {
+
+        std::filesystem::path journal_path = path;
+        journal_path += JOURNAL_EXTENSION;
+        return journal_path;
+    }
+
+
+    // flushes the C buffer and waits for the data (not the metadata) to reach the disk
+    static bool sync_file(std::FILE* file) {
+
+        if (std::fflush(file) != 0)
+            return false;
+
+    #if defined(PLATFORM_LINUX)
+        return fdatasync(fileno(file)) == 0;
+    #elif defined(PLATFORM_WINDOWS)
+        return _commit(_fileno(file)) == 0;
+    #else
+        return true;
+    #endif
+    }
+
+    // --------------------------------------------------------------------------------------------------------------
+    // records
+    // --------------------------------------------------------------------------------------------------------------
+
+    template<typename T>
+    static FORCEINLINE void put(std::vector<u8>& buffer, const T& value) {
+
+        static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable types are written as bytes");
+        const u8* bytes = reinterpret_cast<const u8*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    static void put_string(std::vector<u8>& buffer, const std::string_view string) {
+
+        put<u64>(buffer, string.size());
+        buffer.insert(buffer.end(), string.begin(), string.end());
+    }
+
+    // @return Offset of the record header, pass it to [end_record()] once the payload is written.
+    static size_t begin_record(std::vector<u8>& buffer, const journal_record type) {
+
+        const size_t offset = buffer.size();
+        record_header header{};
+        header.type = static_cast<u32>(type);
+        put(buffer, header);
+        return offset;
+    }
+
+    static void end_record(std::vector<u8>& buffer, const size_t offset) {
+
+        record_header header{};
+        std::memcpy(&header, buffer.data() + offset, sizeof(header));
+        const std::span<const u8> payload(buffer.data() + offset + sizeof(header), buffer.size() - offset - sizeof(header));
+        header.size = payload.size();
+        header.checksum = io::compute_checksum(payload);
+        std::memcpy(buffer.data() + offset, &header, sizeof(header));
+    }
+
+
+    // Bounds-checked reads from a record payload, every read after the first failure returns an empty value.
+    struct payload_reader {
+
+        std::span<const u8>     data{};
+        size_t                  position = 0;
+        bool                    valid = true;
+
+        template<typename T>
+        T get() {
+
+            T value{};
+            if (!valid || data.size() - position < sizeof(T)) {
+                valid = false;
+                return value;
+            }
+            std::memcpy(&value, data.data() + position, sizeof(T));
+            position += sizeof(T);
+            return value;
+        }
+
+        std::string_view get_string() {
+
+            const u64 length = get<u64>();
+            if (!valid || length > data.size() - position) {
+                valid = false;
+                return {};
+            }
+            const std::string_view result(reinterpret_cast<const char*>(data.data() + position), length);
+            position += length;
+            return result;
+        }
+
+        // @return true if [count] elements of at least [element_size] bytes can still follow, guards allocations against damaged counts
+        bool can_hold(const u64 count, const u64 element_size) {
+
+            valid &= count <= (data.size() - position) / element_size;
+            return valid;
+        }
+    };
+
+
+    // Calls [apply] for every intact record of [data] after its header.
+    // @return Offset behind the last intact record, 0 if [data] has no valid header.
+    template<typename F>
+    static size_t for_each_record(const std::span<const u8> data, journal_header& header, F&& apply) {
+
+        if (data.size() < sizeof(journal_header))
+            return 0;
+
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (header.magic != JOURNAL_MAGIC || header.version != JOURNAL_VERSION)
+            return 0;
+
+        size_t position = sizeof(journal_header);
+        while (data.size() - position >= sizeof(record_header)) {
+
+            record_header record{};
+            std::memcpy(&record, data.data() + position, sizeof(record));
+            if (record.marker != JOURNAL_RECORD_MARKER || record.size > data.size() - position - sizeof(record))
+                break;                                                  // torn by a crash while appending
+
+            const std::span<const u8> payload = data.subspan(position + sizeof(record), record.size);
+            if (io::compute_checksum(payload) != record.checksum)
+                break;
+
+            apply(static_cast<journal_record>(record.type), payload);
+            position += sizeof(record) + record.size;
+        }
+        return position;
+    }
+
+
+    static void encode_layout(std::vector<u8>& buffer, const project& project_data) {
+
+        const size_t record = begin_record(buffer, journal_record::layout);
+        put_string(buffer, project_data.name);
+        put_string(buffer, project_data.description);
+        put<u64>(buffer, project_data.sections.size());
+        for (const auto& sec : project_data.sections) {
+
+            put_string(buffer, sec.title);
+            put<u8>(buffer, sec.collapsed ? 1 : 0);
+            put<u64>(buffer, sec.input_fields.size());
+            for (const auto& field : sec.input_fields)
+                put<u64>(buffer, field.ID);
+        }
+        end_record(buffer, record);
+    }
+
+
+    // Rebuilds the sections from a layout record. Fields are matched by ID, an ID listed more often than it exists
+    // (duplicated fields) copies the content of the first field with that ID, unknown IDs start empty.
+    static bool apply_layout(project& project_data, const std::span<const u8> payload) {
+
+        std::vector<input_field> previous;
+        for (auto& sec : project_data.sections)
+            for (auto& field : sec.input_fields)
+                previous.push_back(field);
+
+        std::unordered_multimap<u64, size_t> unused;
+        std::unordered_map<u64, size_t> first;
+        for (size_t x = 0; x < previous.size(); x++) {
+            unused.emplace(previous[x].ID, x);
+            first.emplace(previous[x].ID, x);
+        }
+
+        payload_reader reader{ payload };
+        const std::string_view name = reader.get_string();
+        const std::string_view description = reader.get_string();
+        const u64 section_count = reader.get<u64>();
+        if (!reader.can_hold(section_count, sizeof(u64) * 2 + sizeof(u8)))
+            return false;
+
+        std::vector<section> sections(section_count);
+        for (auto& sec : sections) {
+
+            sec.title = reader.get_string();
+            sec.collapsed = reader.get<u8>() != 0;
+            const u64 field_count = reader.get<u64>();
+            if (!reader.can_hold(field_count, sizeof(u64)))
+                return false;
+
+            sec.input_fields.resize(field_count);
+            for (auto& field : sec.input_fields) {
+
+                const u64 ID = reader.get<u64>();
+                if (const auto it = unused.find(ID); it != unused.end()) {
+                    field = previous[it->second];
+                    unused.erase(it);
+                } else if (const auto duplicate = first.find(ID); duplicate != first.end())
+                    field = previous[duplicate->second];
+                else
+                    field.ID = UUID(ID);
+            }
+        }
+        if (!reader.valid)
+            return false;
+
+        project_data.name = name;
+        project_data.description = description;
+        project_data.sections = std::move(sections);
+        return true;
+    }
+
+
+    static bool apply_field(project& project_data, const std::span<const u8> payload) {
+
+        payload_reader reader{ payload };
+        const u32 section_index = reader.get<u32>();
+        const u32 field_index = reader.get<u32>();
+        const u64 ID = reader.get<u64>();
+        const std::string_view text = reader.get_string();
+        if (!reader.valid || section_index >= project_data.sections.size() || field_index >= project_data.sections[section_index].input_fields.size())
+            return false;
+
+        input_field& field = project_data.sections[section_index].input_fields[field_index];
+        if (static_cast<u64>(field.ID) != ID)
+            return false;
+
+        field.content = std::string(text);
+        return true;
+    }
+
+
+    std::vector<u8> collect_journal_records(project& project_data) {
+
+        PROFILE_FUNCTION();
+
+        std::vector<u8> buffer;
+        if (project_data.structure_dirty) {
+
+            encode_layout(buffer, project_data);
+            project_data.structure_dirty = false;
+        }
+
+        for (size_t x = 0; x < project_data.sections.size(); x++) {
+
+            section& sec = project_data.sections[x];
+            if (!sec.dirty_fields)
+                continue;
+
+            for (size_t y = 0; y < sec.input_fields.size(); y++) {
+
+                input_field& field = sec.input_fields[y];
+                if (!field.dirty)
+                    continue;
+
+                const size_t record = begin_record(buffer, journal_record::field);
+                put<u32>(buffer, static_cast<u32>(x));
+                put<u32>(buffer, static_cast<u32>(y));
+                put<u64>(buffer, field.ID);
+                put_string(buffer, field.content.view());
+                end_record(buffer, record);
+                field.dirty = false;
+            }
+            sec.dirty_fields = false;
+        }
+        return buffer;
+    }
+
+
+    u64 replay_journal(project& project_data, const std::filesystem::path& path) {
+
+        PROFILE_FUNCTION();
+
+        const std::filesystem::path journal_path = get_journal_path(path);
+        std::error_code error;
+        if (!std::filesystem::exists(journal_path, error))
+            return 0;
+
+        const io::mapped_file file(journal_path);
+        VALIDATE(file.is_valid(), return 0, "", "Could not open journal [" << journal_path.generic_string() << "]")
+
+        journal_header header{};
+        if (file.size() >= sizeof(header))
+            std::memcpy(&header, file.data(), sizeof(header));
+        if (header.magic != JOURNAL_MAGIC || header.save_id != project_data.save_id || project_data.save_id == 0) {
+
+            LOG(Info, "Ignoring journal [" << journal_path.generic_string() << "], it does not extend the loaded project file")
+            return 0;
+        }
+
+        u32 applied = 0;
+        u32 skipped = 0;
+        const size_t end = for_each_record(file.get_span(), header, [&](const journal_record type, const std::span<const u8> payload) {
+
+            const bool success = (type == journal_record::layout) ? apply_layout(project_data, payload)
+                : (type == journal_record::field) ? apply_field(project_data, payload) : false;
+            if (success)
+                applied++;
+            else
+                skipped++;
+        });
+        if (end == 0)
+            return 0;
+
+        if (skipped)
+            LOG(Warn, "Skipped [" << skipped << "] journal records that did not fit project [" << project_data.name << "]")
+        if (end < file.size())
+            LOG(Warn, "Journal [" << journal_path.generic_string() << "] ends in a damaged record, [" << file.size() - end << "] bytes are dropped")
+
+        LOG(Info, "Restored [" << applied << "] autosaved changes of project [" << project_data.name << "] from its journal")
+        return end;
+    }
+
+
+    bool write_project_file(const project& project_data, const std::filesystem::path& path, const char* temp_extension) {
+
+        PROFILE_FUNCTION();
+
+        std::filesystem::path temp_path = path;
+        temp_path += temp_extension;
+        if (!save_binary_project(project_data, temp_path))
+            return false;
+
+        std::FILE* file = std::fopen(temp_path.string().c_str(), "rb+");
+        const bool synced = file && sync_file(file);
+        if (file)
+            std::fclose(file);
+        if (!synced)
+            LOG(Warn, "Could not flush [" << temp_path.generic_string() << "] to disk before replacing the project file")
+
+        std::error_code error;
+        std::filesystem::rename(temp_path, path, error);                // atomic on POSIX, the old file stays readable through existing mappings
+        if (error) {
+
+            LOG(Error, "Could not replace project file [" << path.generic_string() << "]: " << error.message())
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+        return true;
+    }
+
+    // --------------------------------------------------------------------------------------------------------------
+    // project_writer
+    // --------------------------------------------------------------------------------------------------------------
+
+    project_writer::project_writer() {
+
+        m_thread = std::thread(&project_writer::write_loop, this);
+    }
+
+
+    project_writer::~project_writer() {
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_condition.notify_all();
+        if (m_thread.joinable())
+            m_thread.join();
+
+        for (auto& [path, target] : m_journals)
+            if (target.file)
+                std::fclose(target.file);
+        m_journals.clear();
+    }
+
+
+    void project_writer::open(const std::filesystem::path& path, const u64 save_id) {
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            job& opened = m_jobs.emplace_back();
+            opened.path = path;
+            opened.save_id = save_id;
+            opened.open = true;
+        }
+        m_condition.notify_one();
+    }
+
+
+    void project_writer::append(const std::filesystem::path& path, std::vector<u8> records) {
+
+        if (records.empty())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            job& appended = m_jobs.emplace_back();
+            appended.path = path;
+            appended.records = std::move(records);
+        }
+        m_condition.notify_one();
+    }
+
+
+    std::future<bool> project_writer::compact(const std::filesystem::path& path, project&& snapshot) {
+
+        std::future<bool> result;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            job& compaction = m_jobs.emplace_back();
+            compaction.path = path;
+            compaction.snapshot = create_ref<project>(std::move(snapshot));
+            result = compaction.done.get_future();
+        }
+        m_condition.notify_one();
+        return result;
+    }
+
+
+    void project_writer::compact_audio_pack(ref<audio::audio_pack> pack) {
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.emplace_back().audio_pack = std::move(pack);
+        }
+        m_condition.notify_one();
+    }
+
+
+    void project_writer::write_loop() {
+
+        while (true) {
+
+            job current;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+                if (m_jobs.empty())                                     // stopping, every queued job ran
+                    return;
+
+                current = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+
+            current.done.set_value(run(current));
+            if (current.snapshot)                                       // the UI shows the saving state until it sees the result
+                application::request_redraw();
+        }
+    }
+
+
+    bool project_writer::run(job& current) {
+
+        if (current.audio_pack)                                         // queued by every save until it ran, only the first one has work left
+            return !current.audio_pack->needs_compaction() || current.audio_pack->compact();
+
+        journal& target = m_journals[current.path.generic_string()];
+        const auto close_journal = [&target]() {
+            if (target.file)
+                std::fclose(target.file);
+            target.file = nullptr;
+        };
+
+        if (current.open) {
+
+            if (target.save_id != current.save_id)
+                close_journal();
+            target.save_id = current.save_id;
+            return true;
+        }
+
+        if (current.snapshot) {
+
+            if (!write_project_file(*current.snapshot, current.path))
+                return false;
+
+            close_journal();                                            // folded into the project file
+            std::error_code error;
+            std::filesystem::remove(get_journal_path(current.path), error);
+            target.save_id = current.snapshot->save_id;
+            LOG(Trace, "Compacted project [" << current.snapshot->name << "] into [" << current.path.generic_string() << "]")
+            return true;
+        }
+
+        if (target.save_id == 0) {
+
+            LOG(Warn, "Project [" << current.path.generic_string() << "] has no binary project file to journal against, dropping [" << current.records.size() << "] bytes")
+            return false;
+        }
+
+        if (!target.file && !open_journal(current.path, target))
+            return false;
+
+        const bool written = std::fwrite(current.records.data(), 1, current.records.size(), target.file) == current.records.size() && sync_file(target.file);
+        if (!written) {
+
+            LOG(Error, "Could not append to the journal of [" << current.path.generic_string() << "]")
+            close_journal();                                            // reopening truncates the partial record
+            return false;
+        }
+        return true;
+    }
+
+
+    bool project_writer::open_journal(const std::filesystem::path& path, journal& target) {
+
+        const std::filesystem::path journal_path = get_journal_path(path);
+        std::error_code error;
+        size_t end = 0;
+        if (std::filesystem::exists(journal_path, error)) {
+
+            const io::mapped_file file(journal_path);
+            journal_header header{};
+            if (file.is_valid())
+                end = for_each_record(file.get_span(), header, [](const journal_record, const std::span<const u8>) {});
+            if (header.save_id != target.save_id)
+                end = 0;
+        }
+
+        if (end > 0) {                                                  // continue the journal of this session or a crashed one, without its torn tail
+
+            std::filesystem::resize_file(journal_path, end, error);
+            target.file = error ? nullptr : std::fopen(journal_path.string().c_str(), "ab");
+        }
+
+        if (!target.file) {
+
+            target.file = std::fopen(journal_path.string().c_str(), "wb");
+            VALIDATE(target.file, return false, "", "Could not create journal [" << journal_path.generic_string() << "]")
+
+            journal_header header{};
+            header.save_id = target.save_id;
+            if (std::fwrite(&header, sizeof(header), 1, target.file) != 1) {
+
+                LOG(Error, "Could not write the header of journal [" << journal_path.generic_string() << "]")
+                std::fclose(target.file);
+                target.file = nullptr;
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+
+namespace AT::audio { class audio_pack; }
+
+namespace AT {
+
+    struct project;
+
+    // Edit journal, the autosave format. Instead of rewriting the project file, autosave appends the changes since the last
+    // autosave to [<project file>.journal] and the journal is folded into the project file (compaction) once it grows too large.
+    //
+    // File layout:
+    //   header:  u32 magic, u32 version, u64 save_id of the project file the journal extends
+    //   records: u32 marker, u32 type, u64 payload size, u64 payload checksum, payload
+    //     layout:  name, description, u64 section count, per section { title, u8 collapsed, u64 field count, field count * u64 ID }
+    //     field:   u32 section, u32 field, u64 ID, text
+    //   strings are a u64 length followed by the UTF-8 bytes
+    //
+    // A layout record is only written when the structure changed, fields keep their content by ID across it. Field records
+    // address the field by position in the layout at the time they were written and carry its whole text, so replaying
+    // them in order restores the last autosave. A record torn by a crash fails its checksum and ends the replay.
+
+    // Encodes every change of [project_data] since the last call and clears its dirty flags.
+    // Sections edited as a document have to be split into fields before, their text is not journaled.
+    // @return The records to append, empty if nothing changed.
+    std::vector<u8> collect_journal_records(project& project_data);
+
+    // Applies the journal next to [path] if it extends the loaded project file (same save id), otherwise leaves the project as is.
+    // @return The number of journal bytes applied, 0 if there is no matching journal.
+    u64 replay_journal(project& project_data, const std::filesystem::path& path);
+
+    // Writes [project_data] to [path] + [temp_extension], flushes it to disk and renames it over [path]. A crash during the write
+    // leaves the previous file intact. Blocking, used by [project_writer] and the crash handler.
+    // @param temp_extension Callers that can run concurrently need their own, the crash handler may interrupt a write of the writer thread.
+    // @return true if [path] now holds the project.
+    bool write_project_file(const project& project_data, const std::filesystem::path& path, const char* temp_extension = ".tmp");
+
+    // Owns the thread every project file and journal is written and every audio pack compacted on, jobs run in the order they are queued.
+    // The UI thread only encodes records and snapshots (see [dashboard::snapshot_project()]), the disk is never touched in a frame.
+    class project_writer {
+    public:
+
+        DELETE_COPY_MOVE_CONSTRUCTOR(project_writer);
+
+        project_writer();
+
+        // Runs every queued job, then stops the thread.
+        ~project_writer();
+
+        // Declares that the project file at [path] has [save_id], journal records for it extend that file from now on.
+        void open(const std::filesystem::path& path, const u64 save_id);
+
+        // Appends [records] (from [collect_journal_records()]) to the journal of [path], followed by a single fsync.
+        // Dropped with a warning if [path] has no project file yet.
+        void append(const std::filesystem::path& path, std::vector<u8> records);
+
+        // Writes [snapshot] with [write_project_file()] and removes the journal it supersedes.
+        // If the write fails the journal keeps extending the previous file.
+        // @return Resolves to true once [path] holds the snapshot, a redraw is requested when it resolves.
+        std::future<bool> compact(const std::filesystem::path& path, project&& snapshot);
+
+        // Compacts [pack] (see [audio::audio_pack::compact()]) if it still needs it when the job runs.
+        void compact_audio_pack(ref<audio::audio_pack> pack);
+
+    private:
+
+        struct job {
+            std::filesystem::path           path{};
+            std::vector<u8>                 records{};
+            ref<project>                    snapshot{};                     // set for compaction
+            ref<audio::audio_pack>          audio_pack{};                   // set for [compact_audio_pack()]
+            u64                             save_id = 0;                    // set for [open()]
+            bool                            open = false;
+            std::promise<bool>              done{};
+        };
+
+        struct journal {
+            u64                             save_id = 0;                    // project file the journal extends
+            std::FILE*                      file = nullptr;                 // opened on the first append
+        };
+
+        void write_loop();
+        bool run(job& current);
+        bool open_journal(const std::filesystem::path& path, journal& target);
+
+        std::unordered_map<std::string, journal>    m_journals{};           // by generic project path, writer thread only
+
+        std::thread                                 m_thread{};
+        std::mutex                                  m_mutex{};              // guards everything below
+        std::condition_variable                     m_condition{};
+        std::deque<job>                             m_jobs{};
+        bool                                        m_stop = false;
+    };
+
+}
@@ -2,6 +2,7 @@
 #include "util/pch.h"
 #include "util/timing/instrumentor.h"
 #include "util/crash_handler.h"
+#include "util/audio/kernels.h"
 #include "application.h"
 
 #if defined(PLATFORM_LINUX)
@@ -31,7 +32,15 @@
             AT::crash_handler::subscribe(AT::logger::shutdown);
         }
 
-        {   // put application in scope to guarantee termination at specific point
+        bool benchmark_only = false;                // [--benchmark-audio-kernels] prints the kernel timings and exits before any window is created
+        for (int x = 1; x < ARGC; x++)
+            if (std::strcmp(ARGV[x], "--benchmark-audio-kernels") == 0)
+                benchmark_only = true;
+
+        if (benchmark_only)
+            AT::audio::run_kernel_benchmarks();
+
+        else {   // put application in scope to guarantee termination at specific point
             AT::application app = AT::application(ARGC, ARGV);
             app.run();
         }
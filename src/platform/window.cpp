@@ -25,6 +25,7 @@
 #include "events/mouse_event.h"
 #include "events/key_event.h"
 #include "util/io/serializer_yaml.h"
+#include "util/io/asset_pack.h"
 
 #include "window.h"
 
@@ -35,11 +36,16 @@ namespace AT {
 		
 	static FORCEINLINE void GLFW_error_callback(int errorCode, const char* description) { LOG(Error, "[GLFW Error: " << errorCode << "]: " << description); }
 	
-    static GLFWimage load_icon(const std::string& filepath) {
+    static GLFWimage load_icon(const std::filesystem::path& filepath) {
 
 		GLFWimage icon = {};
         int channels;
-        icon.pixels = stbi_load(filepath.c_str(), &icon.width, &icon.height, &channels, 4);			// Load image data
+        std::vector<u8> data;
+        const ref<io::asset_pack> assets = application::get().get_asset_pack();
+        if (assets && assets->read(filepath, data))													// prefer the mapped asset pack over a file read
+            icon.pixels = stbi_load_from_memory(data.data(), static_cast<int>(data.size()), &icon.width, &icon.height, &channels, 4);
+        else
+            icon.pixels = stbi_load(filepath.string().c_str(), &icon.width, &icon.height, &channels, 4);			// Load image data
         if (!icon.pixels)
             LOG(Error, "Failed to load window icon: " << filepath);
         
@@ -110,9 +116,10 @@ namespace AT {
 		if (!logo_path.empty()) {
 
         	const auto icon_full_path = util::get_executable_path() / logo_path;
-			if (std::filesystem::exists(icon_full_path)) {
+			const ref<io::asset_pack> assets = application::get().get_asset_pack();
+			if ((assets && assets->contains(icon_full_path)) || std::filesystem::exists(icon_full_path)) {
 
-				GLFWimage icon = load_icon(icon_full_path.string());
+				GLFWimage icon = load_icon(icon_full_path);
 				if (icon.pixels) {
 					glfwSetWindowIcon(m_Window, 1, &icon);
 					stbi_image_free(icon.pixels);
@@ -258,8 +265,17 @@ namespace AT {
 	void window::poll_events() {
 	
 		glfwPollEvents();
-	
-		// prosesss custom queue
+		process_event_queue();
+	}
+
+	void window::wait_events(const f64 timeout) {
+
+		glfwWaitEventsTimeout(timeout);
+		process_event_queue();
+	}
+
+	void window::process_event_queue() {
+
 		std::scoped_lock<std::mutex> lock(m_event_queue_mutex);
 		while (m_event_queue.size() > 0) {
 	
@@ -269,6 +285,15 @@ namespace AT {
 		}
 	}
 	
+	void window::set_vsync(const bool vsync) {
+
+		m_data.vsync = vsync;
+	#if defined(RENDER_API_OPENGL)
+		if (glfwGetCurrentContext() == m_Window)
+			glfwSwapInterval(vsync ? 1 : 0);
+	#endif
+	}
+
 	void window::capture_cursor() { glfwSetInputMode(m_Window, GLFW_CURSOR, GLFW_CURSOR_DISABLED); }
 	
 	void window::release_cursor() { glfwSetInputMode(m_Window, GLFW_CURSOR, GLFW_CURSOR_NORMAL); }
@@ -67,9 +67,10 @@ namespace AT {
 		// Delete copy constructor to avoid accidental window duplication.
 		DELETE_COPY_CONSTRUCTOR(window);
 
-		// Enables or disables VSync.
+		// Enables or disables VSync. The swap interval is applied immediately if the window's GL context is current on this thread.
 		// @param vsync True to enable VSync, false to disable.
-		GETTER_SETTER_C(bool, vsync, m_data.vsync)
+		GETTER_C(bool, vsync, m_data.vsync)
+		void set_vsync(const bool vsync);
 
 		// Returns the current width of the window.
 		// @return Window width in pixels.
@@ -160,6 +161,11 @@ namespace AT {
 		// @return None.
 		void poll_events();
 
+		// Blocks until a window/input event arrives, [application::request_redraw()] posts an empty event or [timeout] expires,
+		// then processes events like [poll_events()].
+		// @param timeout Maximum wait in seconds.
+		void wait_events(const f64 timeout);
+
 		// Captures the mouse cursor, locking it to the window.
 		// @return None.
 		void capture_cursor();
@@ -180,6 +186,9 @@ namespace AT {
 		// This function sets up handling for resize, focus, close, mouse, and key events.
 		// @return None.
 		void bind_event_callbacks();
+
+		// Executes all functions queued with [queue_event()].
+		void process_event_queue();
 	
 		std::mutex 							m_event_queue_mutex;	// Mutex protecting the event queue.
 		std::queue<std::function<void()>> 	m_event_queue;         	// Custom event execution queue.
@@ -39,18 +39,17 @@ namespace AT {
 
             FORCEINLINE u32 get_array_size() { return (u32)GENERAL_PERFORMANCE_METRIK_ARRAY_SIZE; }
 
-            f32 renderer_draw_time[GENERAL_PERFORMANCE_METRIK_ARRAY_SIZE] = {};
+            f32 renderer_draw_time[GENERAL_PERFORMANCE_METRIK_ARRAY_SIZE] = {};        // work time of the frame in ms (application::limit_fps)
             f32 draw_geometry_time[GENERAL_PERFORMANCE_METRIK_ARRAY_SIZE] = {};
-            f32 waiting_idle_time[GENERAL_PERFORMANCE_METRIK_ARRAY_SIZE] = {};
-            u16 current_index = 0;
+            f32 waiting_idle_time[GENERAL_PERFORMANCE_METRIK_ARRAY_SIZE] = {};         // sleep + idle wait of the frame in ms
+            u16 current_index = 0;                                                      // next slot to write, also the oldest sample
 
+            // Advances the ring buffers once per frame. [draw_calls] and [vertices] keep describing the last submitted frame,
+            // the renderer overwrites them after every ImGui::Render()
             void next_iteration() {
 
                 current_index = (current_index + 1) % GENERAL_PERFORMANCE_METRIK_ARRAY_SIZE;
-                // renderer_draw_time[current_index] = draw_geometry_time[current_index] = waiting_idle_time[current_index] = 0.f;
-                material_binding_count = pipline_binding_count = draw_calls = 0;
-                vertices = 0;
-                sleep_time = work_time = 0.f;
+                material_binding_count = pipline_binding_count = 0;
             }
         };
     };
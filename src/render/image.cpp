@@ -107,6 +107,15 @@ namespace AT {
 
     u32 image::get_height() const { return m_image_extent.height; }
 
+    image::image(image_format format, bool mipmapped)
+        : m_mipmapped(mipmapped), m_format(format) {}
+
+    void image::upload(const void* data, u32 width, u32 height) {
+
+        release();
+        allocate_memory(const_cast<void*>(data), extent_3D{width, height, 1}, m_format, m_mipmapped);
+    }
+
     ImTextureID image::get() {
 #if defined(RENDER_API_VULKAN)
 		if (m_descriptor_set == nullptr)
@@ -114,6 +123,9 @@ namespace AT {
         return reinterpret_cast<void*>(m_descriptor_set);
 
 #elif defined(RENDER_API_OPENGL)
+        if (!m_is_initialized)
+            return s_placeholder;
+
         return reinterpret_cast<void*>(static_cast<uintptr_t>(m_textureID));
 #endif
     }
@@ -320,4 +332,17 @@ namespace AT {
         return buffer;
     }
 
+    void* image::decode_file(const std::filesystem::path& image_path, u32& outWidth, u32& outHeight) {
+
+        int width, height, channels;
+        stbi_uc* buffer = stbi_load(image_path.string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
+        if (buffer) {
+            outWidth = static_cast<u32>(width);
+            outHeight = static_cast<u32>(height);
+        }
+        return buffer;
+    }
+
+    void image::free_decoded(void* data)                            { stbi_image_free(data); }
+
 }
@@ -26,13 +26,17 @@ namespace AT {
         image(void* data, extent_3D size, image_format format, bool mipmapped = false);
         image(void* data, u32 width, u32 height, image_format format, bool mipmapped = false);
         image(std::filesystem::path image_path, image_format format, bool mipmapped = false);
+        explicit image(image_format format, bool mipmapped = false);   // empty image, draws the placeholder until [upload()] is called
         ~image();
 
         u32 get_width() const;
         u32 get_height() const;
         void release();
+        void upload(const void* data, u32 width, u32 height);       // (re)creates the texture, [data] may be an offset into a bound pixel unpack buffer
+        FORCEINLINE bool is_ready() const                           { return m_is_initialized; }
 
-        ImTextureID get();                                          // Unified texture access for ImGui
+        ImTextureID get();                                          // Unified texture access for ImGui, returns the placeholder while not ready
+        FORCEINLINE static void set_placeholder(ImTextureID texture) { s_placeholder = texture; }
 
 #if defined(RENDER_API_VULKAN)
 
@@ -53,12 +57,16 @@ namespace AT {
 
         // --------- Common utilities ---------
         static void* decode(const void* data, u64 length, u32& outWidth, u32& outHeight);
+        static void* decode_file(const std::filesystem::path& image_path, u32& outWidth, u32& outHeight);     // RGBA8, thread-safe
+        static void free_decoded(void* data);
 
     private:
     
         extent_3D                                   m_image_extent{};
         bool                                        m_is_initialized = false;
         bool                                        m_mipmapped = false;
+        image_format                                m_format = image_format::None;
+        inline static ImTextureID                   s_placeholder{};
 
 #if defined(RENDER_API_VULKAN)
     
@@ -78,7 +86,6 @@ namespace AT {
         
         GLuint                                      m_textureID = 0;
         GLuint64                                    m_bindless_handle = 0;
-        image_format                                m_format = image_format::None;
 #endif
     };
 }
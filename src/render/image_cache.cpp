@@ -0,0 +1,165 @@
+#include "util/pch.h"
+
+#if defined(RENDER_API_OPENGL)
+	#include <GL/glew.h>
+#endif
+
+#include "util/io/asset_pack.h"
+#include "application.h"
+
+#include "image_cache.h"
+
+namespace AT::render {
+
+	image_cache::image_cache(ref<io::asset_pack> assets)
+		: m_assets(assets) {
+
+		const u32 transparent_pixel = 0;
+		m_placeholder = create_ref<image>((void*)&transparent_pixel, 1, 1, image_format::RGBA);
+		image::set_placeholder(m_placeholder->get());
+
+		m_thread = std::thread(&image_cache::decode_loop, this);
+	}
+
+
+	image_cache::~image_cache() {
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_condition.notify_all();
+		if (m_thread.joinable())
+			m_thread.join();
+
+		for (auto& decoded : m_decoded)
+			image::free_decoded(decoded.pixels);
+		m_decoded.clear();
+
+	#if defined(RENDER_API_OPENGL)
+		if (m_pixel_buffer)
+			glDeleteBuffers(1, &m_pixel_buffer);
+	#endif
+
+		m_images.clear();
+		image::set_placeholder({});
+		m_placeholder.reset();
+	}
+
+
+	ref<image> image_cache::get(const std::filesystem::path& path, const image_format format, const bool mipmapped) {
+
+		const std::string key = path.lexically_normal().generic_string();
+		if (const auto it = m_images.find(key); it != m_images.end())
+			return it->second;
+
+		ref<image> result = create_ref<image>(format, mipmapped);
+		m_images.emplace(key, result);
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_jobs.push_back({ path, result });
+		}
+		m_condition.notify_one();
+		return result;
+	}
+
+
+	void image_cache::upload_pending(const u64 byte_budget) {
+
+		PROFILE_FUNCTION();
+
+		std::vector<decoded_image> ready;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_decoded.empty())
+				return;
+
+			u64 bytes = 0;
+			size_t count = 0;
+			while (count < m_decoded.size() && (count == 0 || bytes + static_cast<u64>(m_decoded[count].width) * m_decoded[count].height * 4 <= byte_budget)) {
+				bytes += static_cast<u64>(m_decoded[count].width) * m_decoded[count].height * 4;
+				count++;
+			}
+			ready.assign(m_decoded.begin(), m_decoded.begin() + count);
+			m_decoded.erase(m_decoded.begin(), m_decoded.begin() + count);
+			if (!m_decoded.empty())
+				application::request_animation_frame();			// the rest goes up next frame
+		}
+
+		for (const auto& decoded : ready) {
+
+			if (ref<image> target = decoded.target.lock())			// skip images nobody holds anymore
+				upload(*target, decoded);
+			image::free_decoded(decoded.pixels);
+		}
+	}
+
+
+	void image_cache::upload(image& target, const decoded_image& decoded) {
+
+	#if defined(RENDER_API_OPENGL)
+		// stage the pixels in a pixel unpack buffer, glTexImage2D then copies on the GPU side instead of blocking on client memory
+		const GLsizeiptr size = static_cast<GLsizeiptr>(decoded.width) * decoded.height * 4;
+		if (!m_pixel_buffer)
+			glGenBuffers(1, &m_pixel_buffer);
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pixel_buffer);
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);		// orphan the storage of the previous upload
+		void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		if (mapped) {
+
+			std::memcpy(mapped, decoded.pixels, static_cast<size_t>(size));
+			if (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE) {
+				target.upload(nullptr, decoded.width, decoded.height);			// [nullptr] = offset 0 into the bound buffer
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+				return;
+			}
+		}
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		LOG(Warn, "Mapping the pixel unpack buffer failed, uploading from client memory")
+	#endif
+
+		target.upload(decoded.pixels, decoded.width, decoded.height);
+	}
+
+
+	void image_cache::decode_loop() {
+
+		while (true) {
+
+			decode_job job;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_condition.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+				if (m_stop)
+					return;
+
+				job = std::move(m_jobs.front());
+				m_jobs.pop_front();
+			}
+
+			if (job.target.expired())
+				continue;
+
+			decoded_image decoded{ job.target };
+			if (m_assets && m_assets->contains(job.path)) {
+
+				std::vector<u8> buffer;
+				std::span<const u8> data = m_assets->view(job.path);			// PNGs are stored uncompressed, decoded in place
+				if (data.empty() && m_assets->read(job.path, buffer))
+					data = buffer;
+				if (!data.empty())
+					decoded.pixels = image::decode(data.data(), data.size(), decoded.width, decoded.height);
+			} else
+				decoded.pixels = image::decode_file(job.path, decoded.width, decoded.height);
+			VALIDATE(decoded.pixels, continue, "", "Could not load image from path [" << job.path.generic_string() << "]")
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_decoded.push_back(std::move(decoded));
+			}
+			application::request_redraw();
+		}
+	}
+
+}
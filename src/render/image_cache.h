@@ -0,0 +1,71 @@
+#pragma once
+
+#include "render/image.h"
+
+namespace AT::io { class asset_pack; }
+
+
+namespace AT::render {
+
+	// Shared, asynchronously loaded images keyed by file path.
+	// [get()] returns immediately with a handle that draws a transparent placeholder. A worker thread decodes the file
+	// and [upload_pending()] creates the texture on the render thread, through a pixel unpack buffer on OpenGL.
+	// Requesting the same path again returns the same [image], so every texture is decoded and uploaded once.
+	// Files contained in the asset pack are decoded straight from its mapping, others are read from disk.
+	class image_cache {
+	public:
+
+		DELETE_COPY_MOVE_CONSTRUCTOR(image_cache);
+
+		// Creates the placeholder texture and starts the decode thread. Needs the render context to be current.
+		// @param assets Checked before the file system, may be nullptr.
+		image_cache(ref<io::asset_pack> assets = nullptr);
+
+		// Stops the decode thread and drops all cached images. Needs the render context to be current.
+		~image_cache();
+
+		// Returns the shared image for [path], queuing the decode on first request.
+		// @param path The image file (any format stb_image supports).
+		// @param format The texture format, only used on the first request of [path].
+		// @param mipmapped Generate mipmaps, only used on the first request of [path].
+		// @return The image, not ready (see [image::is_ready()]) until its upload happened.
+		ref<image> get(const std::filesystem::path& path, const image_format format = image_format::RGBA, const bool mipmapped = false);
+
+		// Uploads decoded images to the GPU. Call once per frame on the render thread, before drawing.
+		// @param byte_budget Pixel data uploaded per call, the rest waits for the next frame. At least one image is uploaded.
+		void upload_pending(const u64 byte_budget = 8 * 1024 * 1024);
+
+	private:
+
+		struct decode_job {
+			std::filesystem::path			path{};
+			std::weak_ptr<image>			target{};
+		};
+
+		struct decoded_image {
+			std::weak_ptr<image>			target{};
+			void*							pixels = nullptr;		// RGBA8, freed with [image::free_decoded()]
+			u32								width = 0;
+			u32								height = 0;
+		};
+
+		void decode_loop();
+		void upload(image& target, const decoded_image& decoded);
+
+		std::unordered_map<std::string, ref<image>>		m_images{};				// by normalized path, render thread only
+		ref<io::asset_pack>								m_assets{};
+		ref<image>										m_placeholder{};
+
+		std::thread										m_thread{};
+		std::mutex										m_mutex{};				// guards everything below
+		std::condition_variable							m_condition{};
+		std::deque<decode_job>							m_jobs{};
+		std::vector<decoded_image>						m_decoded{};
+		bool											m_stop = false;
+
+	#if defined(RENDER_API_OPENGL)
+		GLuint											m_pixel_buffer = 0;		// reused GL_PIXEL_UNPACK_BUFFER, orphaned on every upload
+	#endif
+	};
+
+}
@@ -79,11 +79,27 @@ namespace AT::render::open_GL {
             ImGui_ImplGlfw_NewFrame();
             ImGui::NewFrame();
 
-            application::get().get_dashboard()->draw(delta_time);
+            {
+                PROFILE_SCOPE("dashboard::draw");
+                application::get().get_dashboard()->draw(delta_time);
+            }
             
             ImGui::EndFrame();
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            {
+                PROFILE_SCOPE("ImGui::Render");
+                ImGui::Render();
+            }
+
+            ImDrawData* draw_data = ImGui::GetDrawData();
+            m_general_performance_metrik.vertices = static_cast<u64>(draw_data->TotalVtxCount);
+            m_general_performance_metrik.draw_calls = 0;
+            for (int x = 0; x < draw_data->CmdListsCount; x++)
+                m_general_performance_metrik.draw_calls += static_cast<u32>(draw_data->CmdLists[x]->CmdBuffer.Size);
+
+            {
+                PROFILE_SCOPE("ImGui_ImplOpenGL3_RenderDrawData");
+                ImGui_ImplOpenGL3_RenderDrawData(draw_data);
+            }
             
             // update other platform windows
             GLFWwindow* backup_current_context = glfwGetCurrentContext();
@@ -0,0 +1,469 @@
+#include "util/pch.h"
+
+#include "util/io/io.h"
+#include "util/io/directory_watcher.h"
+#include "util/data_structures/string_manipulation.h"
+#include "util/audio/wav.h"
+#include "util/audio/peaks.h"
+
+#include "audio_pack.h"
+
+namespace AT::audio {
+
+	#define PACK_MAGIC							0x4B504154		// "ATPK"
+	#define PACK_VERSION						1
+	#define PACK_RECORD_MAGIC					0x50494C43		// "CLIP"
+	#define PACK_MIN_DEAD_BYTES_FOR_COMPACTION	(8 * 1024 * 1024)
+
+	struct pack_header {
+		u32			magic = PACK_MAGIC;
+		u32			version = PACK_VERSION;
+	};
+
+	struct record_header {
+		u32			magic = PACK_RECORD_MAGIC;
+		u32			type = 0;						// [record_type]
+		u64			ID = 0;
+		u64			generation_hash = 0;
+		u64			length = 0;						// payload bytes following this header
+	};
+
+	static_assert(sizeof(pack_header) == 8 && sizeof(record_header) == 32, "pack layout changed, bump PACK_VERSION");
+
+	#define INDEX(type)							m_index[static_cast<size_t>(type)]
+
+
+	static std::vector<u8> build_peaks_for(const std::span<const u8> audio_data) {
+
+		wav_info info{};
+		if (!parse_wav(audio_data, info))
+			return {};
+
+		return build_peak_pyramid(info);
+	}
+
+
+	// FNV-1a 64 over little-endian bytes, the same on every platform and standard library (like the asset pack hashes)
+	static u64 hash_bytes(const std::span<const u8> data, u64 hash) {
+
+		for (const u8 byte : data)
+			hash = (hash ^ byte) * 0x100000001b3;
+		return hash;
+	}
+
+
+	static u64 hash_integer(const u64 value, u64 hash) {
+
+		u8 bytes[sizeof(u64)];
+		for (u32 x = 0; x < sizeof(u64); x++)
+			bytes[x] = static_cast<u8>(value >> (8 * x));
+		return hash_bytes(bytes, hash);
+	}
+
+
+	u64 compute_generation_hash(const std::string& text, const std::string& voice, const f32 speed) {
+
+		u32 speed_bits = 0;
+		std::memcpy(&speed_bits, &speed, sizeof(speed_bits));
+
+		u64 hash = 0xcbf29ce484222325;
+		hash = hash_integer(text.size(), hash);							// lengths keep ("ab", "c") and ("a", "bc") apart
+		hash = hash_bytes({ reinterpret_cast<const u8*>(text.data()), text.size() }, hash);
+		hash = hash_integer(voice.size(), hash);
+		hash = hash_bytes({ reinterpret_cast<const u8*>(voice.data()), voice.size() }, hash);
+		return hash_integer(speed_bits, hash);
+	}
+
+
+	audio_pack::audio_pack(const std::filesystem::path& path)
+		: m_path(path) {
+
+		io::create_directory(m_path.parent_path());
+		if (!std::filesystem::exists(m_path) || std::filesystem::file_size(m_path) < sizeof(pack_header)) {
+
+			std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+			VALIDATE(file.is_open(), return, "", "Could not create audio pack [" << m_path.generic_string() << "]")
+
+			const pack_header header{};
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		}
+
+		std::unique_lock lock(m_mutex);
+		VALIDATE(remap() && build_index(), return, "", "Could not open audio pack [" << m_path.generic_string() << "]")
+		LOG(Trace, "Opened audio pack [" << m_path.generic_string() << "] with [" << INDEX(record_type::audio).size() << "] clips")
+		lock.unlock();
+
+		// both decode every clip they touch, the pack is usable meanwhile and the results appear like any other append
+		m_initial_import = std::async(std::launch::async, [this]() {
+			import_loose_files();
+			generate_missing_peaks();
+		});
+
+		// clips dropped into the directory while the project is open become available without reopening it
+		m_directory_watcher = std::make_unique<io::directory_watcher>(m_path.parent_path(), [this](const std::filesystem::path& file, const io::file_change change) {
+			if (change == io::file_change::written && import_loose_file(file))
+				LOG(Trace, "Imported [" << file.generic_string() << "] into [" << m_path.generic_string() << "]")
+		});
+	}
+
+
+	audio_pack::~audio_pack() {
+
+		if (m_initial_import.valid())
+			m_initial_import.wait();
+		m_directory_watcher.reset();										// stop callbacks before the index goes away
+		std::unique_lock lock(m_mutex);
+		m_mapping.reset();
+		for (auto& index : m_index)
+			index.clear();
+	}
+
+
+	bool audio_pack::append(const UUID ID, const u64 generation_hash, const std::span<const u8> data) {
+
+		VALIDATE(!data.empty(), return false, "", "Refusing to append an empty clip for [" << ID << "]")
+
+		const std::vector<u8> peaks = build_peaks_for(data);				// computed before locking, readers are not blocked by the decode
+		VALIDATE(!peaks.empty(), , "", "Could not build peaks for [" << ID << "], storing audio without waveform")
+
+		std::unique_lock lock(m_mutex);
+		if (peaks.empty())
+			return write_records(ID, generation_hash, { {record_type::audio, data} });
+
+		return write_records(ID, generation_hash, { {record_type::audio, data}, {record_type::peaks, std::span<const u8>(peaks)} });
+	}
+
+
+	bool audio_pack::append_file(const UUID ID, const u64 generation_hash, const std::filesystem::path& path) {
+
+		const io::mapped_file source(path);
+		VALIDATE(source.is_valid() && source.size() > 0, return false, "", "Could not read [" << path.generic_string() << "] for appending")
+		return append(ID, generation_hash, source.get_span());
+	}
+
+
+	bool audio_pack::contains(const UUID ID) const {
+
+		std::shared_lock lock(m_mutex);
+		return INDEX(record_type::audio).contains(ID);
+	}
+
+
+	bool audio_pack::contains(const UUID ID, const u64 generation_hash) const {
+
+		std::shared_lock lock(m_mutex);
+		const auto it = INDEX(record_type::audio).find(ID);
+		return it != INDEX(record_type::audio).end() && it->second.generation_hash == generation_hash;
+	}
+
+
+	clip audio_pack::get_clip(const UUID ID, const record_type type) const {
+
+		std::shared_lock lock(m_mutex);
+		const auto it = INDEX(type).find(ID);
+		if (it == INDEX(type).end() || !m_mapping)
+			return {};
+
+		if (type != record_type::audio) {										// derived data of an older take is stale
+
+			const auto audio_it = INDEX(record_type::audio).find(ID);
+			if (audio_it == INDEX(record_type::audio).end() || !is_current(audio_it->second, it->second))
+				return {};
+		}
+
+		return clip{ m_mapping, m_mapping->slice(it->second.offset, it->second.length), it->second.generation_hash };
+	}
+
+
+	bool audio_pack::export_clip(const UUID ID, const std::filesystem::path& target) const {
+
+		const clip audio_clip = get_clip(ID);
+		VALIDATE(audio_clip.is_valid(), return false, "", "No audio for [" << ID << "] in [" << m_path.generic_string() << "]")
+
+		io::create_directory(target.parent_path());
+		std::ofstream file(target, std::ios::binary | std::ios::trunc);
+		VALIDATE(file.is_open(), return false, "", "Could not open [" << target.generic_string() << "] for export")
+
+		file.write(reinterpret_cast<const char*>(audio_clip.data.data()), audio_clip.data.size());
+		return !file.fail();
+	}
+
+
+	bool audio_pack::needs_compaction() const {
+
+		std::shared_lock lock(m_mutex);
+		return m_dead_bytes >= PACK_MIN_DEAD_BYTES_FOR_COMPACTION && m_dead_bytes > m_live_bytes;
+	}
+
+
+	bool audio_pack::compact() {
+
+		PROFILE_FUNCTION();
+
+		// collect the current takes, the new file is written from this snapshot without holding the lock
+		ref<io::mapped_file> source{};
+		std::vector<std::pair<record_header, u64>> records;				// header of the new record, payload offset in [source]
+		{
+			std::shared_lock lock(m_mutex);
+			VALIDATE(m_mapping && m_mapping->is_valid(), return false, "", "Audio pack [" << m_path.generic_string() << "] is not mapped")
+
+			const auto make_record = [](const record_type type, const UUID ID, const entry& record_entry) {
+				record_header header{};
+				header.type = static_cast<u32>(type);
+				header.ID = static_cast<u64>(ID);
+				header.generation_hash = record_entry.generation_hash;
+				header.length = record_entry.length;
+				return std::pair<record_header, u64>{ header, record_entry.offset };
+			};
+
+			source = m_mapping;
+			records.reserve(INDEX(record_type::audio).size() * 2);
+			for (const auto& [ID, audio_entry] : INDEX(record_type::audio)) {		// every take is written as audio followed by its peaks
+
+				records.push_back(make_record(record_type::audio, ID, audio_entry));
+				const auto peaks_it = INDEX(record_type::peaks).find(ID);
+				if (peaks_it != INDEX(record_type::peaks).end() && is_current(audio_entry, peaks_it->second))		// stale peaks are dropped and rebuilt on the next open
+					records.push_back(make_record(record_type::peaks, ID, peaks_it->second));
+			}
+		}
+
+		std::filesystem::path temp_path = m_path;
+		temp_path += ".tmp";
+		std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+		VALIDATE(file.is_open(), return false, "", "Could not create [" << temp_path.generic_string() << "] for compaction")
+
+		const pack_header pack{};
+		file.write(reinterpret_cast<const char*>(&pack), sizeof(pack));
+		for (const auto& [header, offset] : records) {
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(source->data() + offset), header.length);
+		}
+
+		std::unique_lock lock(m_mutex);
+		if (m_mapping && m_mapping->size() > source->size()) {				// takes appended in the meantime follow as they are, they supersede everything before them
+
+			const auto appended = m_mapping->slice(source->size(), m_mapping->size() - source->size());
+			file.write(reinterpret_cast<const char*>(appended.data()), appended.size());
+		}
+
+		file.close();
+		std::error_code error;
+		if (file.fail()) {
+
+			LOG(Error, "Failed to write compacted pack [" << temp_path.generic_string() << "]")
+			std::filesystem::remove(temp_path, error);
+			return false;
+		}
+
+		source.reset();
+		m_mapping.reset();													// outstanding clips hold their own reference to the old mapping
+		if (!replace_file(temp_path)) {
+
+			std::filesystem::remove(temp_path, error);
+			remap();														// keep serving the unchanged pack
+			return false;
+		}
+
+		const u64 reclaimed = m_dead_bytes;
+		const bool success = remap() && build_index();
+		LOG(Trace, "Compacted audio pack [" << m_path.generic_string() << "], reclaimed [" << reclaimed << "] bytes")
+		return success;
+	}
+
+	// ------------------------------------------------------------------------------------------------------------------
+	// PRIVATE
+	// ------------------------------------------------------------------------------------------------------------------
+
+	// peaks belong to the current take if they were written after its audio by the same generation
+	bool audio_pack::is_current(const entry& audio_entry, const entry& derived_entry) {
+
+		return derived_entry.offset > audio_entry.offset && derived_entry.generation_hash == audio_entry.generation_hash;
+	}
+
+
+	// expects [m_mutex] to be locked exclusively and [m_mapping] to be released
+	bool audio_pack::replace_file(const std::filesystem::path& source) {
+
+		std::error_code error;
+	#if defined(PLATFORM_WINDOWS)
+		// a file that is still mapped (by outstanding clips) can be renamed but not replaced, move it aside first
+		std::filesystem::path old_path = m_path;
+		old_path += ".old";
+		std::filesystem::remove(old_path, error);
+		std::filesystem::rename(m_path, old_path, error);
+		VALIDATE(!error, return false, "", "Failed to move [" << m_path.generic_string() << "] aside: " << error.message())
+
+		std::filesystem::rename(source, m_path, error);
+		if (error) {
+
+			LOG(Error, "Failed to replace [" << m_path.generic_string() << "]: " << error.message())
+			std::filesystem::rename(old_path, m_path, error);
+			return false;
+		}
+
+		std::filesystem::remove(old_path, error);							// fails while clips still map it, removed by the next compaction
+		return true;
+	#else
+		std::filesystem::rename(source, m_path, error);
+		VALIDATE(!error, return false, "", "Failed to replace [" << m_path.generic_string() << "]: " << error.message())
+		return true;
+	#endif
+	}
+
+
+	// expects [m_mutex] to be locked exclusively
+	bool audio_pack::write_records(const UUID ID, const u64 generation_hash, const std::initializer_list<std::pair<record_type, std::span<const u8>>> records) {
+
+		std::ofstream file(m_path, std::ios::binary | std::ios::app);
+		VALIDATE(file.is_open(), return false, "", "Could not open audio pack [" << m_path.generic_string() << "] for appending")
+
+		u64 record_offset = static_cast<u64>(m_mapping ? m_mapping->size() : sizeof(pack_header));
+		for (const auto& [type, data] : records) {
+
+			record_header header{};
+			header.type = static_cast<u32>(type);
+			header.ID = static_cast<u64>(ID);
+			header.generation_hash = generation_hash;
+			header.length = data.size();
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(data.data()), data.size());
+			VALIDATE(!file.fail(), return false, "", "Failed to append record [" << header.type << "] of [" << ID << "] to [" << m_path.generic_string() << "]")
+
+			auto& index = INDEX(type);
+			if (const auto it = index.find(ID); it != index.end()) {
+
+				m_dead_bytes += it->second.length;
+				m_live_bytes -= it->second.length;
+			}
+			index[ID] = entry{ record_offset + sizeof(record_header), header.length, generation_hash };
+			m_live_bytes += header.length;
+			record_offset += sizeof(record_header) + header.length;
+		}
+
+		file.close();
+		return remap();
+	}
+
+	// expects [m_mutex] to be locked exclusively
+	bool audio_pack::remap() {
+
+		auto mapping = create_ref<io::mapped_file>(m_path);
+		VALIDATE(mapping->is_valid(), return false, "", "Failed to map audio pack [" << m_path.generic_string() << "]")
+		m_mapping = mapping;					// outstanding clips keep the previous mapping alive
+		return true;
+	}
+
+	// expects [m_mutex] to be locked exclusively
+	bool audio_pack::build_index() {
+
+		for (auto& index : m_index)
+			index.clear();
+		m_live_bytes = 0;
+		m_dead_bytes = 0;
+
+		const auto header_bytes = m_mapping->slice(0, sizeof(pack_header));
+		VALIDATE(!header_bytes.empty(), return false, "", "Audio pack [" << m_path.generic_string() << "] is too small")
+
+		pack_header header{};
+		std::memcpy(&header, header_bytes.data(), sizeof(header));
+		VALIDATE(header.magic == PACK_MAGIC && header.version == PACK_VERSION, return false, "", "Audio pack [" << m_path.generic_string() << "] has an unknown format")
+
+		u64 offset = sizeof(pack_header);
+		while (offset < m_mapping->size()) {
+
+			const auto record_bytes = m_mapping->slice(offset, sizeof(record_header));
+			if (record_bytes.empty())
+				break;
+
+			record_header record{};
+			std::memcpy(&record, record_bytes.data(), sizeof(record));
+			if (record.magic != PACK_RECORD_MAGIC || m_mapping->slice(offset + sizeof(record_header), record.length).size() != record.length)
+				break;
+
+			if (record.type < static_cast<u32>(record_type::count)) {			// skip records written by newer versions
+
+				auto& index = m_index[record.type];
+				if (const auto it = index.find(UUID(record.ID)); it != index.end()) {
+
+					m_dead_bytes += it->second.length;
+					m_live_bytes -= it->second.length;
+				}
+				index[UUID(record.ID)] = entry{ offset + sizeof(record_header), record.length, record.generation_hash };
+				m_live_bytes += record.length;
+			}
+			offset += sizeof(record_header) + record.length;
+		}
+
+		if (offset < m_mapping->size()) {							// an append was interrupted (crash, full disk), drop the incomplete tail
+
+			LOG(Warn, "Audio pack [" << m_path.generic_string() << "] has a damaged tail at [" << offset << "], truncating")
+			m_mapping.reset();
+			std::error_code error;
+			std::filesystem::resize_file(m_path, offset, error);
+			VALIDATE(!error, , "", "Failed to truncate [" << m_path.generic_string() << "]: " << error.message())
+			return remap();
+		}
+
+		return true;
+	}
+
+
+	bool audio_pack::import_loose_file(const std::filesystem::path& file) {
+
+		if (file.extension() != ".wav")
+			return false;
+
+		const std::string stem = file.stem().string();
+		if (stem.empty() || !std::all_of(stem.begin(), stem.end(), [](unsigned char c) { return std::isdigit(c); }))
+			return false;
+
+		UUID ID(0);
+		util::convert_from_string(stem, ID);
+		if (!append_file(ID, 0, file))
+			return false;
+
+		std::filesystem::remove(file);
+		return true;
+	}
+
+
+	void audio_pack::import_loose_files() {
+
+		u32 import_counter = 0;
+		for (const auto& file : io::get_files_in_dir(m_path.parent_path()))
+			if (import_loose_file(file))
+				import_counter++;
+
+		if (import_counter)
+			LOG(Info, "Imported [" << import_counter << "] loose audio files into [" << m_path.generic_string() << "]")
+	}
+
+
+	void audio_pack::generate_missing_peaks() {
+
+		std::vector<std::pair<UUID, clip>> missing;
+		{
+			std::shared_lock lock(m_mutex);
+			for (const auto& [ID, audio_entry] : INDEX(record_type::audio)) {
+
+				const auto it = INDEX(record_type::peaks).find(ID);
+				if (it == INDEX(record_type::peaks).end() || !is_current(audio_entry, it->second))
+					missing.emplace_back(ID, clip{ m_mapping, m_mapping->slice(audio_entry.offset, audio_entry.length), audio_entry.generation_hash });
+			}
+		}
+
+		for (const auto& [ID, audio_clip] : missing) {
+
+			const std::vector<u8> peaks = build_peaks_for(audio_clip.data);
+			if (peaks.empty())
+				continue;
+
+			std::unique_lock lock(m_mutex);
+			write_records(ID, audio_clip.generation_hash, { {record_type::peaks, std::span<const u8>(peaks)} });
+		}
+
+		if (!missing.empty())
+			LOG(Trace, "Generated peaks for [" << missing.size() << "] clips in [" << m_path.generic_string() << "]")
+	}
+
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "util/data_structures/UUID.h"
+#include "util/io/mapped_file.h"
+
+namespace AT::io { class directory_watcher; }
+
+namespace AT::audio {
+
+	// Kind of data stored in a pack record, every take consists of one record of each type
+	enum class record_type : u32 {
+		audio = 0,					// the encoded audio file (WAV)
+		peaks,						// serialized peak pyramid of the audio, see [build_peak_pyramid()]
+		count,
+	};
+
+	// Read-only view of a single clip inside an [audio_pack].
+	// Holds a reference to the mapping it points into, so the data stays valid even if the pack appends, remaps or compacts in the meantime.
+	struct clip {
+		ref<io::mapped_file>		source{};						// keeps the mapping alive for the lifetime of this view
+		std::span<const u8>			data{};							// record payload inside the mapping (WAV file or peak pyramid)
+		u64							generation_hash = 0;			// hash of the settings that produced this take
+
+		FORCEINLINE bool is_valid() const { return source && !data.empty(); }
+	};
+
+
+	// Computes the hash that identifies one take of a field. Fields whose hash did not change since the last generation can reuse the stored clip.
+	// @param text The text that is spoken.
+	// @param voice The name of the voice model.
+	// @param speed The voice speed.
+	// @return A hash over all inputs of the generation (FNV-1a 64). It is stored in the pack, so it does not depend on the platform or standard library.
+	u64 compute_generation_hash(const std::string& text, const std::string& voice, const f32 speed);
+
+
+	// Append-only archive holding all generated clips of one project in a single file.
+	//
+	// File layout:
+	//   [pack_header] [record_header][payload] [record_header][payload] ...
+	//
+	// Every generation appends an audio record followed by its peak record, a later record for the same UUID and type supersedes all earlier ones.
+	// The in-memory index (UUID -> offset/length/generation-hash) is rebuilt by a single scan over the record headers when the pack is opened.
+	// Superseded records stay in the file until [compact()] rewrites it.
+	// All accessors are thread-safe, the generation worker appends while the UI thread reads.
+	class audio_pack {
+	public:
+
+		DELETE_COPY_MOVE_CONSTRUCTOR(audio_pack);
+
+		// Opens (or creates) the pack at [path] and builds the index.
+		// Loose [<UUID>.wav] files next to the pack (written by older versions or external tools) are imported and removed and missing
+		// peaks are generated on a background task, the stored clips are available right away. The directory stays watched so files
+		// that appear later are imported as soon as they are written.
+		// @param path The path to the pack file.
+		audio_pack(const std::filesystem::path& path);
+
+		~audio_pack();
+
+		// Appends a new take for [ID], superseding any previous take. The peak pyramid is computed here and stored beside the audio.
+		// @param ID The UUID of the input_field the audio belongs to.
+		// @param generation_hash Hash of the generation settings, see [compute_generation_hash()].
+		// @param data The encoded audio file.
+		// @return true if the records were written and the pack remapped, false otherwise.
+		bool append(const UUID ID, const u64 generation_hash, const std::span<const u8> data);
+
+		// Reads the file at [path] and appends it as a new take for [ID].
+		// @return true on success, false if the file could not be read or appended.
+		bool append_file(const UUID ID, const u64 generation_hash, const std::filesystem::path& path);
+
+		// @return true if a take exists for [ID].
+		bool contains(const UUID ID) const;
+
+		// @return true if the current take for [ID] was produced with [generation_hash].
+		bool contains(const UUID ID, const u64 generation_hash) const;
+
+		// Returns a zero-copy view of the current take for [ID].
+		// @param type Which record of the take to return, peaks are only returned if they belong to the current audio.
+		// @return A valid clip if found, an invalid (empty) clip otherwise.
+		clip get_clip(const UUID ID, const record_type type = record_type::audio) const;
+
+		// Writes the current take for [ID] to [target] directly from the mapping.
+		// @return true if the file was written, false otherwise.
+		bool export_clip(const UUID ID, const std::filesystem::path& target) const;
+
+		// @return true if superseded takes occupy enough space to justify a [compact()].
+		bool needs_compaction() const;
+
+		// Rewrites the pack so it only contains the current take for every UUID, stale peaks are dropped.
+		// The new file is written from a snapshot of the index without holding the lock and swapped in with a rename,
+		// outstanding clips keep reading the old mapping. Takes appended meanwhile are carried over.
+		// Blocking for as long as the pack takes to copy, the dashboard runs it on its [project_writer] thread.
+		// @return true on success, false if the pack was left unchanged.
+		bool compact();
+
+		DEFAULT_GETTER_C(std::filesystem::path, path);
+
+	private:
+
+		struct entry {
+			u64						offset = 0;						// offset of the payload (not the record header)
+			u64						length = 0;
+			u64						generation_hash = 0;
+		};
+
+		using index_map = std::unordered_map<UUID, entry>;
+
+		static bool is_current(const entry& audio_entry, const entry& derived_entry);
+		bool replace_file(const std::filesystem::path& source);
+		bool remap();
+		bool build_index();
+		bool import_loose_file(const std::filesystem::path& file);
+		void import_loose_files();
+		void generate_missing_peaks();
+		bool write_records(const UUID ID, const u64 generation_hash, const std::initializer_list<std::pair<record_type, std::span<const u8>>> records);
+
+		std::filesystem::path							m_path{};
+		mutable std::shared_mutex						m_mutex{};
+		ref<io::mapped_file>							m_mapping{};
+		std::array<index_map, static_cast<size_t>(record_type::count)>	m_index{};
+		u64												m_live_bytes = 0;
+		u64												m_dead_bytes = 0;				// payload bytes of superseded records
+		std::future<void>								m_initial_import{};				// [import_loose_files()] and [generate_missing_peaks()] of the constructor
+		std::unique_ptr<io::directory_watcher>			m_directory_watcher{};			// created last, reset first in the destructor
+	};
+
+}
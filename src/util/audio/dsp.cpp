@@ -0,0 +1,271 @@
+#include "util/pch.h"
+
+#include <bit>
+#include <smmintrin.h>    // SSE4.1
+
+#include "util/math/constance.h"
+#include "util/audio/wav.h"
+#include "util/audio/kernels.h"
+
+#include "dsp.h"
+
+namespace AT::audio {
+
+	#define WSOLA_FRAME_MS					30.f
+	#define WSOLA_TOLERANCE_MS				10.f
+
+	static FORCEINLINE f32 db_to_linear(const f32 db) { return std::pow(10.f, db / 20.f); }
+
+
+	// index of the first sample with an absolute value above [threshold], [samples.size()] if there is none
+	static size_t find_first_above(const std::span<const f32> samples, const f32 threshold) {
+
+		const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		const __m128 limit = _mm_set1_ps(threshold);
+		size_t x = 0;
+		for (; x + 4 <= samples.size(); x += 4) {
+
+			const __m128 value = _mm_and_ps(_mm_loadu_ps(samples.data() + x), abs_mask);
+			if (const int mask = _mm_movemask_ps(_mm_cmpgt_ps(value, limit)); mask != 0)
+				return x + std::countr_zero(static_cast<u32>(mask));
+		}
+
+		for (; x < samples.size(); x++)
+			if (std::abs(samples[x]) > threshold)
+				return x;
+		return samples.size();
+	}
+
+
+	// index of the last sample with an absolute value above [threshold], [samples.size()] if there is none
+	static size_t find_last_above(const std::span<const f32> samples, const f32 threshold) {
+
+		const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		const __m128 limit = _mm_set1_ps(threshold);
+		size_t end = samples.size();
+		for (; end % 4 != 0; end--)
+			if (std::abs(samples[end - 1]) > threshold)
+				return end - 1;
+
+		for (; end >= 4; end -= 4) {
+
+			const __m128 value = _mm_and_ps(_mm_loadu_ps(samples.data() + end - 4), abs_mask);
+			if (const int mask = _mm_movemask_ps(_mm_cmpgt_ps(value, limit)); mask != 0)
+				return end - 4 + (31 - std::countl_zero(static_cast<u32>(mask)));
+		}
+		return samples.size();
+	}
+
+
+	bool effect_settings::is_neutral() const {
+
+		if (gain_db != 0.f || trim_silence || speed != 1.f || output_sample_rate != 0)
+			return false;
+
+		for (const auto& band : eq_bands)
+			if (band.gain_db != 0.f)
+				return false;
+		return true;
+	}
+
+
+	void process(std::vector<f32>& samples, const u32 sample_rate, const effect_settings& settings) {
+
+		PROFILE_FUNCTION();
+
+		if (settings.trim_silence)
+			trim_silence(samples, sample_rate, settings.trim_threshold_db, settings.trim_padding_ms);
+
+		for (const auto& band : settings.eq_bands)
+			if (band.gain_db != 0.f)
+				apply_eq_band(samples, sample_rate, band);
+
+		if (settings.gain_db != 0.f)
+			apply_gain(samples, db_to_linear(settings.gain_db));
+
+		if (settings.speed != 1.f) {
+
+			std::vector<f32> stretched;
+			time_stretch(samples, stretched, sample_rate, settings.speed);
+			samples = std::move(stretched);
+		}
+	}
+
+
+	bool render_clip(const std::span<const u8> wav_file, const effect_settings& settings, std::vector<u8>& output) {
+
+		wav_info info{};
+		VALIDATE(parse_wav(wav_file, info), return false, "", "Could not decode clip for processing")
+
+		std::vector<f32> samples;
+		decode_to_mono(info, samples);
+		process(samples, info.sample_rate, settings);
+
+		u32 sample_rate = info.sample_rate;
+		if (settings.output_sample_rate != 0 && settings.output_sample_rate != sample_rate) {
+
+			std::vector<f32> resampled;
+			resample(samples, sample_rate, settings.output_sample_rate, resampled);
+			samples = std::move(resampled);
+			sample_rate = settings.output_sample_rate;
+		}
+
+		output = encode_wav(samples, sample_rate, sample_format::pcm);
+		return true;
+	}
+
+
+	void apply_gain(std::span<f32> samples, const f32 gain) {
+
+		const __m128 factor = _mm_set1_ps(gain);
+		const __m128 upper = _mm_set1_ps(1.f);
+		const __m128 lower = _mm_set1_ps(-1.f);
+		size_t x = 0;
+		for (; x + 4 <= samples.size(); x += 4) {
+
+			const __m128 value = _mm_mul_ps(_mm_loadu_ps(samples.data() + x), factor);
+			_mm_storeu_ps(samples.data() + x, _mm_max_ps(_mm_min_ps(value, upper), lower));
+		}
+
+		for (; x < samples.size(); x++)
+			samples[x] = math::clamp(samples[x] * gain, -1.f, 1.f);
+	}
+
+
+	void apply_eq_band(std::span<f32> samples, const u32 sample_rate, const eq_band& band) {
+
+		const f64 frequency = math::clamp<f64>(band.frequency, 10.0, sample_rate * 0.45);
+		const f64 A = std::pow(10.0, band.gain_db / 40.0);
+		const f64 w0 = two_pi<f64>() * frequency / sample_rate;
+		const f64 cos_w0 = std::cos(w0);
+		const f64 alpha = std::sin(w0) / (2.0 * math::max<f64>(band.q, 0.05));
+		const f64 shelf = 2.0 * std::sqrt(A) * alpha;
+
+		f64 b0, b1, b2, a0, a1, a2;
+		switch (band.type) {
+			case filter_type::low_shelf:
+				b0 = A * ((A + 1) - (A - 1) * cos_w0 + shelf);
+				b1 = 2 * A * ((A - 1) - (A + 1) * cos_w0);
+				b2 = A * ((A + 1) - (A - 1) * cos_w0 - shelf);
+				a0 = (A + 1) + (A - 1) * cos_w0 + shelf;
+				a1 = -2 * ((A - 1) + (A + 1) * cos_w0);
+				a2 = (A + 1) + (A - 1) * cos_w0 - shelf;
+				break;
+
+			case filter_type::high_shelf:
+				b0 = A * ((A + 1) + (A - 1) * cos_w0 + shelf);
+				b1 = -2 * A * ((A - 1) + (A + 1) * cos_w0);
+				b2 = A * ((A + 1) + (A - 1) * cos_w0 - shelf);
+				a0 = (A + 1) - (A - 1) * cos_w0 + shelf;
+				a1 = 2 * ((A - 1) - (A + 1) * cos_w0);
+				a2 = (A + 1) - (A - 1) * cos_w0 - shelf;
+				break;
+
+			default:
+			case filter_type::peaking:
+				b0 = 1 + alpha * A;
+				b1 = -2 * cos_w0;
+				b2 = 1 - alpha * A;
+				a0 = 1 + alpha / A;
+				a1 = -2 * cos_w0;
+				a2 = 1 - alpha / A;
+				break;
+		}
+
+		// transposed direct form II, state kept in double to avoid drift on long clips
+		const f64 n_b0 = b0 / a0, n_b1 = b1 / a0, n_b2 = b2 / a0, n_a1 = a1 / a0, n_a2 = a2 / a0;
+		f64 z1 = 0.0, z2 = 0.0;
+		for (f32& sample : samples) {
+
+			const f64 in = sample;
+			const f64 out = n_b0 * in + z1;
+			z1 = n_b1 * in - n_a1 * out + z2;
+			z2 = n_b2 * in - n_a2 * out;
+			sample = static_cast<f32>(out);
+		}
+	}
+
+
+	void trim_silence(std::vector<f32>& samples, const u32 sample_rate, const f32 threshold_db, const f32 padding_ms) {
+
+		const f32 threshold = db_to_linear(threshold_db);
+		const size_t first = find_first_above(samples, threshold);
+		if (first == samples.size()) {										// only silence, keep the clip instead of producing an empty file
+			LOG(Trace, "Clip is below the trim threshold, skipping trim")
+			return;
+		}
+
+		const size_t last = find_last_above(samples, threshold);
+		const size_t padding = static_cast<size_t>(padding_ms * 0.001f * sample_rate);
+		const size_t begin = (first > padding) ? first - padding : 0;
+		const size_t end = math::min(last + 1 + padding, samples.size());
+
+		samples.erase(samples.begin() + end, samples.end());
+		samples.erase(samples.begin(), samples.begin() + begin);
+	}
+
+
+	void time_stretch(const std::vector<f32>& input, std::vector<f32>& output, const u32 sample_rate, const f32 speed) {
+
+		PROFILE_FUNCTION();
+
+		const size_t frame_size = static_cast<size_t>(WSOLA_FRAME_MS * 0.001f * sample_rate) & ~size_t(1);
+		const size_t synthesis_hop = frame_size / 2;
+		const size_t tolerance = static_cast<size_t>(WSOLA_TOLERANCE_MS * 0.001f * sample_rate);
+		if (speed <= 0.f || input.size() < frame_size + 2 * tolerance || synthesis_hop == 0) {
+			output = input;
+			return;
+		}
+
+		std::vector<f32> window(frame_size);
+		for (size_t x = 0; x < frame_size; x++)
+			window[x] = 0.5f - 0.5f * std::cos(two_pi<f32>() * x / frame_size);		// periodic hann, sums to 1 at 50% overlap
+
+		const size_t output_size = static_cast<size_t>(input.size() / speed);
+		output.assign(output_size + frame_size, 0.f);
+
+		size_t previous_position = 0;
+		for (size_t frame = 0; ; frame++) {
+
+			const size_t output_position = frame * synthesis_hop;
+			const size_t ideal_position = static_cast<size_t>(static_cast<f64>(output_position) * speed);
+			if (output_position >= output_size || ideal_position + frame_size + tolerance > input.size())
+				break;
+
+			size_t position = ideal_position;
+			if (frame > 0) {				// pick the candidate that best continues the previous frame (natural progression = previous + hop)
+
+				const size_t natural = previous_position + synthesis_hop;
+				if (natural + synthesis_hop <= input.size()) {
+
+					const size_t search_begin = (ideal_position > tolerance) ? ideal_position - tolerance : 0;
+					const size_t search_end = ideal_position + tolerance;
+					f32 best_correlation = -std::numeric_limits<f32>::max();
+					for (size_t candidate = search_begin; candidate <= search_end; candidate++) {
+
+						const f32 correlation = dot_product(input.data() + natural, input.data() + candidate, synthesis_hop);
+						if (correlation > best_correlation) {
+							best_correlation = correlation;
+							position = candidate;
+						}
+					}
+				}
+			}
+
+			const f32* source = input.data() + position;
+			f32* target = output.data() + output_position;
+			for (size_t x = 0; x < frame_size; x++)
+				target[x] += source[x] * window[x];
+
+			previous_position = position;
+		}
+
+		// the first half-frame only got one window, restore its level
+		for (size_t x = 0; x < math::min(synthesis_hop, output.size()); x++)
+			if (window[x] > 0.001f)
+				output[x] /= window[x];
+
+		output.resize(output_size);
+	}
+
+}
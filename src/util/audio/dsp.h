@@ -0,0 +1,68 @@
+#pragma once
+
+
+namespace AT::audio {
+
+	enum class filter_type : u8 {
+		low_shelf = 0,
+		peaking,
+		high_shelf,
+	};
+
+	// One band of the parametric EQ. Bands with a gain of 0 dB are skipped.
+	struct eq_band {
+		filter_type					type = filter_type::peaking;
+		f32							frequency = 1000.f;				// center/corner frequency in Hz
+		f32							gain_db = 0.f;
+		f32							q = 0.707f;
+	};
+
+	// Settings of the effect chain applied at playback and export. Processing order: silence trim -> EQ -> gain -> time-stretch -> resample
+	struct effect_settings {
+		f32							gain_db = 0.f;
+		std::array<eq_band, 3>		eq_bands = { eq_band{filter_type::low_shelf, 120.f}, eq_band{filter_type::peaking, 1500.f, 0.f, 1.f}, eq_band{filter_type::high_shelf, 6000.f} };
+		bool						trim_silence = false;
+		f32							trim_threshold_db = -45.f;		// samples below this level count as silence
+		f32							trim_padding_ms = 20.f;			// silence kept before the first and after the last sound
+		f32							speed = 1.f;					// WSOLA time-stretch factor, pitch is preserved (2 = twice as fast)
+		u32							output_sample_rate = 0;			// polyphase resampling after the chain, 0 keeps the rate of the model
+
+		// @return true if processing would not change the audio, so the stored clip can be used as is.
+		bool is_neutral() const;
+	};
+
+
+	// Runs the complete effect chain on a mono buffer in place.
+	// @param samples Mono samples in the range [-1, 1], the size changes if trimming or time-stretching is active.
+	// @param sample_rate The sample rate of [samples].
+	// @param settings The effect settings.
+	void process(std::vector<f32>& samples, const u32 sample_rate, const effect_settings& settings);
+
+	// Decodes a WAV file, runs the effect chain, resamples to [settings.output_sample_rate] and encodes the result as a dithered 16 bit WAV file.
+	// @param wav_file The complete source WAV file.
+	// @param settings The effect settings.
+	// @param output Receives the processed WAV file.
+	// @return true on success, false if [wav_file] could not be decoded.
+	bool render_clip(const std::span<const u8> wav_file, const effect_settings& settings, std::vector<u8>& output);
+
+	// ------------------------------------------------------------------------------------------------------------------
+	// single stages, exposed to allow processing of already decoded buffers
+	// ------------------------------------------------------------------------------------------------------------------
+
+	// Multiplies all samples by [gain] and clamps them to [-1, 1] (SSE).
+	void apply_gain(std::span<f32> samples, const f32 gain);
+
+	// Runs [band] as a biquad filter (RBJ audio-EQ-cookbook) over [samples]. The recursion is inherently serial and stays scalar.
+	void apply_eq_band(std::span<f32> samples, const u32 sample_rate, const eq_band& band);
+
+	// Removes leading and trailing samples below [threshold_db], keeping [padding_ms] of silence on each side (SSE scan).
+	void trim_silence(std::vector<f32>& samples, const u32 sample_rate, const f32 threshold_db, const f32 padding_ms);
+
+	// Changes the duration of [input] by 1 / [speed] without changing its pitch (WSOLA, cross-correlation via the dispatched [dot_product()]).
+	// @param input Mono source samples.
+	// @param output Receives the stretched samples.
+	// @param sample_rate The sample rate of [input], used to derive frame and search sizes.
+	// @param speed The time-stretch factor, values above 1 shorten the audio.
+	void time_stretch(const std::vector<f32>& input, std::vector<f32>& output, const u32 sample_rate, const f32 speed);
+
+}
@@ -0,0 +1,520 @@
+#include "util/pch.h"
+
+#include <numeric>
+#include <smmintrin.h>    // SSE4.1
+#include <immintrin.h>    // AVX2
+
+#if defined(PLATFORM_WINDOWS)
+	#include <intrin.h>
+#endif
+
+#include "util/math/constance.h"
+
+#include "kernels.h"
+
+// AVX2 paths are compiled per function so the rest of the project keeps its SSE4.1 baseline, MSVC accepts the intrinsics without a flag
+#if defined(_MSC_VER)
+	#define TARGET_AVX2
+#else
+	#define TARGET_AVX2					__attribute__((target("avx2,fma")))
+#endif
+
+namespace AT::audio {
+
+	#define INT16_SCALE					32767.f
+
+	// ------------------------------------------------------------------------------------------------------------------
+	// scalar reference
+	// ------------------------------------------------------------------------------------------------------------------
+
+	static FORCEINLINE u32 xorshift32(u32& state) {
+
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	// uniform value in [0, 1) from the upper 23 bits
+	static FORCEINLINE f32 to_unit_float(const u32 value) { return static_cast<f32>(value >> 9) * (1.f / 8388608.f); }
+
+	static FORCEINLINE int16 quantize(const f32 value) { return static_cast<int16>(std::lrintf(math::clamp(value, -32768.f, 32767.f))); }
+
+
+	namespace scalar {
+
+		void float_to_int16(const f32* input, int16* output, const size_t count) {
+
+			for (size_t x = 0; x < count; x++)
+				output[x] = quantize(input[x] * INT16_SCALE);
+		}
+
+		void float_to_int16_dither(const f32* input, int16* output, const size_t count, dither_state& state) {
+
+			u32& lane = state.lanes[0];
+			for (size_t x = 0; x < count; x++) {
+
+				const f32 noise = to_unit_float(xorshift32(lane)) - to_unit_float(xorshift32(lane));		// triangular in (-1, 1) LSB
+				output[x] = quantize(input[x] * INT16_SCALE + noise);
+			}
+		}
+
+		void interleave(const f32* left, const f32* right, f32* output, const size_t frames) {
+
+			for (size_t x = 0; x < frames; x++) {
+				output[2 * x] = left[x];
+				output[2 * x + 1] = right[x];
+			}
+		}
+
+		void deinterleave(const f32* input, f32* left, f32* right, const size_t frames) {
+
+			for (size_t x = 0; x < frames; x++) {
+				left[x] = input[2 * x];
+				right[x] = input[2 * x + 1];
+			}
+		}
+
+		f32 dot_product(const f32* a, const f32* b, const size_t count) {
+
+			f32 result = 0.f;
+			for (size_t x = 0; x < count; x++)
+				result += a[x] * b[x];
+			return result;
+		}
+	}
+
+	// ------------------------------------------------------------------------------------------------------------------
+	// SSE4.1
+	// ------------------------------------------------------------------------------------------------------------------
+
+	namespace sse41 {
+
+		// 4 lanes of xorshift32 -> 4 floats in [0, 1)
+		static FORCEINLINE __m128 random_unit(__m128i& state) {
+
+			state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+			state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+			state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+			const __m128i mantissa = _mm_or_si128(_mm_srli_epi32(state, 9), _mm_set1_epi32(0x3F800000));		// [1, 2)
+			return _mm_sub_ps(_mm_castsi128_ps(mantissa), _mm_set1_ps(1.f));
+		}
+
+		// converts 8 samples with rounding (MXCSR default: nearest) and signed saturation
+		static FORCEINLINE __m128i pack_int16(const __m128 low, const __m128 high) {
+
+			return _mm_packs_epi32(_mm_cvtps_epi32(low), _mm_cvtps_epi32(high));
+		}
+
+		static void float_to_int16(const f32* input, int16* output, const size_t count) {
+
+			const __m128 scale = _mm_set1_ps(INT16_SCALE);
+			size_t x = 0;
+			for (; x + 8 <= count; x += 8) {
+
+				const __m128 low = _mm_mul_ps(_mm_loadu_ps(input + x), scale);
+				const __m128 high = _mm_mul_ps(_mm_loadu_ps(input + x + 4), scale);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(output + x), pack_int16(low, high));
+			}
+			scalar::float_to_int16(input + x, output + x, count - x);
+		}
+
+		static void float_to_int16_dither(const f32* input, int16* output, const size_t count, dither_state& state) {
+
+			const __m128 scale = _mm_set1_ps(INT16_SCALE);
+			__m128i rng = _mm_load_si128(reinterpret_cast<const __m128i*>(state.lanes.data()));
+			size_t x = 0;
+			for (; x + 8 <= count; x += 8) {
+
+				const __m128 noise_low = _mm_sub_ps(random_unit(rng), random_unit(rng));
+				const __m128 noise_high = _mm_sub_ps(random_unit(rng), random_unit(rng));
+				const __m128 low = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(input + x), scale), noise_low);
+				const __m128 high = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(input + x + 4), scale), noise_high);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(output + x), pack_int16(low, high));
+			}
+			_mm_store_si128(reinterpret_cast<__m128i*>(state.lanes.data()), rng);
+			scalar::float_to_int16_dither(input + x, output + x, count - x, state);
+		}
+
+		static void interleave(const f32* left, const f32* right, f32* output, const size_t frames) {
+
+			size_t x = 0;
+			for (; x + 4 <= frames; x += 4) {
+
+				const __m128 l = _mm_loadu_ps(left + x);
+				const __m128 r = _mm_loadu_ps(right + x);
+				_mm_storeu_ps(output + 2 * x, _mm_unpacklo_ps(l, r));
+				_mm_storeu_ps(output + 2 * x + 4, _mm_unpackhi_ps(l, r));
+			}
+			scalar::interleave(left + x, right + x, output + 2 * x, frames - x);
+		}
+
+		static void deinterleave(const f32* input, f32* left, f32* right, const size_t frames) {
+
+			size_t x = 0;
+			for (; x + 4 <= frames; x += 4) {
+
+				const __m128 a = _mm_loadu_ps(input + 2 * x);
+				const __m128 b = _mm_loadu_ps(input + 2 * x + 4);
+				_mm_storeu_ps(left + x, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+				_mm_storeu_ps(right + x, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+			}
+			scalar::deinterleave(input + 2 * x, left + x, right + x, frames - x);
+		}
+
+		static f32 dot_product(const f32* a, const f32* b, const size_t count) {
+
+			__m128 sum_0 = _mm_setzero_ps();
+			__m128 sum_1 = _mm_setzero_ps();								// two accumulators hide the add latency
+			size_t x = 0;
+			for (; x + 8 <= count; x += 8) {
+				sum_0 = _mm_add_ps(sum_0, _mm_mul_ps(_mm_loadu_ps(a + x), _mm_loadu_ps(b + x)));
+				sum_1 = _mm_add_ps(sum_1, _mm_mul_ps(_mm_loadu_ps(a + x + 4), _mm_loadu_ps(b + x + 4)));
+			}
+			for (; x + 4 <= count; x += 4)
+				sum_0 = _mm_add_ps(sum_0, _mm_mul_ps(_mm_loadu_ps(a + x), _mm_loadu_ps(b + x)));
+
+			__m128 sum = _mm_add_ps(sum_0, sum_1);
+			sum = _mm_hadd_ps(sum, sum);
+			sum = _mm_hadd_ps(sum, sum);
+			return _mm_cvtss_f32(sum) + scalar::dot_product(a + x, b + x, count - x);
+		}
+	}
+
+	// ------------------------------------------------------------------------------------------------------------------
+	// AVX2
+	// ------------------------------------------------------------------------------------------------------------------
+
+	namespace avx2 {
+
+		TARGET_AVX2 static FORCEINLINE __m256 random_unit(__m256i& state) {
+
+			state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 13));
+			state = _mm256_xor_si256(state, _mm256_srli_epi32(state, 17));
+			state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 5));
+			const __m256i mantissa = _mm256_or_si256(_mm256_srli_epi32(state, 9), _mm256_set1_epi32(0x3F800000));
+			return _mm256_sub_ps(_mm256_castsi256_ps(mantissa), _mm256_set1_ps(1.f));
+		}
+
+		// packs work per 128 bit lane, the permute restores sample order
+		TARGET_AVX2 static FORCEINLINE __m256i pack_int16(const __m256 low, const __m256 high) {
+
+			const __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(low), _mm256_cvtps_epi32(high));
+			return _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+		}
+
+		TARGET_AVX2 static void float_to_int16(const f32* input, int16* output, const size_t count) {
+
+			const __m256 scale = _mm256_set1_ps(INT16_SCALE);
+			size_t x = 0;
+			for (; x + 16 <= count; x += 16) {
+
+				const __m256 low = _mm256_mul_ps(_mm256_loadu_ps(input + x), scale);
+				const __m256 high = _mm256_mul_ps(_mm256_loadu_ps(input + x + 8), scale);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(output + x), pack_int16(low, high));
+			}
+			sse41::float_to_int16(input + x, output + x, count - x);
+		}
+
+		TARGET_AVX2 static void float_to_int16_dither(const f32* input, int16* output, const size_t count, dither_state& state) {
+
+			const __m256 scale = _mm256_set1_ps(INT16_SCALE);
+			__m256i rng = _mm256_load_si256(reinterpret_cast<const __m256i*>(state.lanes.data()));
+			size_t x = 0;
+			for (; x + 16 <= count; x += 16) {
+
+				const __m256 noise_low = _mm256_sub_ps(random_unit(rng), random_unit(rng));
+				const __m256 noise_high = _mm256_sub_ps(random_unit(rng), random_unit(rng));
+				const __m256 low = _mm256_fmadd_ps(_mm256_loadu_ps(input + x), scale, noise_low);
+				const __m256 high = _mm256_fmadd_ps(_mm256_loadu_ps(input + x + 8), scale, noise_high);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(output + x), pack_int16(low, high));
+			}
+			_mm256_store_si256(reinterpret_cast<__m256i*>(state.lanes.data()), rng);
+			sse41::float_to_int16_dither(input + x, output + x, count - x, state);
+		}
+
+		TARGET_AVX2 static void interleave(const f32* left, const f32* right, f32* output, const size_t frames) {
+
+			size_t x = 0;
+			for (; x + 8 <= frames; x += 8) {
+
+				const __m256 l = _mm256_loadu_ps(left + x);
+				const __m256 r = _mm256_loadu_ps(right + x);
+				const __m256 low = _mm256_unpacklo_ps(l, r);				// L0 R0 L1 R1 | L4 R4 L5 R5
+				const __m256 high = _mm256_unpackhi_ps(l, r);				// L2 R2 L3 R3 | L6 R6 L7 R7
+				_mm256_storeu_ps(output + 2 * x, _mm256_permute2f128_ps(low, high, 0x20));
+				_mm256_storeu_ps(output + 2 * x + 8, _mm256_permute2f128_ps(low, high, 0x31));
+			}
+			sse41::interleave(left + x, right + x, output + 2 * x, frames - x);
+		}
+
+		TARGET_AVX2 static void deinterleave(const f32* input, f32* left, f32* right, const size_t frames) {
+
+			size_t x = 0;
+			for (; x + 8 <= frames; x += 8) {
+
+				const __m256 a = _mm256_loadu_ps(input + 2 * x);
+				const __m256 b = _mm256_loadu_ps(input + 2 * x + 8);
+				const __m256 a_ordered = _mm256_permute2f128_ps(a, b, 0x20);	// frames 0,1 | 4,5
+				const __m256 b_ordered = _mm256_permute2f128_ps(a, b, 0x31);	// frames 2,3 | 6,7
+				_mm256_storeu_ps(left + x, _mm256_shuffle_ps(a_ordered, b_ordered, _MM_SHUFFLE(2, 0, 2, 0)));
+				_mm256_storeu_ps(right + x, _mm256_shuffle_ps(a_ordered, b_ordered, _MM_SHUFFLE(3, 1, 3, 1)));
+			}
+			sse41::deinterleave(input + 2 * x, left + x, right + x, frames - x);
+		}
+
+		TARGET_AVX2 static f32 dot_product(const f32* a, const f32* b, const size_t count) {
+
+			__m256 sum_0 = _mm256_setzero_ps();
+			__m256 sum_1 = _mm256_setzero_ps();
+			size_t x = 0;
+			for (; x + 16 <= count; x += 16) {
+				sum_0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + x), _mm256_loadu_ps(b + x), sum_0);
+				sum_1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + x + 8), _mm256_loadu_ps(b + x + 8), sum_1);
+			}
+			for (; x + 8 <= count; x += 8)
+				sum_0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + x), _mm256_loadu_ps(b + x), sum_0);
+
+			const __m256 sum = _mm256_add_ps(sum_0, sum_1);
+			__m128 reduced = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+			reduced = _mm_hadd_ps(reduced, reduced);
+			reduced = _mm_hadd_ps(reduced, reduced);
+			f32 result = _mm_cvtss_f32(reduced);
+			for (; x < count; x++)						// inline tail, calling the legacy-SSE path here would cost an AVX/SSE transition per call
+				result += a[x] * b[x];
+			return result;
+		}
+	}
+
+	// ------------------------------------------------------------------------------------------------------------------
+	// dispatch
+	// ------------------------------------------------------------------------------------------------------------------
+
+	struct kernel_table {
+		void (*float_to_int16)(const f32*, int16*, const size_t);
+		void (*float_to_int16_dither)(const f32*, int16*, const size_t, dither_state&);
+		void (*interleave)(const f32*, const f32*, f32*, const size_t);
+		void (*deinterleave)(const f32*, f32*, f32*, const size_t);
+		f32 (*dot_product)(const f32*, const f32*, const size_t);
+	};
+
+	static const kernel_table s_kernel_tables[] = {
+		{ scalar::float_to_int16, scalar::float_to_int16_dither, scalar::interleave, scalar::deinterleave, scalar::dot_product },
+		{ sse41::float_to_int16, sse41::float_to_int16_dither, sse41::interleave, sse41::deinterleave, sse41::dot_product },
+		{ avx2::float_to_int16, avx2::float_to_int16_dither, avx2::interleave, avx2::deinterleave, avx2::dot_product },
+	};
+
+	static std::atomic<const kernel_table*> s_active_kernels = nullptr;
+
+	static FORCEINLINE const kernel_table& get_kernels() {
+
+		const kernel_table* table = s_active_kernels.load(std::memory_order_acquire);
+		if (!table) [[unlikely]] {
+			set_simd_level(detect_simd_level());
+			table = s_active_kernels.load(std::memory_order_acquire);
+		}
+		return *table;
+	}
+
+
+	simd_level detect_simd_level() {
+
+		static const simd_level s_detected = [] {
+#if defined(_MSC_VER)
+			int info[4]{};
+			__cpuid(info, 0);
+			if (info[0] >= 7) {
+
+				__cpuid(info, 1);
+				const bool os_saves_ymm = (info[2] & (1 << 27)) && ((_xgetbv(0) & 0x6) == 0x6);		// OSXSAVE + XMM/YMM state enabled
+				const bool has_fma = info[2] & (1 << 12);
+				const bool has_sse41 = info[2] & (1 << 19);
+				__cpuidex(info, 7, 0);
+				if (os_saves_ymm && has_fma && (info[1] & (1 << 5)))
+					return simd_level::avx2;
+				if (has_sse41)
+					return simd_level::sse41;
+			}
+			return simd_level::scalar;
+#else
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+				return simd_level::avx2;
+			if (__builtin_cpu_supports("sse4.1"))
+				return simd_level::sse41;
+			return simd_level::scalar;
+#endif
+		}();
+		return s_detected;
+	}
+
+
+	simd_level get_simd_level() {
+
+		const kernel_table& table = get_kernels();
+		return static_cast<simd_level>(&table - s_kernel_tables);
+	}
+
+
+	void set_simd_level(const simd_level level) {
+
+		const simd_level clamped = math::min(level, detect_simd_level());
+		s_active_kernels.store(&s_kernel_tables[static_cast<u8>(clamped)], std::memory_order_release);
+		LOG(Trace, "Audio kernels use [" << simd_level_to_string(clamped) << "]")
+	}
+
+
+	const char* simd_level_to_string(const simd_level level) {
+
+		switch (level) {
+			case simd_level::scalar:	return "scalar";
+			case simd_level::sse41:		return "SSE4.1";
+			case simd_level::avx2:		return "AVX2";
+			default:					return "unknown";
+		}
+	}
+
+
+	dither_state::dither_state(const u32 seed) {
+
+		u32 value = seed ? seed : 0x9E3779B9;								// xorshift must never be seeded with 0
+		for (u32& lane : lanes) {
+			xorshift32(value);
+			lane = value;
+		}
+	}
+
+
+	void float_to_int16(const std::span<const f32> input, std::span<int16> output) {
+
+		ASSERT(output.size() >= input.size(), "", "output buffer is too small")
+		get_kernels().float_to_int16(input.data(), output.data(), input.size());
+	}
+
+
+	void float_to_int16_dither(const std::span<const f32> input, std::span<int16> output, dither_state& state) {
+
+		ASSERT(output.size() >= input.size(), "", "output buffer is too small")
+		get_kernels().float_to_int16_dither(input.data(), output.data(), input.size(), state);
+	}
+
+
+	void interleave(const f32* left, const f32* right, f32* output, const size_t frames) { get_kernels().interleave(left, right, output, frames); }
+
+	void deinterleave(const f32* input, f32* left, f32* right, const size_t frames) { get_kernels().deinterleave(input, left, right, frames); }
+
+	f32 dot_product(const f32* a, const f32* b, const size_t count) { return get_kernels().dot_product(a, b, count); }
+
+	// ------------------------------------------------------------------------------------------------------------------
+	// polyphase resampler
+	// ------------------------------------------------------------------------------------------------------------------
+
+	polyphase_resampler::polyphase_resampler(const u32 input_rate, const u32 output_rate, const u32 taps_per_phase)
+		: m_taps_per_phase(math::max<u32>(taps_per_phase, 4) & ~3u) {
+
+		const u32 divisor = std::gcd(input_rate, output_rate);
+		m_upsample_factor = output_rate / divisor;
+		m_downsample_factor = input_rate / divisor;
+
+		// windowed-sinc prototype at the upsampled rate, cutoff slightly below the lower of both nyquist frequencies
+		const u32 L = m_upsample_factor;
+		const u32 total_taps = L * m_taps_per_phase;
+		const f64 cutoff = 0.5 * 0.92 / math::max(m_upsample_factor, m_downsample_factor);		// cycles per upsampled sample
+		const u32 center = (total_taps - 1) / 2;								// integer group delay, the last tap stays zero for even lengths
+
+		std::vector<f64> prototype(total_taps, 0.0);
+		for (u32 x = 0; x <= 2 * center; x++) {
+
+			const f64 t = static_cast<f64>(x) - center;
+			const f64 sinc = (t == 0.0) ? 2.0 * cutoff : std::sin(two_pi<f64>() * cutoff * t) / (pi<f64>() * t);
+			const f64 phase = two_pi<f64>() * (x + 1) / (2 * center + 2);						// skips the zero end points of the window
+			const f64 window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);		// blackman
+			prototype[x] = sinc * window * L;														// zero-stuffing divides the level by L
+		}
+
+		m_coefficients.resize(total_taps);
+		for (u32 phase = 0; phase < L; phase++)
+			for (u32 tap = 0; tap < m_taps_per_phase; tap++)
+				m_coefficients[phase * m_taps_per_phase + tap] = static_cast<f32>(prototype[phase + (m_taps_per_phase - 1 - tap) * L]);
+	}
+
+
+	void polyphase_resampler::process(const std::span<const f32> input, std::vector<f32>& output) const {
+
+		PROFILE_FUNCTION();
+
+		const u64 L = m_upsample_factor;
+		const u64 M = m_downsample_factor;
+		const u64 taps = m_taps_per_phase;
+		const u64 output_size = (input.size() * L + M - 1) / M;
+		const u64 delay = (L * taps - 1) / 2;						// group delay of the prototype at the upsampled rate (matches [center])
+
+		// [taps - 1] zeros of history in front and enough silence behind so every dot product stays in bounds
+		std::vector<f32> padded(input.size() + 2 * taps, 0.f);
+		std::memcpy(padded.data() + taps - 1, input.data(), input.size() * sizeof(f32));
+
+		const kernel_table& kernels = get_kernels();
+		output.resize(output_size);
+		for (u64 x = 0; x < output_size; x++) {
+
+			const u64 position = x * M + delay;
+			const u64 base = position / L;
+			const u64 phase = position % L;
+			output[x] = kernels.dot_product(m_coefficients.data() + phase * taps, padded.data() + base, taps);
+		}
+	}
+
+
+	void resample(const std::span<const f32> input, const u32 input_rate, const u32 output_rate, std::vector<f32>& output) {
+
+		if (input_rate == output_rate || input_rate == 0 || output_rate == 0) {
+			output.assign(input.begin(), input.end());
+			return;
+		}
+
+		const polyphase_resampler resampler(input_rate, output_rate);
+		resampler.process(input, output);
+	}
+
+	// ------------------------------------------------------------------------------------------------------------------
+	// benchmarks
+	// ------------------------------------------------------------------------------------------------------------------
+
+	void run_kernel_benchmarks() {
+
+		using util::stopwatch;
+
+		constexpr size_t sample_count = 24000 * 10;				// 10 seconds of model output
+		constexpr size_t iterations = 200;
+
+		std::vector<f32> samples(sample_count);
+		u32 rng = 12345;
+		for (size_t x = 0; x < sample_count; x++)
+			samples[x] = 0.6f * std::sin(two_pi<f32>() * 220.f * x / 24000.f) + 0.1f * (to_unit_float(xorshift32(rng)) - 0.5f);
+
+		std::vector<int16> pcm(sample_count);
+		std::vector<f32> stereo(sample_count * 2);
+		std::vector<f32> left(sample_count), right(sample_count);
+		std::vector<f32> resampled;
+		dither_state dither{};
+		volatile f32 sink = 0.f;									// keeps the dot product from being optimized away
+
+		const simd_level previous_level = get_simd_level();
+		LOG(Info, "Audio kernel benchmark, " << sample_count << " samples, CPU supports [" << simd_level_to_string(detect_simd_level()) << "]")
+		for (u8 level = 0; level <= static_cast<u8>(detect_simd_level()); level++) {
+
+			set_simd_level(static_cast<simd_level>(level));
+			const char* name = simd_level_to_string(static_cast<simd_level>(level));
+
+			ISOLATED_PROFILER_LOOP(iterations, "float_to_int16        [" << name << "]", miliseconds, { float_to_int16(samples, pcm); })
+			ISOLATED_PROFILER_LOOP(iterations, "float_to_int16_dither [" << name << "]", miliseconds, { float_to_int16_dither(samples, pcm, dither); })
+			ISOLATED_PROFILER_LOOP(iterations, "interleave            [" << name << "]", miliseconds, { interleave(samples.data(), samples.data(), stereo.data(), sample_count); })
+			ISOLATED_PROFILER_LOOP(iterations, "deinterleave          [" << name << "]", miliseconds, { deinterleave(stereo.data(), left.data(), right.data(), sample_count); })
+			ISOLATED_PROFILER_LOOP(iterations, "dot_product           [" << name << "]", miliseconds, { sink = sink + dot_product(samples.data(), left.data(), sample_count); })
+			ISOLATED_PROFILER_LOOP(10, "resample 24k -> 44.1k [" << name << "]", miliseconds, { resample(samples, 24000, 44100, resampled); })
+			ISOLATED_PROFILER_LOOP(10, "resample 24k -> 48k   [" << name << "]", miliseconds, { resample(samples, 24000, 48000, resampled); })
+		}
+		set_simd_level(previous_level);
+	}
+
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+
+// Vectorized audio kernels with runtime CPU dispatch.
+// Every kernel has a scalar reference implementation (namespace [scalar]), an SSE4.1 path (the baseline the project is compiled for)
+// and, where it pays off, an AVX2 path that is compiled with a per-function target attribute and only selected if the CPU supports it.
+namespace AT::audio {
+
+	enum class simd_level : u8 {
+		scalar = 0,
+		sse41,
+		avx2,
+	};
+
+	// @return The best instruction set supported by the CPU (queried once).
+	simd_level detect_simd_level();
+
+	// @return The instruction set the kernels currently dispatch to.
+	simd_level get_simd_level();
+
+	// Forces the kernels onto a specific path, used to compare implementations. Levels above [detect_simd_level()] are clamped.
+	// @param level The requested instruction set.
+	void set_simd_level(const simd_level level);
+
+	// @return A readable name of [level].
+	const char* simd_level_to_string(const simd_level level);
+
+
+	// State of the dither noise generator, one xorshift32 state per SIMD lane
+	struct dither_state {
+		alignas(32) std::array<u32, 8>	lanes{};
+
+		dither_state(const u32 seed = 0x9E3779B9);
+	};
+
+	// Converts float samples in [-1, 1] to int16 with rounding and saturation.
+	// @param input The source samples.
+	// @param output Receives [input.size()] samples, must be at least as large as [input].
+	void float_to_int16(const std::span<const f32> input, std::span<int16> output);
+
+	// Same as [float_to_int16()] with ±1 LSB triangular (TPDF) dither added before quantization.
+	void float_to_int16_dither(const std::span<const f32> input, std::span<int16> output, dither_state& state);
+
+	// Interleaves two channels into LRLR... order.
+	// @param output Receives [frames] * 2 samples.
+	void interleave(const f32* left, const f32* right, f32* output, const size_t frames);
+
+	// Splits LRLR... samples into two channels.
+	// @param input Holds [frames] * 2 samples.
+	void deinterleave(const f32* input, f32* left, f32* right, const size_t frames);
+
+	// @return The sum of [a] * [b] over [count] samples.
+	f32 dot_product(const f32* a, const f32* b, const size_t count);
+
+
+	// Rational-ratio polyphase FIR resampler (e.g. 24 kHz model output -> 44.1/48 kHz).
+	// The windowed-sinc prototype is split into L phases, each output sample is one [dot_product()] over [taps_per_phase] inputs.
+	class polyphase_resampler {
+	public:
+
+		// @param input_rate The sample rate of the source.
+		// @param output_rate The requested sample rate.
+		// @param taps_per_phase Filter length per phase, higher values give a steeper anti-aliasing filter.
+		polyphase_resampler(const u32 input_rate, const u32 output_rate, const u32 taps_per_phase = 32);
+
+		// Resamples a complete mono buffer, the filter delay is compensated so the output is aligned with the input.
+		// @param input The source samples.
+		// @param output Receives ceil([input.size()] * output_rate / input_rate) samples.
+		void process(const std::span<const f32> input, std::vector<f32>& output) const;
+
+		DEFAULT_GETTER_C(u32, upsample_factor);
+		DEFAULT_GETTER_C(u32, downsample_factor);
+
+	private:
+
+		u32							m_upsample_factor = 1;			// L
+		u32							m_downsample_factor = 1;		// M
+		u32							m_taps_per_phase = 0;
+		std::vector<f32>			m_coefficients{};				// [phase][tap], taps reversed so they match ascending input order
+	};
+
+	// Resamples [input] from [input_rate] to [output_rate], copies the input if the rates match.
+	void resample(const std::span<const f32> input, const u32 input_rate, const u32 output_rate, std::vector<f32>& output);
+
+
+	// Runs every kernel on all supported instruction sets and logs the average durations (ISOLATED_PROFILER_LOOP).
+	// Started with the [--benchmark-audio-kernels] command line argument.
+	void run_kernel_benchmarks();
+
+
+	// Scalar reference implementations, used as fallback and to validate the vectorized paths
+	namespace scalar {
+
+		void float_to_int16(const f32* input, int16* output, const size_t count);
+		void float_to_int16_dither(const f32* input, int16* output, const size_t count, dither_state& state);
+		void interleave(const f32* left, const f32* right, f32* output, const size_t frames);
+		void deinterleave(const f32* input, f32* left, f32* right, const size_t frames);
+		f32 dot_product(const f32* a, const f32* b, const size_t count);
+	}
+
+}
@@ -0,0 +1,110 @@
+#include "util/pch.h"
+
+#include "peaks.h"
+
+namespace AT::audio {
+
+	#define PEAK_MAGIC						0x4B414550		// "PEAK"
+	#define PEAK_BASE_BUCKET_SIZE			256
+
+	struct peak_header {
+		u32			magic = PEAK_MAGIC;
+		u32			base_bucket_size = PEAK_BASE_BUCKET_SIZE;
+		u32			sample_rate = 0;
+		u32			level_count = 0;
+		u64			frame_count = 0;
+		u64			base_count = 0;
+	};
+
+	static FORCEINLINE u64 get_level_size(const u64 base_count, const u32 level) { return (base_count + (1ull << level) - 1) >> level; }
+
+	static FORCEINLINE int8 quantize(const f32 value) { return static_cast<int8>(std::lround(math::clamp(value, -1.f, 1.f) * 127.f)); }
+
+
+	std::vector<u8> build_peak_pyramid(const wav_info& info) {
+
+		std::vector<f32> samples;
+		decode_to_mono(info, samples);
+		if (samples.empty())
+			return {};
+
+		peak_header header{};
+		header.sample_rate = info.sample_rate;
+		header.frame_count = samples.size();
+		header.base_count = (samples.size() + PEAK_BASE_BUCKET_SIZE - 1) / PEAK_BASE_BUCKET_SIZE;
+		header.level_count = 1;
+		u64 total_peaks = header.base_count;
+		while (get_level_size(header.base_count, header.level_count - 1) > 1) {
+			total_peaks += get_level_size(header.base_count, header.level_count);
+			header.level_count++;
+		}
+
+		std::vector<u8> output(sizeof(peak_header) + total_peaks * sizeof(peak));
+		std::memcpy(output.data(), &header, sizeof(header));
+		peak* level = reinterpret_cast<peak*>(output.data() + sizeof(peak_header));
+
+		for (u64 x = 0; x < header.base_count; x++) {								// level 0 from the samples
+
+			const size_t start = x * PEAK_BASE_BUCKET_SIZE;
+			const size_t end = math::min<size_t>(start + PEAK_BASE_BUCKET_SIZE, samples.size());
+			const auto [min_it, max_it] = std::minmax_element(samples.begin() + start, samples.begin() + end);
+			level[x] = peak{ quantize(*min_it), quantize(*max_it) };
+		}
+
+		for (u32 level_index = 1; level_index < header.level_count; level_index++) {		// every other level from its predecessor
+
+			const u64 previous_size = get_level_size(header.base_count, level_index - 1);
+			peak* next_level = level + previous_size;
+			for (u64 x = 0; x < get_level_size(header.base_count, level_index); x++) {
+
+				const peak& first = level[x * 2];
+				const peak& second = (x * 2 + 1 < previous_size) ? level[x * 2 + 1] : first;
+				next_level[x] = peak{ math::min(first.min, second.min), math::max(first.max, second.max) };
+			}
+			level = next_level;
+		}
+
+		return output;
+	}
+
+
+	peak_view::peak_view(const std::span<const u8> data)
+		: m_data(data) {
+
+		if (data.size() < sizeof(peak_header))
+			return;
+
+		peak_header header{};
+		std::memcpy(&header, data.data(), sizeof(header));
+		if (header.magic != PEAK_MAGIC || header.level_count == 0 || header.level_count > 64)
+			return;
+
+		u64 total_peaks = 0;
+		for (u32 x = 0; x < header.level_count; x++)
+			total_peaks += get_level_size(header.base_count, x);
+		if (data.size() < sizeof(peak_header) + total_peaks * sizeof(peak))
+			return;
+
+		m_sample_rate = header.sample_rate;
+		m_frame_count = header.frame_count;
+		m_base_count = header.base_count;
+		m_level_count = header.level_count;
+	}
+
+
+	std::span<const peak> peak_view::get_level_for_width(const u32 columns) const {
+
+		if (!is_valid())
+			return {};
+
+		const peak* level = reinterpret_cast<const peak*>(m_data.data() + sizeof(peak_header));
+		u32 level_index = 0;
+		while (level_index + 1 < m_level_count && get_level_size(m_base_count, level_index + 1) >= columns) {
+			level += get_level_size(m_base_count, level_index);
+			level_index++;
+		}
+
+		return std::span<const peak>(level, get_level_size(m_base_count, level_index));
+	}
+
+}
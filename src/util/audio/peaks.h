@@ -0,0 +1,46 @@
+#pragma once
+
+#include "util/audio/wav.h"
+
+namespace AT::audio {
+
+	// Min/max of one bucket of samples, quantized to [-127, 127]. One byte alignment, so it can be read straight from a mapping.
+	struct peak {
+		int8						min = 0;
+		int8						max = 0;
+	};
+
+	// Builds the serialized peak pyramid for a clip.
+	// Level 0 holds one peak per [PEAK_BASE_BUCKET_SIZE] frames, every following level merges two buckets of the previous one until a single bucket is left.
+	// @param info A parsed WAV file.
+	// @return The serialized pyramid, empty if [info] contains no frames.
+	std::vector<u8> build_peak_pyramid(const wav_info& info);
+
+
+	// Zero-copy accessor for a serialized peak pyramid (see [build_peak_pyramid()]).
+	class peak_view {
+	public:
+
+		// @param data The serialized pyramid, must stay valid for the lifetime of this view.
+		peak_view(const std::span<const u8> data);
+
+		FORCEINLINE bool is_valid() const { return m_level_count > 0; }
+
+		// Selects the coarsest level that still has at least one bucket per column, so drawing costs O([columns]) regardless of the clip length.
+		// @param columns The number of pixel columns that will be drawn.
+		// @return The peaks of the selected level, empty if the view is invalid.
+		std::span<const peak> get_level_for_width(const u32 columns) const;
+
+		DEFAULT_GETTER_C(u32, sample_rate);
+		DEFAULT_GETTER_C(u64, frame_count);
+
+	private:
+
+		std::span<const u8>			m_data{};
+		u32							m_sample_rate = 0;
+		u32							m_level_count = 0;
+		u64							m_frame_count = 0;
+		u64							m_base_count = 0;				// number of buckets in level 0
+	};
+
+}
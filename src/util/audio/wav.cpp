@@ -0,0 +1,133 @@
+#include "util/pch.h"
+
+#include "util/audio/kernels.h"
+
+#include "wav.h"
+
+namespace AT::audio {
+
+	#define WAVE_FORMAT_EXTENSIBLE			0xFFFE
+
+	static FORCEINLINE u16 read_u16(const u8* data) { return static_cast<u16>(data[0] | (data[1] << 8)); }
+	static FORCEINLINE u32 read_u32(const u8* data) { return static_cast<u32>(data[0]) | (static_cast<u32>(data[1]) << 8) | (static_cast<u32>(data[2]) << 16) | (static_cast<u32>(data[3]) << 24); }
+
+
+	bool parse_wav(const std::span<const u8> file, wav_info& info) {
+
+		info = {};
+		VALIDATE(file.size() >= 12 && std::memcmp(file.data(), "RIFF", 4) == 0 && std::memcmp(file.data() + 8, "WAVE", 4) == 0, return false, "", "Buffer is not a RIFF/WAVE file")
+
+		bool found_format = false;
+		size_t offset = 12;
+		while (offset + 8 <= file.size()) {
+
+			const u8* chunk = file.data() + offset;
+			const u32 chunk_size = read_u32(chunk + 4);
+			const size_t chunk_data = offset + 8;
+			const size_t available = file.size() - chunk_data;
+
+			if (std::memcmp(chunk, "fmt ", 4) == 0) {
+
+				VALIDATE(chunk_size >= 16 && available >= 16, return false, "", "WAV format chunk is too small")
+				u16 format_tag = read_u16(chunk + 8);
+				info.channels = read_u16(chunk + 10);
+				info.sample_rate = read_u32(chunk + 12);
+				info.bits_per_sample = read_u16(chunk + 22);
+				if (format_tag == WAVE_FORMAT_EXTENSIBLE && chunk_size >= 26 && available >= 26)
+					format_tag = read_u16(chunk + 32);					// first two bytes of the sub-format GUID
+
+				info.format = (format_tag == 1) ? sample_format::pcm : (format_tag == 3) ? sample_format::ieee_float : sample_format::unknown;
+				found_format = true;
+
+			} else if (std::memcmp(chunk, "data", 4) == 0) {
+
+				VALIDATE(found_format, return false, "", "WAV data chunk found before format chunk")
+				info.samples = file.subspan(chunk_data, math::min<size_t>(chunk_size, available));		// tolerate truncated files (size not patched after an interrupted write)
+				break;
+			}
+
+			offset = chunk_data + chunk_size + (chunk_size & 1);		// chunks are padded to an even size
+		}
+
+		VALIDATE(found_format && !info.samples.empty(), return false, "", "WAV file has no format or data chunk")
+		VALIDATE(info.channels > 0 && info.sample_rate > 0, return false, "", "WAV file has an invalid format")
+
+		const bool supported = (info.format == sample_format::pcm && (info.bits_per_sample == 8 || info.bits_per_sample == 16 || info.bits_per_sample == 24 || info.bits_per_sample == 32))
+			|| (info.format == sample_format::ieee_float && info.bits_per_sample == 32);
+		VALIDATE(supported, return false, "", "Unsupported WAV sample format [" << static_cast<u16>(info.format) << "] with [" << info.bits_per_sample << "] bits")
+
+		info.frame_count = info.samples.size() / info.get_bytes_per_frame();
+		return true;
+	}
+
+
+	void decode_to_mono(const wav_info& info, std::vector<f32>& output) {
+
+		output.resize(info.frame_count);
+		const u32 bytes_per_sample = info.bits_per_sample / 8;
+		const u32 bytes_per_frame = info.get_bytes_per_frame();
+		const f32 channel_scale = 1.f / static_cast<f32>(info.channels);
+
+		auto read_sample = [&](const u8* data) -> f32 {
+
+			if (info.format == sample_format::ieee_float) {
+				f32 value;
+				std::memcpy(&value, data, sizeof(value));
+				return value;
+			}
+
+			switch (bytes_per_sample) {
+				case 1:  return (static_cast<f32>(data[0]) - 128.f) / 128.f;
+				case 2:  return static_cast<f32>(static_cast<int16>(read_u16(data))) / 32768.f;
+				case 3:  return static_cast<f32>(static_cast<int32>((static_cast<u32>(data[0]) << 8) | (static_cast<u32>(data[1]) << 16) | (static_cast<u32>(data[2]) << 24)) >> 8) / 8388608.f;	// sign-extend through the top byte
+				default: return static_cast<f32>(static_cast<int32>(read_u32(data))) / 2147483648.f;
+			}
+		};
+
+		const u8* frame = info.samples.data();
+		for (u64 x = 0; x < info.frame_count; x++, frame += bytes_per_frame) {
+
+			f32 sum = 0.f;
+			for (u16 channel = 0; channel < info.channels; channel++)
+				sum += read_sample(frame + channel * bytes_per_sample);
+			output[x] = sum * channel_scale;
+		}
+	}
+
+
+
+	std::vector<u8> encode_wav(const std::span<const f32> samples, const u32 sample_rate, const sample_format format) {
+
+		const u16 bytes_per_sample = (format == sample_format::pcm) ? sizeof(int16) : sizeof(f32);
+		const u32 data_size = static_cast<u32>(samples.size() * bytes_per_sample);
+		std::vector<u8> output(44 + data_size);
+		u8* header = output.data();
+
+		auto write_u16 = [](u8* target, const u16 value) { target[0] = value & 0xFF; target[1] = (value >> 8) & 0xFF; };
+		auto write_u32 = [](u8* target, const u32 value) { for (u32 x = 0; x < 4; x++) target[x] = (value >> (8 * x)) & 0xFF; };
+
+		std::memcpy(header, "RIFF", 4);
+		write_u32(header + 4, 36 + data_size);
+		std::memcpy(header + 8, "WAVE", 4);
+		std::memcpy(header + 12, "fmt ", 4);
+		write_u32(header + 16, 16);
+		write_u16(header + 20, static_cast<u16>(format == sample_format::pcm ? sample_format::pcm : sample_format::ieee_float));
+		write_u16(header + 22, 1);										// channels
+		write_u32(header + 24, sample_rate);
+		write_u32(header + 28, sample_rate * bytes_per_sample);			// byte rate
+		write_u16(header + 32, bytes_per_sample);						// block align
+		write_u16(header + 34, bytes_per_sample * 8);					// bits per sample
+		std::memcpy(header + 36, "data", 4);
+		write_u32(header + 40, data_size);
+
+		// little-endian host assumed, like the rest of the binary formats
+		if (format == sample_format::pcm) {
+
+			dither_state dither{};
+			float_to_int16_dither(samples, std::span<int16>(reinterpret_cast<int16*>(output.data() + 44), samples.size()), dither);
+		} else
+			std::memcpy(output.data() + 44, samples.data(), data_size);
+		return output;
+	}
+
+}
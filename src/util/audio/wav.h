@@ -0,0 +1,44 @@
+#pragma once
+
+
+namespace AT::audio {
+
+	// Sample encodings found in the "fmt " chunk of a WAV file
+	enum class sample_format : u16 {
+		unknown = 0,
+		pcm = 1,					// signed integer samples (8 bit are unsigned)
+		ieee_float = 3,				// 32 bit float samples
+	};
+
+	// Description of a parsed WAV file. [samples] points into the buffer that was passed to [parse_wav()], nothing is copied.
+	struct wav_info {
+		sample_format				format = sample_format::unknown;
+		u16							channels = 0;
+		u32							sample_rate = 0;
+		u16							bits_per_sample = 0;
+		u64							frame_count = 0;				// samples per channel
+		std::span<const u8>			samples{};						// interleaved sample data of the "data" chunk
+
+		FORCEINLINE u32 get_bytes_per_frame() const { return static_cast<u32>(channels) * (bits_per_sample / 8); }
+	};
+
+	// Parses the RIFF/WAVE container in [file] and locates the format and data chunk.
+	// Supports PCM (8/16/24/32 bit) and 32 bit float, which covers everything libsndfile writes for the TTS output.
+	// @param file The complete WAV file.
+	// @param info Receives the description, [info.samples] points into [file].
+	// @return true if the file is a supported WAV file, false otherwise.
+	bool parse_wav(const std::span<const u8> file, wav_info& info);
+
+	// Decodes all frames of [info] into mono float samples in the range [-1, 1], multiple channels are averaged.
+	// @param info A description returned by [parse_wav()].
+	// @param output Receives [info.frame_count] samples.
+	void decode_to_mono(const wav_info& info, std::vector<f32>& output);
+
+	// Encodes mono float samples as a WAV file.
+	// @param samples The samples to encode.
+	// @param sample_rate The sample rate written into the header.
+	// @param format [ieee_float] stores 32 bit floats, [pcm] stores 16 bit integers with TPDF dither.
+	// @return The complete WAV file.
+	std::vector<u8> encode_wav(const std::span<const f32> samples, const u32 sample_rate, const sample_format format = sample_format::ieee_float);
+
+}
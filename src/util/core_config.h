@@ -11,6 +11,9 @@
 // collect timing-data from every major function?
 #define PROFILE								    0	// general
 
+// time PROFILE_SCOPE()s in memory for the performance overlay (F3), costs one atomic load per scope while the overlay is closed
+#define PROFILE_LIVE						    1
+
 // log assert and validation behaviour?
 // NOTE - expr in assert/validation will still be executed
 #define ENABLE_LOGGING_FOR_ASSERTS              1
@@ -24,6 +27,9 @@
 #define PROJECT_EXTENTION    		".atproj"
 #define PROJECT_EXTENTION_SELECTOR  "*.atproj"
 
+// Extension for the per-project audio archive
+#define AUDIO_PACK_EXTENTION		".atpack"
+
 // Configuration file extensions
 #define FILE_EXTENSION_CONFIG   	".yml"        	// Extension for YAML config files
 #define FILE_EXTENSION_INI      	".ini"          // Extension for INI config files
@@ -36,6 +42,7 @@
 #define CONFIG_DIR              	"config"        // Directory for configuration files
 #define CONTENT_DIR             	"content"       // Directory for content files
 #define ASSET_DIR             	    "assets"        // Directory for asset files
+#define ASSET_PACK_FILE         	"assets.pack"   // Asset bundle written by [scripts/pack_assets.py], next to the executable
 #define SOURCE_DIR              	"src"           // Directory for source code
 
 #define PROJECT_PATH				application::get().get_project_path()
@@ -72,6 +72,7 @@ namespace AT::crash_handler {
 			}
 		}
 		LOG(Trace, "User functions have been executed");
+		logger::flush();					// the process exits without [logger::shutdown()], write out everything logged until now
 	}
 
 
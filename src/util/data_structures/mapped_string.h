@@ -0,0 +1,77 @@
+#pragma once
+
+
+namespace AT::util {
+
+    // Text that can start out as a read-only view into memory owned by someone else (e.g. a memory-mapped project file)
+    // and copies itself into an owned string on the first write access (copy-on-write).
+    // Copies share the owned string until one of them is written to, so copying a whole project for a background save
+    // costs a reference count per string instead of the text.
+    // Reading through [view()] never copies. Whoever owns the viewed memory has to keep it alive as long as the view is used,
+    // or call [detach()] before releasing it.
+    class mapped_string {
+    public:
+
+        mapped_string() = default;
+        mapped_string(std::string text)
+            : m_text(std::make_shared<std::string>(std::move(text))) {}
+
+        mapped_string& operator=(std::string text) {
+
+            m_text = std::make_shared<std::string>(std::move(text));
+            m_view = {};
+            return *this;
+        }
+
+        // Creates a string that views [view] without copying it.
+        // @param view Memory that outlives the returned string (or its [detach()] call).
+        static mapped_string from_view(const std::string_view view) {
+
+            mapped_string result;
+            if (!view.empty())
+                result.m_view = view;
+            return result;
+        }
+
+        // @return The text, valid until the next write access to this string.
+        FORCEINLINE std::string_view view() const { return is_view() ? m_view : (m_text ? std::string_view(*m_text) : std::string_view()); }
+
+        FORCEINLINE size_t size() const { return view().size(); }
+
+        FORCEINLINE bool empty() const { return view().empty(); }
+
+        // @return true while the text still points into foreign memory.
+        FORCEINLINE bool is_view() const { return m_view.data() != nullptr; }
+
+        // Copies viewed text into an owned string, afterwards the foreign memory is no longer referenced.
+        void detach() {
+
+            if (!is_view())
+                return;
+
+            m_text = std::make_shared<std::string>(m_view);
+            m_view = {};
+        }
+
+        // @return The owned string for modification, copying the text first if it is viewed or shared with a copy.
+        std::string& edit() {
+
+            if (is_view())
+                detach();
+            else if (!m_text)
+                m_text = std::make_shared<std::string>();
+            else if (m_text.use_count() > 1)
+                m_text = std::make_shared<std::string>(*m_text);
+            else
+                std::atomic_thread_fence(std::memory_order_acquire);    // a copy released on another thread is done reading before we write
+
+            return *m_text;
+        }
+
+    private:
+
+        std::shared_ptr<std::string> m_text{};                  // never modified while shared, see [edit()]
+        std::string_view            m_view{};                   // points into foreign memory if [data()] is set
+    };
+
+}
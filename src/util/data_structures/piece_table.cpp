@@ -0,0 +1,422 @@
+#include "util/pch.h"
+
+#include "piece_table.h"
+
+namespace AT::util {
+
+    static void collect_newlines(const std::string_view text, const u32 base, std::vector<u32>& offsets) {
+
+        for (const char* cursor = text.data(), *end = text.data() + text.size(); (cursor = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor))); cursor++)
+            offsets.push_back(base + static_cast<u32>(cursor - text.data()));
+    }
+
+
+    piece_table::piece_table(std::string original)
+        : m_original(std::move(original)) {
+
+        ASSERT(m_original.size() < std::numeric_limits<u32>::max(), "", "Document exceeds 4 GiB")
+
+        m_nodes.push_back(node{});                                          // sentinel
+        collect_newlines(m_original, 0, m_newline_offsets[0]);
+        if (!m_original.empty())
+            m_root = create_node(piece{ 0, static_cast<u32>(m_original.size()), static_cast<u32>(m_newline_offsets[0].size()), 0 }, 0);
+    }
+
+    // ------------------------------------------------------------------------------------------------------------------
+    // editing
+    // ------------------------------------------------------------------------------------------------------------------
+
+    void piece_table::insert(size_t offset, const std::string_view text) {
+
+        if (text.empty())
+            return;
+
+        offset = math::min(offset, size());
+        record(true, offset, text);
+        apply_insert(offset, text);
+    }
+
+
+    void piece_table::erase(size_t offset, size_t length) {
+
+        offset = math::min(offset, size());
+        length = math::min(length, size() - offset);
+        if (length == 0)
+            return;
+
+        record(false, offset, substr(offset, length));
+        apply_erase(offset, length);
+    }
+
+
+    bool piece_table::undo(size_t& cursor) {
+
+        if (m_undo_stack.empty())
+            return false;
+
+        edit step = std::move(m_undo_stack.back());
+        m_undo_stack.pop_back();
+        if (step.insertion) {
+            apply_erase(step.offset, step.text.size());
+            cursor = step.offset;
+        } else {
+            apply_insert(step.offset, step.text);
+            cursor = step.offset + step.text.size();
+        }
+        m_redo_stack.push_back(std::move(step));
+        m_undo_group_open = false;
+        return true;
+    }
+
+
+    bool piece_table::redo(size_t& cursor) {
+
+        if (m_redo_stack.empty())
+            return false;
+
+        edit step = std::move(m_redo_stack.back());
+        m_redo_stack.pop_back();
+        if (step.insertion) {
+            apply_insert(step.offset, step.text);
+            cursor = step.offset + step.text.size();
+        } else {
+            apply_erase(step.offset, step.text.size());
+            cursor = step.offset;
+        }
+        m_undo_stack.push_back(std::move(step));
+        m_undo_group_open = false;
+        return true;
+    }
+
+
+    void piece_table::break_undo_group() { m_undo_group_open = false; }
+
+
+    void piece_table::record(const bool insertion, const size_t offset, const std::string_view text) {
+
+        m_redo_stack.clear();
+        const bool single_line = text.find('\n') == std::string_view::npos;
+        if (m_undo_group_open && single_line && !m_undo_stack.empty()) {
+
+            edit& top = m_undo_stack.back();
+            if (insertion && top.insertion && top.offset + top.text.size() == offset) {            // typing
+                top.text.append(text);
+                return;
+            }
+            if (!insertion && !top.insertion && offset + text.size() == top.offset) {              // backspace
+                top.text.insert(0, text);
+                top.offset = offset;
+                return;
+            }
+            if (!insertion && !top.insertion && offset == top.offset) {                            // delete
+                top.text.append(text);
+                return;
+            }
+        }
+
+        m_undo_stack.push_back(edit{ insertion, offset, std::string(text) });
+        m_undo_group_open = single_line;                                                            // line breaks and pastes are their own step
+    }
+
+
+    void piece_table::apply_insert(const size_t offset, const std::string_view text) {
+
+        ASSERT(m_added.size() + text.size() < std::numeric_limits<u32>::max(), "", "Added text exceeds 4 GiB")
+
+        const u32 start = static_cast<u32>(m_added.size());
+        const size_t previous_newlines = m_newline_offsets[1].size();
+        m_added.append(text);
+        collect_newlines(text, start, m_newline_offsets[1]);
+        const u32 newlines = static_cast<u32>(m_newline_offsets[1].size() - previous_newlines);
+
+        u32 left, right;
+        split(m_root, offset, left, right);
+        if (!extend_last_piece(left, start, static_cast<u32>(text.size()), newlines))               // typing appends to the piece of the previous keystroke
+            left = merge(left, create_node(piece{ start, static_cast<u32>(text.size()), newlines, 1 }, 0));
+        m_root = merge(left, right);
+        m_revision++;
+    }
+
+
+    void piece_table::apply_erase(const size_t offset, const size_t length) {
+
+        u32 left, middle, right;
+        split(m_root, offset, left, middle);
+        split(middle, length, middle, right);
+        free_subtree(middle);
+        m_root = merge(left, right);
+        m_revision++;
+    }
+
+    // ------------------------------------------------------------------------------------------------------------------
+    // queries
+    // ------------------------------------------------------------------------------------------------------------------
+
+    size_t piece_table::size() const { return m_nodes[m_root].subtree_length; }
+
+
+    size_t piece_table::line_count() const { return m_nodes[m_root].subtree_newlines + 1; }
+
+
+    size_t piece_table::line_start(const size_t line) const {
+
+        if (line == 0)
+            return 0;
+        if (line >= line_count())
+            return size();
+        return find_newline(line - 1) + 1;
+    }
+
+
+    size_t piece_table::line_end(const size_t line) const {
+
+        if (line + 1 >= line_count())
+            return size();
+        return find_newline(line);
+    }
+
+
+    size_t piece_table::line_of(size_t offset) const {
+
+        size_t line = 0;
+        u32 index = m_root;
+        while (index) {
+
+            const node& current = m_nodes[index];
+            const size_t left_length = m_nodes[current.left].subtree_length;
+            if (offset < left_length) {
+                index = current.left;
+                continue;
+            }
+
+            line += m_nodes[current.left].subtree_newlines;
+            offset -= left_length;
+            if (offset <= current.value.length)
+                return line + count_newlines(current.value.buffer, current.value.start, static_cast<u32>(offset));
+
+            line += current.value.newlines;
+            offset -= current.value.length;
+            index = current.right;
+        }
+        return line;
+    }
+
+
+    char piece_table::at(size_t offset) const {
+
+        u32 index = m_root;
+        while (index) {
+
+            const node& current = m_nodes[index];
+            const size_t left_length = m_nodes[current.left].subtree_length;
+            if (offset < left_length) {
+                index = current.left;
+                continue;
+            }
+
+            offset -= left_length;
+            if (offset < current.value.length)
+                return get_buffer(current.value.buffer)[current.value.start + offset];
+
+            offset -= current.value.length;
+            index = current.right;
+        }
+        return '\0';
+    }
+
+
+    std::string piece_table::substr(const size_t offset, const size_t length) const {
+
+        std::string result;
+        result.reserve(math::min(length, size() - math::min(offset, size())));
+        for_each_chunk(offset, length, [&result](const std::string_view chunk) { result.append(chunk); });
+        return result;
+    }
+
+
+    std::string piece_table::to_string() const { return substr(0, size()); }
+
+    // ------------------------------------------------------------------------------------------------------------------
+    // tree
+    // ------------------------------------------------------------------------------------------------------------------
+
+    u32 piece_table::create_node(const piece& value, u32 priority) {
+
+        if (priority == 0) {                                                                        // xorshift32
+            m_random_state ^= m_random_state << 13;
+            m_random_state ^= m_random_state >> 17;
+            m_random_state ^= m_random_state << 5;
+            priority = m_random_state;
+        }
+
+        u32 index;
+        if (!m_free_nodes.empty()) {
+            index = m_free_nodes.back();
+            m_free_nodes.pop_back();
+        } else {
+            index = static_cast<u32>(m_nodes.size());
+            m_nodes.emplace_back();
+        }
+
+        m_nodes[index] = node{ value, 0, 0, priority, value.length, value.newlines };
+        return index;
+    }
+
+
+    void piece_table::free_subtree(const u32 index) {
+
+        if (!index)
+            return;
+
+        free_subtree(m_nodes[index].left);
+        free_subtree(m_nodes[index].right);
+        m_free_nodes.push_back(index);
+    }
+
+
+    void piece_table::update(const u32 index) {
+
+        node& current = m_nodes[index];
+        current.subtree_length = m_nodes[current.left].subtree_length + current.value.length + m_nodes[current.right].subtree_length;
+        current.subtree_newlines = m_nodes[current.left].subtree_newlines + current.value.newlines + m_nodes[current.right].subtree_newlines;
+    }
+
+
+    // Splits the tree at [index] into the first [offset] bytes and the rest, cutting a piece in two if the offset falls inside it
+    void piece_table::split(const u32 index, const size_t offset, u32& left, u32& right) {
+
+        if (!index) {
+            left = right = 0;
+            return;
+        }
+
+        // copy the fields, creating a node in the recursion may reallocate [m_nodes]
+        const u32 left_child = m_nodes[index].left;
+        const u32 right_child = m_nodes[index].right;
+        const size_t left_length = m_nodes[left_child].subtree_length;
+        const piece value = m_nodes[index].value;
+
+        if (offset <= left_length) {
+
+            u32 inner_left, inner_right;
+            split(left_child, offset, inner_left, inner_right);
+            m_nodes[index].left = inner_right;
+            update(index);
+            left = inner_left;
+            right = index;
+
+        } else if (offset >= left_length + value.length) {
+
+            u32 inner_left, inner_right;
+            split(right_child, offset - left_length - value.length, inner_left, inner_right);
+            m_nodes[index].right = inner_left;
+            update(index);
+            left = index;
+            right = inner_right;
+
+        } else {
+
+            const u32 local = static_cast<u32>(offset - left_length);
+            const u32 head_newlines = count_newlines(value.buffer, value.start, local);
+            const piece tail{ value.start + local, value.length - local, value.newlines - head_newlines, value.buffer };
+            const u32 tail_index = create_node(tail, m_nodes[index].priority);                    // same priority keeps the heap order above [right_child]
+
+            m_nodes[index].value.length = local;
+            m_nodes[index].value.newlines = head_newlines;
+            m_nodes[index].right = 0;
+            update(index);
+
+            m_nodes[tail_index].right = right_child;
+            update(tail_index);
+
+            left = index;
+            right = tail_index;
+        }
+    }
+
+
+    u32 piece_table::merge(const u32 left, const u32 right) {
+
+        if (!left)
+            return right;
+        if (!right)
+            return left;
+
+        if (m_nodes[left].priority > m_nodes[right].priority) {
+            const u32 merged = merge(m_nodes[left].right, right);
+            m_nodes[left].right = merged;
+            update(left);
+            return left;
+        }
+
+        const u32 merged = merge(left, m_nodes[right].left);
+        m_nodes[right].left = merged;
+        update(right);
+        return right;
+    }
+
+
+    // If the last piece of the tree at [root] ends exactly where the new text starts in [m_added], grow it instead of adding a node
+    bool piece_table::extend_last_piece(const u32 root, const u32 added_start, const u32 added_length, const u32 added_newlines) {
+
+        if (!root)
+            return false;
+
+        u32 last = root;
+        while (m_nodes[last].right)
+            last = m_nodes[last].right;
+
+        const piece& value = m_nodes[last].value;
+        if (value.buffer != 1 || value.start + value.length != added_start)
+            return false;
+
+        m_nodes[last].value.length += added_length;
+        m_nodes[last].value.newlines += added_newlines;
+        for (u32 index = root; index; index = m_nodes[index].right) {                              // every node on the right spine contains [last]
+            m_nodes[index].subtree_length += added_length;
+            m_nodes[index].subtree_newlines += added_newlines;
+        }
+        return true;
+    }
+
+
+    u32 piece_table::count_newlines(const u8 buffer, const u32 start, const u32 length) const {
+
+        const std::vector<u32>& offsets = m_newline_offsets[buffer];
+        const auto first = std::lower_bound(offsets.begin(), offsets.end(), start);
+        const auto last = std::lower_bound(first, offsets.end(), start + length);
+        return static_cast<u32>(last - first);
+    }
+
+
+    // Document offset of the '\n' with index [newline_index]
+    size_t piece_table::find_newline(size_t newline_index) const {
+
+        size_t base = 0;
+        u32 index = m_root;
+        while (index) {
+
+            const node& current = m_nodes[index];
+            const size_t left_newlines = m_nodes[current.left].subtree_newlines;
+            if (newline_index < left_newlines) {
+                index = current.left;
+                continue;
+            }
+
+            newline_index -= left_newlines;
+            base += m_nodes[current.left].subtree_length;
+            if (newline_index < current.value.newlines) {
+
+                const std::vector<u32>& offsets = m_newline_offsets[current.value.buffer];
+                const auto first = std::lower_bound(offsets.begin(), offsets.end(), current.value.start);
+                return base + (*(first + newline_index) - current.value.start);
+            }
+
+            newline_index -= current.value.newlines;
+            base += current.value.length;
+            index = current.right;
+        }
+        return size();
+    }
+
+}
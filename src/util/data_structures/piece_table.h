@@ -0,0 +1,148 @@
+#pragma once
+
+
+namespace AT::util {
+
+    // @brief Text buffer for large documents. The text is described by pieces that point into the immutable original
+    //        text or an append-only buffer of inserted text. The pieces live in a treap ordered by document position,
+    //        every node caches the byte length and newline count of its subtree. This makes insert, erase,
+    //        offset <-> line lookups O(log n) in the number of pieces, and O(edit size) in the text itself.
+    //        Edits are recorded for undo/redo, consecutive typing and deleting is merged into one undo step.
+    class piece_table {
+    public:
+
+        piece_table(std::string original = {});
+
+        DELETE_COPY_MOVE_CONSTRUCTOR(piece_table);
+
+        // @brief Inserts [text] before the byte at [offset] (clamped to [size()]).
+        void insert(size_t offset, const std::string_view text);
+
+        // @brief Removes [length] bytes starting at [offset], the range is clamped to the document.
+        void erase(size_t offset, size_t length);
+
+        // @brief Reverts the last undo step.
+        // @param [cursor] Receives the cursor position after the reverted edit.
+        // @return true if there was something to undo.
+        bool undo(size_t& cursor);
+
+        // @brief Re-applies the last undone step.
+        // @param [cursor] Receives the cursor position after the re-applied edit.
+        // @return true if there was something to redo.
+        bool redo(size_t& cursor);
+
+        // @brief The next edit starts a new undo step, call on cursor jumps so they are not merged with previous typing.
+        void break_undo_group();
+
+        FORCEINLINE bool can_undo() const { return !m_undo_stack.empty(); }
+        FORCEINLINE bool can_redo() const { return !m_redo_stack.empty(); }
+
+        // @return Length of the document in bytes.
+        size_t size() const;
+
+        // @return Number of lines, one more than the number of '\n'.
+        size_t line_count() const;
+
+        // @return Byte offset of the first character of [line].
+        size_t line_start(const size_t line) const;
+
+        // @return Byte offset of the '\n' that ends [line], or [size()] for the last line.
+        size_t line_end(const size_t line) const;
+
+        // @return Line that contains the byte at [offset].
+        size_t line_of(const size_t offset) const;
+
+        // @return The byte at [offset], must be smaller than [size()].
+        char at(const size_t offset) const;
+
+        std::string substr(const size_t offset, const size_t length) const;
+        std::string to_string() const;
+
+        // @brief Calls [func] with a string_view for every piece that overlaps [offset, offset + length), in document order.
+        //        The views are only valid until the next edit.
+        template<typename F>
+        void for_each_chunk(const size_t offset, const size_t length, F&& func) const {
+
+            const size_t end = math::min(offset + length, size());
+            if (offset < end)
+                visit_chunks(m_root, 0, offset, end, func);
+        }
+
+        // @return Incremented on every change of the text, usable as a cache key.
+        DEFAULT_GETTER_C(u64, revision);
+
+    private:
+
+        struct piece {
+            u32                     start = 0;          // offset in the buffer
+            u32                     length = 0;
+            u32                     newlines = 0;       // number of '\n' in this piece
+            u8                      buffer = 0;         // 0: original, 1: added
+        };
+
+        struct node {
+            piece                   value{};
+            u32                     left = 0;           // 0 = no child, node 0 is an empty sentinel
+            u32                     right = 0;
+            u32                     priority = 0;
+            size_t                  subtree_length = 0;
+            size_t                  subtree_newlines = 0;
+        };
+
+        struct edit {
+            bool                    insertion = true;
+            size_t                  offset = 0;
+            std::string             text{};
+        };
+
+        // tree
+        u32 create_node(const piece& value, const u32 priority);
+        void free_subtree(const u32 index);
+        void update(const u32 index);
+        void split(const u32 index, const size_t offset, u32& left, u32& right);
+        u32 merge(const u32 left, const u32 right);
+        bool extend_last_piece(const u32 root, const u32 added_start, const u32 added_length, const u32 added_newlines);
+        u32 count_newlines(const u8 buffer, const u32 start, const u32 length) const;
+        size_t find_newline(size_t newline_index) const;
+
+        // edits without undo bookkeeping
+        void apply_insert(const size_t offset, const std::string_view text);
+        void apply_erase(const size_t offset, const size_t length);
+        void record(const bool insertion, const size_t offset, const std::string_view text);
+
+        FORCEINLINE const std::string& get_buffer(const u8 buffer) const { return buffer ? m_added : m_original; }
+
+        template<typename F>
+        void visit_chunks(const u32 index, const size_t base, const size_t offset, const size_t end, F& func) const {
+
+            if (!index)
+                return;
+
+            const node& current = m_nodes[index];
+            if (base >= end || base + current.subtree_length <= offset)
+                return;
+
+            visit_chunks(current.left, base, offset, end, func);
+            const size_t piece_begin = base + m_nodes[current.left].subtree_length;
+            const size_t piece_end = piece_begin + current.value.length;
+            const size_t first = math::max(piece_begin, offset);
+            const size_t last = math::min(piece_end, end);
+            if (first < last)
+                func(std::string_view(get_buffer(current.value.buffer)).substr(current.value.start + (first - piece_begin), last - first));
+            visit_chunks(current.right, piece_end, offset, end, func);
+        }
+
+        const std::string                   m_original;
+        std::string                         m_added{};
+        std::vector<u32>                    m_newline_offsets[2]{};         // sorted offsets of every '\n' in [m_original] and [m_added]
+        std::vector<node>                   m_nodes{};
+        std::vector<u32>                    m_free_nodes{};
+        u32                                 m_root = 0;
+        u32                                 m_random_state = 0x9E3779B9;    // xorshift state for treap priorities
+        u64                                 m_revision = 0;
+        std::vector<edit>                   m_undo_stack{};
+        std::vector<edit>                   m_redo_stack{};
+        bool                                m_undo_group_open = false;      // next edit may merge into the top of [m_undo_stack]
+    };
+
+}
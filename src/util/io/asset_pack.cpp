@@ -0,0 +1,155 @@
+#include "util/pch.h"
+
+#include <stb_image.h>				// zlib inflate, the implementation is compiled in [render/image.cpp]
+
+#include "util/io/io.h"
+
+#include "asset_pack.h"
+
+namespace AT::io {
+
+	#define ASSET_PACK_MAGIC					0x4B505441u				// "ATPK"
+	#define ASSET_PACK_VERSION					1u
+	#define ASSET_PACK_FLAG_COMPRESSED			1u
+
+	// On-disk structures, must match [scripts/pack_assets.py]
+	struct pack_header {
+		u32			magic;
+		u32			version;
+		u32			entry_count;
+		u32			name_table_size;
+	};
+
+	struct pack_entry {
+		u64			offset;
+		u64			stored_size;
+		u64			size;
+		u64			content_hash;
+		u32			name_offset;
+		u32			name_length;
+		u32			flags;
+		u32			reserved;
+	};
+	static_assert(sizeof(pack_header) == 16 && sizeof(pack_entry) == 48, "asset pack structures must not be padded");
+
+
+	asset_pack::asset_pack(const std::filesystem::path& file, const std::filesystem::path& root)
+		: m_root(root.lexically_normal()) {
+
+		PROFILE_FUNCTION();
+
+		if (!std::filesystem::exists(file)) {
+			LOG(Info, "No asset pack at [" << file.generic_string() << "], loading assets from disk")
+			return;
+		}
+
+		m_file = create_ref<mapped_file>(file);
+		VALIDATE(m_file->is_valid() && m_file->size() >= sizeof(pack_header), return, "", "Could not map asset pack [" << file.generic_string() << "]")
+
+		pack_header header{};
+		std::memcpy(&header, m_file->data(), sizeof(header));
+		VALIDATE(header.magic == ASSET_PACK_MAGIC && header.version == ASSET_PACK_VERSION, return, "", "Asset pack [" << file.generic_string() << "] has an unknown format")
+
+		const auto entries = m_file->slice(sizeof(pack_header), static_cast<size_t>(header.entry_count) * sizeof(pack_entry));
+		const auto names = m_file->slice(sizeof(pack_header) + entries.size(), header.name_table_size);
+		VALIDATE(entries.size() == static_cast<size_t>(header.entry_count) * sizeof(pack_entry) && names.size() == header.name_table_size, return, "", "Asset pack index is truncated")
+
+		m_entries.reserve(header.entry_count);
+		for (u32 x = 0; x < header.entry_count; x++) {
+
+			pack_entry packed{};
+			std::memcpy(&packed, entries.data() + x * sizeof(pack_entry), sizeof(packed));
+			const bool compressed = (packed.flags & ASSET_PACK_FLAG_COMPRESSED) != 0;
+			const bool consistent = static_cast<u64>(packed.name_offset) + packed.name_length <= names.size()
+				&& m_file->slice(packed.offset, packed.stored_size).size() == packed.stored_size
+				&& (compressed || packed.stored_size == packed.size);
+			VALIDATE(consistent, m_entries.clear(); return, "", "Asset pack entry [" << x << "] is out of bounds")
+
+			const std::string name(reinterpret_cast<const char*>(names.data()) + packed.name_offset, packed.name_length);
+			m_entries[name] = entry{ packed.offset, packed.stored_size, packed.size, packed.content_hash, compressed };
+		}
+
+		m_valid = true;
+		LOG(Trace, "Mapped asset pack [" << file.generic_string() << "] with [" << m_entries.size() << "] entries")
+	}
+
+
+	bool asset_pack::contains(const std::filesystem::path& path) const { return find(path) != nullptr; }
+
+
+	std::span<const u8> asset_pack::view(const std::filesystem::path& path) const {
+
+		const entry* found = find(path);
+		if (!found || found->compressed)
+			return {};
+
+		return m_file->slice(found->offset, found->stored_size);
+	}
+
+
+	bool asset_pack::read(const std::filesystem::path& path, std::vector<u8>& data) const {
+
+		const entry* found = find(path);
+		if (!found)
+			return false;
+
+		const auto stored = m_file->slice(found->offset, found->stored_size);
+		if (!found->compressed) {
+			data.assign(stored.begin(), stored.end());
+			return true;
+		}
+
+		VALIDATE(found->size <= INT32_MAX && stored.size() <= INT32_MAX, return false, "", "Asset [" << path.generic_string() << "] is too large to inflate")
+		data.resize(found->size);
+		const int inflated = stbi_zlib_decode_buffer(reinterpret_cast<char*>(data.data()), static_cast<int>(data.size()), reinterpret_cast<const char*>(stored.data()), static_cast<int>(stored.size()));
+		VALIDATE(inflated == static_cast<int>(found->size), data.clear(); return false, "", "Could not inflate asset [" << path.generic_string() << "]")
+		return true;
+	}
+
+
+	u64 asset_pack::get_content_hash(const std::filesystem::path& path) const {
+
+		const entry* found = find(path);
+		return found ? found->content_hash : 0;
+	}
+
+
+	u32 asset_pack::extract_missing(const std::filesystem::path& directory) const {
+
+		if (!m_valid)
+			return 0;
+
+		const std::string prefix = directory.lexically_normal().lexically_relative(m_root).generic_string() + "/";
+		u32 count = 0;
+		std::vector<u8> data;
+		for (const auto& [name, packed] : m_entries) {
+
+			if (name.compare(0, prefix.size(), prefix) != 0)
+				continue;
+
+			const std::filesystem::path target = m_root / name;
+			if (std::filesystem::exists(target) || !read(target, data))
+				continue;
+
+			io::create_directory(target.parent_path());
+			std::ofstream stream(target, std::ios::binary);
+			stream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+			VALIDATE(stream.good(), continue, "", "Could not write default file [" << target.generic_string() << "]")
+			LOG(Trace, "Restored [" << name << "] from the asset pack")
+			count++;
+		}
+		return count;
+	}
+
+
+	const asset_pack::entry* asset_pack::find(const std::filesystem::path& path) const {
+
+		if (!m_valid)
+			return nullptr;
+
+		const std::string name = path.lexically_normal().lexically_relative(m_root).generic_string();
+		const auto it = m_entries.find(name);
+		return (it != m_entries.end()) ? &it->second : nullptr;
+	}
+
+}
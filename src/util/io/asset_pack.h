@@ -0,0 +1,66 @@
+#pragma once
+
+#include "util/io/mapped_file.h"
+
+
+namespace AT::io {
+
+	// Read-only view of the asset bundle written by [scripts/pack_assets.py] at build time.
+	// The bundle holds fonts, icons and default configs in one file that is mapped once at startup, the directory index
+	// is parsed from the mapping. Entries are addressed by their path on disk: a path below [root] is looked up by its
+	// relative name, so callers can try the pack first and fall back to the loose file with the same path.
+	// Uncompressed entries (e.g. PNGs) are returned as zero-copy views, compressed ones (zlib) are inflated on read.
+	// All accessors are const and thread-safe.
+	class asset_pack {
+	public:
+
+		DELETE_COPY_MOVE_CONSTRUCTOR(asset_pack);
+
+		// Maps the pack and reads its index. Check [is_valid()] afterwards, a missing or damaged pack is not an error.
+		// @param file The pack file.
+		// @param root The directory the packed names are relative to (the directory the loose assets are copied to).
+		asset_pack(const std::filesystem::path& file, const std::filesystem::path& root);
+
+		// @return true if the pack was mapped and its index is consistent.
+		FORCEINLINE bool is_valid() const { return m_valid; }
+
+		// @return true if the pack contains the file at [path].
+		bool contains(const std::filesystem::path& path) const;
+
+		// Returns the stored bytes of an uncompressed entry without copying.
+		// @return The content of the entry, or an empty span if it is missing or compressed (use [read()] then).
+		std::span<const u8> view(const std::filesystem::path& path) const;
+
+		// Copies (and inflates if needed) the content of an entry.
+		// @param path The file to read.
+		// @param data Receives the content on success.
+		// @return true on success, false if the entry is missing or could not be inflated.
+		bool read(const std::filesystem::path& path, std::vector<u8>& data) const;
+
+		// @return The FNV-1a hash of the uncompressed content, 0 if [path] is not packed. Stable while the content does not change.
+		u64 get_content_hash(const std::filesystem::path& path) const;
+
+		// Writes every packed file below [directory] that does not exist on disk yet, used to restore default configs.
+		// @param directory Must be below [root].
+		// @return The number of files written.
+		u32 extract_missing(const std::filesystem::path& directory) const;
+
+	private:
+
+		struct entry {
+			u64							offset = 0;
+			u64							stored_size = 0;
+			u64							size = 0;				// uncompressed
+			u64							content_hash = 0;
+			bool						compressed = false;
+		};
+
+		const entry* find(const std::filesystem::path& path) const;
+
+		std::filesystem::path						m_root{};
+		ref<mapped_file>							m_file{};
+		std::unordered_map<std::string, entry>		m_entries{};		// by name relative to [m_root]
+		bool										m_valid = false;
+	};
+
+}
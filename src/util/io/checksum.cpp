@@ -0,0 +1,32 @@
+#include "util/pch.h"
+
+#include "checksum.h"
+
+namespace AT::io {
+
+	u64 compute_checksum(const std::span<const u8> data, u64 hash) {
+
+		constexpr u64 prime = 0x100000001b3;
+		u64 lanes[4] = { hash, hash ^ 0x9e3779b97f4a7c15, hash ^ 0xc2b2ae3d27d4eb4f, hash ^ 0x165667b19e3779f9 };
+		size_t x = 0;
+		for (; x + 32 <= data.size(); x += 32) {
+
+			u64 words[4];
+			std::memcpy(words, data.data() + x, sizeof(words));
+			for (u32 lane = 0; lane < 4; lane++) {
+				lanes[lane] = (lanes[lane] ^ words[lane]) * prime;
+				lanes[lane] ^= lanes[lane] >> 29;
+			}
+		}
+
+		hash = lanes[0];
+		for (u32 lane = 1; lane < 4; lane++)
+			hash = (hash ^ lanes[lane]) * prime;
+
+		for (; x < data.size(); x++)
+			hash = (hash ^ data[x]) * prime;
+
+		return (hash ^ data.size()) * prime;
+	}
+
+}
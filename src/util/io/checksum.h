@@ -0,0 +1,13 @@
+#pragma once
+
+
+namespace AT::io {
+
+	// Word-wise FNV-1a variant for detecting damaged files (project files, edit journals). Not a cryptographic hash.
+	// Hashes 8-byte words in four independent lanes, byte-wise FNV over a 50 MB script costs more than reading it.
+	// @param data The bytes to hash.
+	// @param hash Seed, pass the result of a previous call to hash several buffers as one.
+	// @return The checksum of [data].
+	u64 compute_checksum(const std::span<const u8> data, u64 hash = 0xcbf29ce484222325);
+
+}
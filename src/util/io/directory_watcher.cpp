@@ -0,0 +1,216 @@
+#include "util/pch.h"
+
+#ifdef PLATFORM_WINDOWS
+
+	#include <Windows.h>
+
+#elif defined(PLATFORM_LINUX)
+
+	#include <poll.h>
+	#include <unistd.h>
+	#include <sys/eventfd.h>
+	#include <sys/inotify.h>
+
+#else
+	#error undefined platform
+#endif
+
+#include "directory_watcher.h"
+
+namespace AT::io {
+
+	#define WATCHER_SETTLE_TIME									std::chrono::milliseconds(500)		// Windows only, see [watch_loop()]
+
+	directory_watcher::directory_watcher(const std::filesystem::path& directory, callback on_change)
+		: m_directory(directory), m_on_change(std::move(on_change)) {
+
+	#if defined(PLATFORM_WINDOWS)
+
+		m_directory_handle = CreateFileW(m_directory.wstring().c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+		VALIDATE(m_directory_handle != INVALID_HANDLE_VALUE, m_directory_handle = nullptr; return, "", "Could not open [" << m_directory.generic_string() << "] for watching")
+
+		m_stop_event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+		VALIDATE(m_stop_event, CloseHandle(m_directory_handle); m_directory_handle = nullptr; return, "", "Could not create stop event for directory watcher")
+
+	#elif defined(PLATFORM_LINUX)
+
+		m_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		VALIDATE(m_inotify_fd >= 0, return, "", "inotify_init1 failed for [" << m_directory.generic_string() << "]")
+
+		const int watch = inotify_add_watch(m_inotify_fd, m_directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM);
+		VALIDATE(watch >= 0, close(m_inotify_fd); m_inotify_fd = -1; return, "", "Could not watch [" << m_directory.generic_string() << "]")
+
+		m_stop_fd = eventfd(0, EFD_CLOEXEC);
+		VALIDATE(m_stop_fd >= 0, close(m_inotify_fd); m_inotify_fd = -1; return, "", "Could not create stop eventfd for directory watcher")
+
+	#endif
+
+		m_valid = true;
+		m_thread = std::thread(&directory_watcher::watch_loop, this);
+		LOG(Trace, "Watching [" << m_directory.generic_string() << "]")
+	}
+
+
+	directory_watcher::~directory_watcher() {
+
+	#if defined(PLATFORM_WINDOWS)
+
+		if (m_stop_event)
+			SetEvent(m_stop_event);
+		if (m_thread.joinable())
+			m_thread.join();
+		if (m_stop_event)
+			CloseHandle(m_stop_event);
+		if (m_directory_handle)
+			CloseHandle(m_directory_handle);
+
+	#elif defined(PLATFORM_LINUX)
+
+		if (m_stop_fd >= 0) {
+			const u64 value = 1;
+			[[maybe_unused]] const ssize_t written = write(m_stop_fd, &value, sizeof(value));
+		}
+		if (m_thread.joinable())
+			m_thread.join();
+		if (m_stop_fd >= 0)
+			close(m_stop_fd);
+		if (m_inotify_fd >= 0)
+			close(m_inotify_fd);
+
+	#endif
+	}
+
+
+	void directory_watcher::watch_loop() {
+
+		logger::register_label_for_thread("Dir Watcher");
+
+	#if defined(PLATFORM_WINDOWS)
+
+		alignas(DWORD) u8 buffer[16 * 1024];
+		OVERLAPPED overlapped{};
+		overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+		const HANDLE wait_handles[2] = { overlapped.hEvent, m_stop_event };
+		constexpr DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE;
+
+		// Windows reports a file as soon as it is created and again for every write, there is no IN_CLOSE_WRITE. Added and modified files
+		// are only reported once they stayed unchanged for [WATCHER_SETTLE_TIME] and no other handle has them open.
+		std::map<std::filesystem::path, std::chrono::steady_clock::time_point> settling{};		// file -> last change
+		bool read_pending = false;
+		while (true) {
+
+			if (!read_pending) {
+				if (!ReadDirectoryChangesW(m_directory_handle, buffer, sizeof(buffer), FALSE, filter, nullptr, &overlapped, nullptr))
+					break;
+				read_pending = true;
+			}
+
+			DWORD timeout = INFINITE;
+			const auto now = std::chrono::steady_clock::now();
+			for (const auto& [file, last_change] : settling) {
+				const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(last_change + WATCHER_SETTLE_TIME - now).count();
+				timeout = std::min<DWORD>(timeout, static_cast<DWORD>(std::max<int64>(remaining, 0)));
+			}
+
+			const DWORD result = WaitForMultipleObjects(2, wait_handles, FALSE, timeout);
+			if (result != WAIT_OBJECT_0 && result != WAIT_TIMEOUT) {
+				DWORD bytes = 0;
+				CancelIoEx(m_directory_handle, &overlapped);
+				GetOverlappedResult(m_directory_handle, &overlapped, &bytes, TRUE);		// [buffer] is written until the cancellation completed
+				break;
+			}
+
+			if (result == WAIT_OBJECT_0) {
+
+				read_pending = false;
+				DWORD bytes = 0;
+				if (GetOverlappedResult(m_directory_handle, &overlapped, &bytes, FALSE) && bytes != 0) {		// 0: buffer overflow, changes are lost but the next write is reported again
+
+					for (const u8* cursor = buffer; ; ) {
+
+						const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(cursor);
+						const std::filesystem::path file = m_directory / std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR));
+						switch (info->Action) {
+							case FILE_ACTION_ADDED:
+							case FILE_ACTION_MODIFIED:				settling[file] = std::chrono::steady_clock::now(); break;
+							case FILE_ACTION_RENAMED_NEW_NAME:		settling.erase(file); m_on_change(file, file_change::written); break;		// moved in complete
+							case FILE_ACTION_REMOVED:
+							case FILE_ACTION_RENAMED_OLD_NAME:		settling.erase(file); m_on_change(file, file_change::removed); break;
+							default: break;
+						}
+
+						if (info->NextEntryOffset == 0)
+							break;
+						cursor += info->NextEntryOffset;
+					}
+				}
+				ResetEvent(overlapped.hEvent);
+			}
+
+			const auto checked = std::chrono::steady_clock::now();
+			for (auto it = settling.begin(); it != settling.end(); ) {
+
+				if (checked - it->second < WATCHER_SETTLE_TIME) {
+					++it;
+					continue;
+				}
+
+				// an exclusive open fails while the writer still holds the file, check again after another settle time
+				const HANDLE handle = CreateFileW(it->first.wstring().c_str(), GENERIC_READ, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+				if (handle == INVALID_HANDLE_VALUE && GetLastError() == ERROR_SHARING_VIOLATION) {
+					it->second = checked;
+					++it;
+					continue;
+				}
+
+				if (handle != INVALID_HANDLE_VALUE) {
+					CloseHandle(handle);
+					m_on_change(it->first, file_change::written);
+				}
+				it = settling.erase(it);
+			}
+		}
+		CloseHandle(overlapped.hEvent);
+
+	#elif defined(PLATFORM_LINUX)
+
+		alignas(inotify_event) char buffer[16 * 1024];
+		pollfd descriptors[2] = { {m_inotify_fd, POLLIN, 0}, {m_stop_fd, POLLIN, 0} };
+		while (true) {
+
+			if (poll(descriptors, 2, -1) < 0) {
+				if (errno == EINTR)
+					continue;
+				LOG(Error, "poll failed while watching [" << m_directory.generic_string() << "]")
+				break;
+			}
+
+			if (descriptors[1].revents & POLLIN)
+				break;
+
+			const ssize_t length = read(m_inotify_fd, buffer, sizeof(buffer));
+			if (length <= 0)
+				continue;
+
+			for (char* cursor = buffer; cursor < buffer + length; ) {
+
+				const auto* event = reinterpret_cast<const inotify_event*>(cursor);
+				cursor += sizeof(inotify_event) + event->len;
+				if (event->len == 0 || (event->mask & IN_ISDIR))
+					continue;
+
+				const std::filesystem::path file = m_directory / event->name;
+				if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+					m_on_change(file, file_change::written);
+				else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+					m_on_change(file, file_change::removed);
+			}
+		}
+
+	#endif
+
+		logger::unregister_label_for_thread();
+	}
+
+}
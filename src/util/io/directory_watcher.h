@@ -0,0 +1,53 @@
+#pragma once
+
+
+namespace AT::io {
+
+	// Kind of change reported by a [directory_watcher]
+	enum class file_change : u8 {
+		written = 0,				// a file was closed after writing or moved into the directory
+		removed,					// a file was deleted or moved out of the directory
+	};
+
+	// Watches a single directory (not recursive) on a background thread and reports finished writes and removals.
+	// Uses inotify on Linux and ReadDirectoryChangesW on Windows, so an idle watcher does not poll the file system.
+	// On Windows, where there is no close-after-write event, a write is reported once the file stayed unchanged for a short time and can be opened exclusively.
+	// The callback is invoked on the watcher thread, it must do its own synchronization.
+	class directory_watcher {
+	public:
+
+		using callback = std::function<void(const std::filesystem::path& file, const file_change change)>;
+
+		DELETE_COPY_MOVE_CONSTRUCTOR(directory_watcher);
+
+		// Starts watching [directory]. Check [is_valid()] afterwards, watching fails if the directory does not exist.
+		// @param directory The directory to watch.
+		// @param on_change Called with the full path of every changed file.
+		directory_watcher(const std::filesystem::path& directory, callback on_change);
+
+		// Stops the watcher thread and waits for it to finish.
+		~directory_watcher();
+
+		// @return true if the directory is being watched.
+		FORCEINLINE bool is_valid() const { return m_valid; }
+
+		DEFAULT_GETTER_C(std::filesystem::path, directory);
+
+	private:
+
+		void watch_loop();
+
+		std::filesystem::path		m_directory{};
+		callback					m_on_change{};
+		std::thread					m_thread{};
+		bool						m_valid = false;
+	#if defined(PLATFORM_WINDOWS)
+		void*						m_directory_handle = nullptr;
+		void*						m_stop_event = nullptr;
+	#elif defined(PLATFORM_LINUX)
+		int							m_inotify_fd = -1;
+		int							m_stop_fd = -1;				// eventfd that wakes the blocking poll() on shutdown
+	#endif
+	};
+
+}
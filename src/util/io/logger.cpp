@@ -17,27 +17,29 @@ namespace AT::logger {
     #define LOGGER_CHANGE_BUFFER_SIZE                           "LOGGER change buffer size"
     #define LOGGER_REGISTER_THREAD_LABEL                        "LOGGER register thread label"
     #define LOGGER_UNREGISTER_THREAD_LABEL                      "LOGGER unregister thread label"
+
+    #define LOG_RING_SIZE                                       (64 * 1024)     // bytes per logging thread, power of two
+    #define LOG_RECORD_MAX_SIZE                                 (LOG_RING_SIZE / 4)     // longer messages go through [s_log_queue]
 #if defined(DEBUG)
-    #define QUEUE_MAX_SIZE                                      0               // flush messages directly in debug
+    #define RING_WAKE_FILL                                      0               // flush messages directly in debug
 #else
-    #define QUEUE_MAX_SIZE                                      512
+    #define RING_WAKE_FILL                                      (LOG_RING_SIZE / 2)
 #endif
 
-    #define OPEN_FILE                                           s_main_file = std::ofstream(s_main_log_file_path, std::ios::app);                       \
-                                                                if (!s_main_file.is_open()) {                                                         \
-                                                                    std::cerr << "Failed to open main log file path: [" << s_main_log_file_path << "]" << std::endl;                      \
-                                                                    std::quick_exit(1);                                                             \
-                                                                }
+    #define LOG_FILE_BUFFER_SIZE                                (256 * 1024)    // user-space buffer of the open log file
+    #define LOG_FILE_MAX_SIZE                                   (16 * 1024 * 1024)      // rotated once it grows past this
+    #define LOG_FILE_BACKUP_COUNT                               3               // rotated files kept as <name>.1<ext> (newest) to <name>.3<ext>
+    #define LOG_FLUSH_INTERVAL                                  std::chrono::seconds(1)
+    #define LOG_FLUSH_SEVERITY                                  severity::Warn  // messages of this severity or higher are flushed immediately
 
-    #define CLOSE_FILE                                          if (s_main_file.is_open()) { s_main_file.close(); }
-    #define WRITE_TO_FILE(message)                              { OPEN_FILE s_main_file << message; CLOSE_FILE}
+    #define WRITE_TO_FILE(message)                              { std::ostringstream oss{}; oss << message; write_to_file(oss.view()); }
 
     static bool                                                 s_is_init = false;
     static bool                                                 s_write_log_to_console = false;
     static std::string                                          s_format_current = "";
     static std::string                                          s_format_prev = "";
 
-    static severity                                             s_severity_level_buffering_threshold = severity::Trace;
+    static std::atomic<severity>                                s_severity_level_buffering_threshold = severity::Trace;
     static size_t                                               s_buffer_size = 1024;
     static std::string                                          s_buffered_messages{};
 
@@ -54,30 +56,189 @@ namespace AT::logger {
 
     static std::filesystem::path                                s_main_log_dir = "";
     static std::filesystem::path                                s_main_log_file_path = "";
-    static std::ofstream                                        s_main_file{};
+    static std::ofstream                                        s_main_file{};          // open from [init()] to [shutdown()], only written by the worker thread
+    static char                                                 s_main_file_buffer[LOG_FILE_BUFFER_SIZE];
+    static u64                                                  s_main_file_size = 0;
+    static std::chrono::steady_clock::time_point                s_last_flush{};
 
     struct message_format {
-        message_format(const logger::severity msg_sev, const char* file_name, const char* function_name, const int line, std::thread::id thread_id, const std::string& message) 
-            : msg_sev(msg_sev), file_name(file_name), function_name(function_name), line(line), thread_id(thread_id), message(message) {};
+        message_format(const logger::severity msg_sev, const char* file_name, const char* function_name, const int line, std::thread::id thread_id, const u64 timestamp, const std::string_view message) 
+            : msg_sev(msg_sev), file_name(file_name), function_name(function_name), line(line), thread_id(thread_id), timestamp(timestamp), message(message) {};
 
         const logger::severity                                  msg_sev;
         const char*                                             file_name;
         const char*                                             function_name;
         const int                                               line;
         const std::thread::id                                   thread_id;
+        const u64                                               timestamp;
         const std::string                                       message;
     };
 
-    static std::queue<message_format>                           s_log_queue{};
+    // a message as it is processed, [message] points into the ring or queue entry it came from
+    struct message_view {
+        logger::severity                                        msg_sev;
+        const char*                                             file_name;
+        const char*                                             function_name;
+        int                                                     line;
+        std::thread::id                                         thread_id;
+        u64                                                     timestamp;
+        std::string_view                                        message;
+    };
+
+    // Every thread that logs gets a single-producer/single-consumer ring of records, written without a lock by the thread
+    // and drained by [s_worker_thread]. A record is a [record_header] followed by the message, padded to 8 bytes.
+    // A record never wraps around, a size of 0 marks the rest of the ring as unused.
+    struct record_header {
+        u32                                                     size;               // whole record including the padding
+        u32                                                     message_size;
+        const char*                                             file_name;
+        const char*                                             function_name;
+        int                                                     line;
+        logger::severity                                        msg_sev;
+        std::thread::id                                         thread_id;
+        u64                                                     timestamp;          // [get_timestamp()] of the LOG call, formatted and merged by [drain_messages()]
+    };
+    static_assert(std::is_trivially_copyable_v<record_header> && sizeof(record_header) % 8 == 0, "records are copied into the ring as bytes");
+
+    struct log_ring {
+        alignas(64) std::atomic<u64>                            head = 0;           // bytes written, only advanced by the owning thread
+        alignas(64) std::atomic<u64>                            tail = 0;           // bytes processed, only advanced by the consumer
+        std::atomic<bool>                                       abandoned = false;  // owning thread exited, freed once drained
+        alignas(8) u8                                           data[LOG_RING_SIZE];
+    };
+
+    // marks the ring of an exiting thread, the ring itself stays registered until the consumer processed it
+    struct ring_owner {
+        ~ring_owner() {
+            if (ring)
+                ring->abandoned.store(true, std::memory_order_release);
+            ring = nullptr;                                                 // a message from a later thread_local destructor gets a new ring
+        }
+        log_ring*                                               ring = nullptr;
+    };
+
+    static std::queue<message_format>                           s_log_queue{};      // messages too long for a ring and messages logged while the worker is not running
     static std::unordered_map<std::thread::id, std::string>     s_thread_labels{};
     static std::mutex                                           s_queue_mutex{};
     static std::mutex                                           s_general_mutex{};
     static std::condition_variable                              s_cv{};
     static std::atomic<bool>                                    s_stop = false;
+    static std::atomic<bool>                                    s_worker_running = false;
+    static std::atomic<bool>                                    s_wake_requested = false;
     static std::thread                                          s_worker_thread{};
 
-    void process_log_message(const message_format&& message);
+    static std::atomic<u64>                                     s_flush_requested = 0;  // tickets of [flush()] calls
+    static u64                                                  s_flush_done = 0;       // last ticket the worker processed, guarded by [s_flush_mutex]
+    static std::mutex                                           s_flush_mutex{};
+    static std::condition_variable                              s_flush_cv{};
+
+    static std::vector<log_ring*>                               s_rings{};          // owned, guarded by [s_ring_mutex]
+    static std::mutex                                           s_ring_mutex{};
+    static thread_local ring_owner                              s_thread_ring{};
+
+    void process_log_message(const message_view& message);
     void process_queue();
+    static void drain_messages();
+    static void wake_worker();
+    static void enqueue(const severity msg_sev, const char* file_name, const char* function_name, const int line, std::thread::id thread_id, const std::string_view message);
+
+
+    // nanoseconds since the epoch of the system clock, taken when a message is logged (not when it is written out)
+    static FORCEINLINE u64 get_timestamp() { return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count()); }
+
+
+    // Local time of [timestamp], only called by the consumer. The calendar part is cached, messages are mostly logged within the same second.
+    static system_time to_system_time(const u64 timestamp) {
+
+        static std::time_t cached_second = -1;
+        static system_time cached_time{};
+
+        const std::time_t second = static_cast<std::time_t>(timestamp / 1'000'000'000);
+        if (second != cached_second) {
+
+            std::tm local{};
+#if defined(PLATFORM_WINDOWS)
+            localtime_s(&local, &second);
+#else
+            localtime_r(&second, &local);
+#endif
+            cached_time.year = static_cast<u16>(local.tm_year + 1900);
+            cached_time.month = static_cast<u8>(local.tm_mon + 1);
+            cached_time.day = static_cast<u8>(local.tm_mday);
+            cached_time.day_of_week = static_cast<u8>(local.tm_wday);
+            cached_time.hour = static_cast<u8>(local.tm_hour);
+            cached_time.minute = static_cast<u8>(local.tm_min);
+            cached_time.secund = static_cast<u8>(local.tm_sec);
+            cached_second = second;
+        }
+
+        system_time result = cached_time;
+        result.millisecend = static_cast<u16>((timestamp / 1'000'000) % 1000);
+        return result;
+    }
+
+
+    static void open_file(const std::ios::openmode mode) {
+
+        s_main_file.rdbuf()->pubsetbuf(s_main_file_buffer, LOG_FILE_BUFFER_SIZE);           // has to be set before opening
+        s_main_file.open(s_main_log_file_path, mode);
+        if (!s_main_file.is_open()) {
+            std::cerr << "Failed to open main log file path: [" << s_main_log_file_path << "]" << std::endl;
+            std::quick_exit(1);
+        }
+
+        std::error_code error{};
+        const std::uintmax_t size = (mode & std::ios::app) ? std::filesystem::file_size(s_main_log_file_path, error) : 0;
+        s_main_file_size = error ? 0 : static_cast<u64>(size);
+        s_last_flush = std::chrono::steady_clock::now();
+    }
+
+
+    // [general.log] => [general.1.log], an existing [general.1.log] => [general.2.log] and so on, the oldest is replaced
+    static void rotate_file() {
+
+        s_main_file.close();
+
+        const auto backup_path = [](const u32 index) {
+            std::filesystem::path path = s_main_log_file_path;
+            return path.replace_filename(s_main_log_file_path.stem().string() + "." + std::to_string(index) + s_main_log_file_path.extension().string());
+        };
+
+        std::error_code error{};
+        for (u32 x = LOG_FILE_BACKUP_COUNT; x > 1; x--)
+            if (std::filesystem::exists(backup_path(x - 1), error))
+                std::filesystem::rename(backup_path(x - 1), backup_path(x), error);
+
+        std::filesystem::rename(s_main_log_file_path, backup_path(1), error);
+        if (error)
+            std::cerr << "Failed to rotate main log file [" << s_main_log_file_path << "]: " << error.message() << std::endl;
+
+        open_file(error ? std::ios::app : std::ios::out);                  // keep appending if the file could not be moved
+        if (error)
+            s_main_file_size = 0;                                           // try again after another [LOG_FILE_MAX_SIZE] bytes
+    }
+
+
+    // only buffered by the stream, written out by [flush_file()], the stream buffer filling up, or [rotate_file()]
+    static void write_to_file(const std::string_view text) {
+
+        s_main_file.write(text.data(), static_cast<std::streamsize>(text.size()));
+        s_main_file_size += text.size();
+        if (s_main_file_size >= LOG_FILE_MAX_SIZE)
+            rotate_file();
+    }
+
+
+    static void flush_file() {
+
+        if (!s_buffered_messages.empty()) {
+            write_to_file(s_buffered_messages);
+            s_buffered_messages.clear();
+        }
+
+        s_main_file.flush();
+        s_last_flush = std::chrono::steady_clock::now();
+    }
 
 
     inline const char* get_filename(const char* filepath) {
@@ -116,22 +277,19 @@ namespace AT::logger {
                 std::quick_exit(1);
             }
 
-        s_main_file = std::ofstream(s_main_log_file_path, (use_append_mode) ? std::ios::app : std::ios::out);
-        if (!s_main_file.is_open()) {
-            std::cerr << "Failed to open main log file path: [" << s_main_log_file_path << "]" << std::endl;
-            std::quick_exit(1);
-        }
-        s_main_file << "\n================================================================================================\n";
+        open_file((use_append_mode) ? std::ios::app : std::ios::out);
         auto now = std::time(nullptr);
         auto tm = *std::localtime(&now);
-        s_main_file << "Log initalized at [" << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << "]\n";
-        s_main_file << "------------------------------------------------------------------------------------------------\n";
-        CLOSE_FILE
+        WRITE_TO_FILE("\n================================================================================================\n"
+            << "Log initalized at [" << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << "]\n"
+            << "------------------------------------------------------------------------------------------------\n")
+        s_main_file.flush();
 
         s_buffered_messages.reserve(s_buffer_size);
 
         s_is_init = true;
 
+        s_worker_running = true;
         s_worker_thread = std::thread(&process_queue);                                                        // start after inital write to avoid using mutex
 
         return true;
@@ -145,35 +303,25 @@ namespace AT::logger {
             std::quick_exit(1);
         }
 
+        s_worker_running = false;
         s_stop = true;
         s_cv.notify_all();
         if (s_worker_thread.joinable())
             s_worker_thread.join();
 
-        // Process any remaining messages in the queue after worker thread has stopped
-        std::queue<message_format> remaining_messages;
-        {
-            std::lock_guard<std::mutex> lock(s_queue_mutex);
-            remaining_messages = std::move(s_log_queue); // Take all remaining messages
-        }
-
-        while (!remaining_messages.empty()) {
-            message_format msg = std::move(remaining_messages.front());
-            remaining_messages.pop();
-            process_log_message(std::move(msg)); // Process each message
-        }
+        drain_messages();                                                       // Process any remaining messages after worker thread has stopped
 
-        if ( !s_buffered_messages.empty()) {
-            
+        {
+            std::lock_guard<std::mutex> lock(s_general_mutex);
             auto now = std::time(nullptr);
             auto tm = *std::localtime(&now);
-            
-            OPEN_FILE
-            s_main_file << s_buffered_messages;
-            s_main_file << "------------------------------------------------------------------------------------------------\n";
-            s_main_file << "Log shutdown at [" << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << "]\n";
-            s_main_file << "================================================================================================\n";
-            CLOSE_FILE
+
+            write_to_file(s_buffered_messages);
+            s_buffered_messages.clear();
+            WRITE_TO_FILE("------------------------------------------------------------------------------------------------\n"
+                << "Log shutdown at [" << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << "]\n"
+                << "================================================================================================\n")
+            s_main_file.close();
         }
 
         s_is_init = false;
@@ -183,6 +331,27 @@ namespace AT::logger {
     // settings
     // ========================================================================================================================
 
+    void flush(const std::chrono::milliseconds timeout) {
+
+        if (!s_is_init)
+            return;
+
+        if (s_worker_running && std::this_thread::get_id() != s_worker_thread.get_id()) {
+
+            const u64 ticket = ++s_flush_requested;
+            wake_worker();
+            std::unique_lock<std::mutex> lock(s_flush_mutex);
+            if (s_flush_cv.wait_for(lock, timeout, [ticket] { return s_flush_done >= ticket; }))
+                return;
+        }
+
+        // the worker is gone, stuck or the caller itself: flush what is already formatted, the rings may be mid-read
+        std::unique_lock<std::mutex> lock(s_general_mutex, std::defer_lock);
+        if (std::this_thread::get_id() == s_worker_thread.get_id() || lock.try_lock())
+            flush_file();
+    }
+
+
     std::filesystem::path get_log_file_location() { return s_main_log_file_path; }
 
 
@@ -193,17 +362,15 @@ namespace AT::logger {
             return;
         }
         
-        std::lock_guard<std::mutex> lock(s_queue_mutex);
-        s_log_queue.emplace(severity::Trace, "", LOGGER_UPDATE_FORMAT, 0, std::thread::id(), new_format.c_str());
-        s_cv.notify_all();
+        enqueue(severity::Trace, "", LOGGER_UPDATE_FORMAT, 0, std::thread::id(), new_format);
+        wake_worker();
     }
 
 
     void use_previous_format() {
         
-        std::lock_guard<std::mutex> lock(s_queue_mutex);
-        s_log_queue.emplace(severity::Trace, "", LOGGER_REVERSE_FORMAT, 0, std::thread::id(), "");
-        s_cv.notify_all();
+        enqueue(severity::Trace, "", LOGGER_REVERSE_FORMAT, 0, std::thread::id(), "");
+        wake_worker();
     }
 
 
@@ -212,9 +379,8 @@ namespace AT::logger {
 
     void register_label_for_thread(const std::string& thread_label, std::thread::id thread_id) {
 
-        std::lock_guard<std::mutex> lock(s_queue_mutex);
-        s_log_queue.emplace(severity::Trace, "", LOGGER_REGISTER_THREAD_LABEL, 0, thread_id, thread_label);
-        s_cv.notify_all();
+        enqueue(severity::Trace, "", LOGGER_REGISTER_THREAD_LABEL, 0, thread_id, thread_label);
+        wake_worker();
     }
 
 
@@ -227,25 +393,22 @@ namespace AT::logger {
                 loc_oss << "[LOGGER] Tried to unregister label for unknown thread with ID: [" << thread_id << "]. IGNORED";
         }
 
-        std::lock_guard<std::mutex> lock(s_queue_mutex);
-        s_log_queue.emplace(severity::Trace, "", LOGGER_UNREGISTER_THREAD_LABEL, 0, thread_id, std::move(loc_oss.str()));
-        s_cv.notify_all();
+        enqueue(severity::Trace, "", LOGGER_UNREGISTER_THREAD_LABEL, 0, thread_id, loc_oss.view());
+        wake_worker();
     }
 
 
     void set_buffer_threshold(const severity new_threshold) {
 
-        std::lock_guard<std::mutex> lock(s_queue_mutex);
-        s_log_queue.emplace(new_threshold, "", LOGGER_CHANGE_THRESHOLD, 0, std::thread::id(), "[LOGGER] Changed buffering threshold to [" + severity_names[static_cast<u8>(s_severity_level_buffering_threshold)] + "]");
-        s_cv.notify_all();
+        enqueue(new_threshold, "", LOGGER_CHANGE_THRESHOLD, 0, std::thread::id(), "[LOGGER] Changed buffering threshold to [" + severity_names[static_cast<u8>(s_severity_level_buffering_threshold.load())] + "]");
+        wake_worker();
     }
 
 
     void set_s_buffer_size(const size_t new_size) {
 
-        std::lock_guard<std::mutex> lock(s_queue_mutex);
-        s_log_queue.emplace(severity::Trace, "", LOGGER_CHANGE_BUFFER_SIZE, static_cast<int>(new_size), std::thread::id(), "[LOGGER] Changed buffer size to [" + std::to_string(new_size) + "]");
-        s_cv.notify_all();
+        enqueue(severity::Trace, "", LOGGER_CHANGE_BUFFER_SIZE, static_cast<int>(new_size), std::thread::id(), "[LOGGER] Changed buffer size to [" + std::to_string(new_size) + "]");
+        wake_worker();
     }
 
 
@@ -255,92 +418,186 @@ namespace AT::logger {
 
     void process_queue() {
 
-        std::unique_lock<std::mutex> lock(s_queue_mutex);
         while (!s_stop) {
 
-            s_cv.wait_for(lock, std::chrono::milliseconds(100), [] { return !s_log_queue.empty() || s_stop; });
-            
+            {
+                std::unique_lock<std::mutex> lock(s_queue_mutex);
+                s_cv.wait_for(lock, std::chrono::milliseconds(100), [] { return s_wake_requested.load() || !s_log_queue.empty() || s_stop; });
+            }
+
             if (s_stop) break;
-        
 
-            std::queue<message_format> local_queue;
-            while (!s_log_queue.empty()) {                                    // Move all current messages to a local queue
-                local_queue.push(std::move(s_log_queue.front()));
-                s_log_queue.pop();
+            s_wake_requested = false;                                       // cleared before draining, records written from now on request a new round
+            const u64 flush_request = s_flush_requested.load();
+            drain_messages();
+
+            {
+                std::lock_guard<std::mutex> lock(s_general_mutex);
+                if (flush_request != s_flush_done || std::chrono::steady_clock::now() - s_last_flush >= LOG_FLUSH_INTERVAL)
+                    flush_file();
             }
-            lock.unlock();                                                  // Unlock while processing messages
 
-            // Process each message from the local queue
-            while (!local_queue.empty()) {
-                message_format message = std::move(local_queue.front());
-                local_queue.pop();
-                // Process control messages and log messages
+            if (flush_request != s_flush_done) {
+                std::lock_guard<std::mutex> lock(s_flush_mutex);
+                s_flush_done = flush_request;
+                s_flush_cv.notify_all();
+            }
+        }
+    }
 
-                if (strcmp(message.function_name, LOGGER_UPDATE_FORMAT) == 0) {
 
-                    std::lock_guard<std::mutex> lock(s_general_mutex);
-                    s_format_prev = s_format_current;
-                    s_format_current = static_cast<std::string>(message.message);
+    static void process_message(const message_view& message) {
 
-                    WRITE_TO_FILE("[LOGGER] Changing log-format. From [" << s_format_prev << "] to [" << s_format_current << "]\n");
-                
-                } else if (strcmp(message.function_name, LOGGER_REVERSE_FORMAT) == 0) {
-                    
-                    std::lock_guard<std::mutex> lock(s_general_mutex);
-                    const std::string buffer = s_format_current;
-                    s_format_current = s_format_prev;
-                    s_format_prev = buffer;
+        // Process control messages and log messages
+        if (strcmp(message.function_name, LOGGER_UPDATE_FORMAT) == 0) {
 
-                } else if (strcmp(message.function_name, LOGGER_CHANGE_THRESHOLD) == 0) {
+            std::lock_guard<std::mutex> lock(s_general_mutex);
+            s_format_prev = s_format_current;
+            s_format_current = static_cast<std::string>(message.message);
 
-                    std::lock_guard<std::mutex> lock(s_general_mutex);
-                    s_severity_level_buffering_threshold = static_cast<severity>(std::min(static_cast<u8>(message.msg_sev), static_cast<u8>(severity::Error)));   
+            WRITE_TO_FILE("[LOGGER] Changing log-format. From [" << s_format_prev << "] to [" << s_format_current << "]\n");
 
-                }
-                else if (strcmp(message.function_name, LOGGER_CHANGE_BUFFER_SIZE) == 0) {
-
-                    std::lock_guard<std::mutex> lock(s_general_mutex);
-                    s_buffer_size = static_cast<size_t>(message.line);
-
-                    OPEN_FILE
-                    s_main_file << message.message;                    
-                    if (s_is_init && s_buffered_messages.size() >= s_buffer_size) {                   // Handle buffer overflow if the new size is smaller than the current buffer content
-                        
-                        s_main_file << s_buffered_messages;
-                        // if (s_write_log_to_console)
-                        // std::cout << s_buffered_messages;
-                        
-                        s_buffered_messages.clear();
-                    }
-                    CLOSE_FILE
-                
-                    s_buffered_messages.shrink_to_fit();
-                    s_buffered_messages.reserve(s_buffer_size);
-                
-                } else if (strcmp(message.function_name, LOGGER_REGISTER_THREAD_LABEL) == 0) {            // process_reverse_in_msg_format();
+        } else if (strcmp(message.function_name, LOGGER_REVERSE_FORMAT) == 0) {
 
-                    std::lock_guard<std::mutex> lock(s_general_mutex);
-                    
-                    if (s_thread_labels.find(message.thread_id) != s_thread_labels.end())
-                        WRITE_TO_FILE("[LOGGER] Thread with ID: [" << message.thread_id << "] already has label [" << s_thread_labels[message.thread_id] << "] registered. Overriding with the label: [" << message.message << "]\n")
-                    else
-                        WRITE_TO_FILE("[LOGGER] Registering Thread-ID: [" << message.thread_id << "] with the label: [" << message.message << "]\n")
+            std::lock_guard<std::mutex> lock(s_general_mutex);
+            const std::string buffer = s_format_current;
+            s_format_current = s_format_prev;
+            s_format_prev = buffer;
 
-                    s_thread_labels[message.thread_id] = message.message;
-                
-                } else if (strcmp(message.function_name, LOGGER_UNREGISTER_THREAD_LABEL) == 0) {
+        } else if (strcmp(message.function_name, LOGGER_CHANGE_THRESHOLD) == 0) {
 
-                    std::lock_guard<std::mutex> lock(s_general_mutex);
-                    s_thread_labels.erase(message.thread_id);
-                }
+            std::lock_guard<std::mutex> lock(s_general_mutex);
+            s_severity_level_buffering_threshold = static_cast<severity>(std::min(static_cast<u8>(message.msg_sev), static_cast<u8>(severity::Error)));   
+
+        }
+        else if (strcmp(message.function_name, LOGGER_CHANGE_BUFFER_SIZE) == 0) {
+
+            std::lock_guard<std::mutex> lock(s_general_mutex);
+            s_buffer_size = static_cast<size_t>(message.line);
+
+            write_to_file(message.message);
+            if (s_is_init && s_buffered_messages.size() >= s_buffer_size) {                   // Handle buffer overflow if the new size is smaller than the current buffer content
+
+                write_to_file(s_buffered_messages);
+                // if (s_write_log_to_console)
+                // std::cout << s_buffered_messages;
 
-                else
-                    process_log_message(std::move(message));
+                s_buffered_messages.clear();
             }
 
-            // Re-lock before next iteration
-            lock.lock();
+            s_buffered_messages.shrink_to_fit();
+            s_buffered_messages.reserve(s_buffer_size);
+
+        } else if (strcmp(message.function_name, LOGGER_REGISTER_THREAD_LABEL) == 0) {            // process_reverse_in_msg_format();
+
+            std::lock_guard<std::mutex> lock(s_general_mutex);
+
+            if (s_thread_labels.find(message.thread_id) != s_thread_labels.end())
+                WRITE_TO_FILE("[LOGGER] Thread with ID: [" << message.thread_id << "] already has label [" << s_thread_labels[message.thread_id] << "] registered. Overriding with the label: [" << message.message << "]\n")
+            else
+                WRITE_TO_FILE("[LOGGER] Registering Thread-ID: [" << message.thread_id << "] with the label: [" << message.message << "]\n")
+
+            s_thread_labels[message.thread_id] = message.message;
+
+        } else if (strcmp(message.function_name, LOGGER_UNREGISTER_THREAD_LABEL) == 0) {
+
+            std::lock_guard<std::mutex> lock(s_general_mutex);
+            s_thread_labels.erase(message.thread_id);
         }
+
+        else
+            process_log_message(message);
+    }
+
+
+    // Read position of the consumer in one ring, records up to [head] are processed in this round
+    struct ring_cursor {
+        log_ring*                                               ring;
+        u64                                                     tail;
+        u64                                                     head;
+        record_header                                           next;               // valid if [tail < head]
+    };
+
+
+    // Skips the unused end of the ring and loads the header of the next record, if there is one before [cursor.head]
+    static bool load_next_record(ring_cursor& cursor) {
+
+        while (cursor.tail < cursor.head) {
+
+            const u8* record = cursor.ring->data + (cursor.tail & (LOG_RING_SIZE - 1));
+            u32 size = 0;
+            std::memcpy(&size, record, sizeof(size));
+            if (size != 0) {
+                std::memcpy(&cursor.next, record, sizeof(cursor.next));
+                return true;
+            }
+            cursor.tail += LOG_RING_SIZE - (cursor.tail & (LOG_RING_SIZE - 1));     // unused end of the ring, the next record starts at the beginning
+        }
+        cursor.ring->tail.store(cursor.tail, std::memory_order_release);
+        return false;
+    }
+
+
+    // Only called by the single consumer: [s_worker_thread], or [shutdown()] after it was joined
+    static void drain_messages() {
+
+        static std::vector<ring_cursor> cursors{};
+        {
+            std::lock_guard<std::mutex> lock(s_ring_mutex);
+            cursors.clear();
+            for (log_ring* ring : s_rings)
+                cursors.push_back({ ring, ring->tail.load(std::memory_order_relaxed), 0, {} });
+        }
+
+        for (auto& cursor : cursors)
+            cursor.head = cursor.ring->head.load(std::memory_order_acquire);
+
+        // Records written after the heads were read are left for the next round, they may follow a message that is not in [local_queue] yet.
+        // A thread only queues a message once its ring is empty, so its queued message is older than anything left in its ring.
+        std::queue<message_format> local_queue;
+        {
+            std::lock_guard<std::mutex> lock(s_queue_mutex);
+            local_queue.swap(s_log_queue);
+        }
+
+        // Every ring is in the order its thread logged, the queue in the order it was filled. Merging them by the LOG-time timestamp
+        // writes the messages of all threads in the order they were logged, not ring by ring.
+        std::erase_if(cursors, [](ring_cursor& cursor) { return !load_next_record(cursor); });
+        while (!cursors.empty() || !local_queue.empty()) {
+
+            ring_cursor* oldest = nullptr;
+            for (auto& cursor : cursors)
+                if (!oldest || cursor.next.timestamp < oldest->next.timestamp)
+                    oldest = &cursor;
+
+            if (!local_queue.empty() && (!oldest || local_queue.front().timestamp <= oldest->next.timestamp)) {
+
+                const message_format& message = local_queue.front();
+                process_message({ message.msg_sev, message.file_name, message.function_name, message.line, message.thread_id, message.timestamp, message.message });
+                local_queue.pop();
+                continue;
+            }
+
+            const record_header& header = oldest->next;
+            const u8* record = oldest->ring->data + (oldest->tail & (LOG_RING_SIZE - 1));
+            process_message({ header.msg_sev, header.file_name, header.function_name, header.line, header.thread_id, header.timestamp,
+                std::string_view(reinterpret_cast<const char*>(record + sizeof(record_header)), header.message_size) });
+
+            oldest->tail += header.size;
+            oldest->ring->tail.store(oldest->tail, std::memory_order_release);  // released right after it was written out
+            if (!load_next_record(*oldest))
+                std::erase_if(cursors, [oldest](const ring_cursor& cursor) { return &cursor == oldest; });
+        }
+
+        std::lock_guard<std::mutex> lock(s_ring_mutex);
+        std::erase_if(s_rings, [](log_ring* ring) {
+
+            if (!ring->abandoned.load(std::memory_order_acquire) || ring->tail.load(std::memory_order_relaxed) != ring->head.load(std::memory_order_acquire))
+                return false;
+
+            delete ring;
+            return true;
+        });
     }
 
 
@@ -348,21 +605,132 @@ namespace AT::logger {
     // handle message
     // ========================================================================================================================
 
-    void log_msg(const severity msg_sev, const char* file_name, const char* function_name, const int line, std::thread::id thread_id, std::string&& message) {
+    // At most one notification per round of the worker, a record written between its wait and the notification is picked up by the 100ms timeout
+    static void wake_worker() {
+
+        if (!s_wake_requested.load(std::memory_order_relaxed) && !s_wake_requested.exchange(true))
+            s_cv.notify_one();
+    }
+
+
+    static log_ring* get_thread_ring() {
+
+        if (s_thread_ring.ring)
+            return s_thread_ring.ring;
+
+        s_thread_ring.ring = new log_ring();
+        std::lock_guard<std::mutex> lock(s_ring_mutex);
+        s_rings.push_back(s_thread_ring.ring);
+        return s_thread_ring.ring;
+    }
+
+
+    static void enqueue_locked(const severity msg_sev, const char* file_name, const char* function_name, const int line, std::thread::id thread_id, const u64 timestamp, const std::string_view message) {
+
+        {
+            std::lock_guard<std::mutex> lock(s_queue_mutex);
+            s_log_queue.emplace(msg_sev, file_name, function_name, line, thread_id, timestamp, message);
+        }
+        wake_worker();
+    }
+
+
+    // Writes one record into the ring of the calling thread. A full ring blocks the thread until the worker caught up.
+    static void enqueue(const severity msg_sev, const char* file_name, const char* function_name, const int line, std::thread::id thread_id, const std::string_view message) {
+
+        const u64 timestamp = get_timestamp();
+        log_ring* ring = get_thread_ring();
+        const u64 record_size = (sizeof(record_header) + message.size() + 7) & ~static_cast<u64>(7);
+        if (record_size > LOG_RECORD_MAX_SIZE) {
+
+            // queued messages are processed before any ring, everything this thread logged before has to be written out first
+            while (s_worker_running && ring->tail.load(std::memory_order_acquire) != ring->head.load(std::memory_order_relaxed)) {
+                wake_worker();
+                std::this_thread::yield();
+            }
+            enqueue_locked(msg_sev, file_name, function_name, line, thread_id, timestamp, message);
+            return;
+        }
+
+        u64 head = ring->head.load(std::memory_order_relaxed);
+        const u64 contiguous = LOG_RING_SIZE - (head & (LOG_RING_SIZE - 1));
+        const u64 padding = (contiguous < record_size) ? contiguous : 0;
+        while (LOG_RING_SIZE - (head - ring->tail.load(std::memory_order_acquire)) < padding + record_size) {
+
+            if (!s_worker_running) {                                        // nobody drains the ring, [shutdown()] processes the queue
+                enqueue_locked(msg_sev, file_name, function_name, line, thread_id, timestamp, message);
+                return;
+            }
+            wake_worker();
+            std::this_thread::yield();
+        }
+
+        if (padding) {
+            const u32 end_marker = 0;
+            std::memcpy(ring->data + (head & (LOG_RING_SIZE - 1)), &end_marker, sizeof(end_marker));
+            head += padding;
+        }
+
+        const record_header header{ static_cast<u32>(record_size), static_cast<u32>(message.size()), file_name, function_name, line, msg_sev, thread_id, timestamp };
+        u8* record = ring->data + (head & (LOG_RING_SIZE - 1));
+        std::memcpy(record, &header, sizeof(header));
+        std::memcpy(record + sizeof(header), message.data(), message.size());
+        head += record_size;
+        ring->head.store(head, std::memory_order_release);
+
+        if (static_cast<u8>(msg_sev) >= static_cast<u8>(s_severity_level_buffering_threshold.load(std::memory_order_relaxed))
+            || head - ring->tail.load(std::memory_order_relaxed) >= RING_WAKE_FILL)           // check if thread should be notified
+            wake_worker();
+    }
+
+
+    void log_msg(const severity msg_sev, const char* file_name, const char* function_name, const int line, std::thread::id thread_id, const std::string_view message) {
 
         if (message.empty())
             return;
 
-        std::lock_guard<std::mutex> lock(s_queue_mutex);
-        s_log_queue.emplace(msg_sev, file_name, function_name, line, thread_id, message);
+        enqueue(msg_sev, file_name, function_name, line, thread_id, message);
+    }
+
 
-        if (static_cast<u8>(msg_sev) >= static_cast<u8>(s_severity_level_buffering_threshold) || s_log_queue.size() >= QUEUE_MAX_SIZE)           // check if thread should be notified
-            s_cv.notify_all();
+    void log_msg(const severity msg_sev, const char* file_name, const char* function_name, const int line, std::thread::id thread_id, std::string&& message) {
 
+        log_msg(msg_sev, file_name, function_name, line, thread_id, std::string_view(message));
     }
 
 
-    void process_log_message(const message_format&& message) {
+    void message_stream::append_overflow(const char* data, const size_t size) {
+
+        if (m_overflow.empty()) {
+            m_overflow.reserve(2 * (m_size + size));
+            m_overflow.assign(m_inline, m_size);
+        }
+        m_overflow.append(data, size);
+    }
+
+
+    // reused by every fallback of this thread, reset to the default state of a new stream each time
+    std::ostringstream& message_stream::begin_fallback() {
+
+        static thread_local std::ostringstream stream{};
+        stream.seekp(0);
+        stream.clear();
+        stream.flags(std::ios_base::skipws | std::ios_base::dec);
+        stream.precision(6);
+        stream.fill(' ');
+        return stream;
+    }
+
+
+    void message_stream::end_fallback(std::ostringstream& stream) {
+
+        const std::streamoff written = stream.tellp();
+        if (written > 0)
+            append(stream.view().data(), static_cast<size_t>(written));
+    }
+
+
+    void process_log_message(const message_view& message) {
 
     #define SHORTEN_FUNC_NAME(text)                                 (strstr(text, "::") ? strstr(text, "::") + 2 : text)
 
@@ -370,7 +738,7 @@ namespace AT::logger {
         std::ostringstream format_filled{};
         format_filled.flush();
         char format_command{};
-        system_time loc_sys_time = util::get_system_time();
+        const system_time loc_sys_time = to_system_time(message.timestamp);
 
         // loop over format string and build final message
         std::unique_lock<std::mutex> lock(s_general_mutex);
@@ -426,17 +794,19 @@ namespace AT::logger {
         if (s_write_log_to_console)                               // write to console befor checking for file write conditions
             std::cout << log_str;
 
-        if (!((static_cast<u8>(message.msg_sev) >= static_cast<u8>(s_severity_level_buffering_threshold)) || (s_buffered_messages.capacity() - s_buffered_messages.size()) <= log_str.size())) {
+        const bool flush = static_cast<u8>(message.msg_sev) >= static_cast<u8>(LOG_FLUSH_SEVERITY);
+        if (!(flush || (static_cast<u8>(message.msg_sev) >= static_cast<u8>(s_severity_level_buffering_threshold.load())) || (s_buffered_messages.capacity() - s_buffered_messages.size()) <= log_str.size())) {
 
             s_buffered_messages.append(log_str);
             return;
         }
-        
-        OPEN_FILE
-        s_main_file << s_buffered_messages << log_str;
-        CLOSE_FILE
 
+        write_to_file(s_buffered_messages);
+        write_to_file(log_str);
         s_buffered_messages.clear();
+
+        if (flush)
+            flush_file();
     }
 
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include "util/pch.h"
 #include "util/core_config.h"
 
+#include <charconv>
+
 #undef ERROR
 
 //#ifndef DEBUG_BREAK
@@ -45,6 +47,11 @@ namespace AT::logger {
     // @return None.
     void shutdown();
 
+    // Writes every message logged so far to the main log file and flushes it to the OS. Called by the crash handler before the process exits.
+    // Blocks until the worker thread processed the messages, at most [timeout]. If the worker does not respond (e.g. because it is the
+    // crashing thread), only the messages it already formatted are flushed.
+    void flush(const std::chrono::milliseconds timeout = std::chrono::milliseconds(1000));
+
     // Returns the filesystem path to the main log file used by the logger.
     // @return A std::filesystem::path pointing to the current main log file.
     std::filesystem::path get_log_file_location();
@@ -53,6 +60,7 @@ namespace AT::logger {
     // The format of log-messages can be customized with the following tags
     // @note to format all following log-messages use: set_format()
     // @note e.g. set_format("$B[$T] $L [$F] $C$E")
+    // @note time and date are taken when the message is logged, not when the worker writes it out
     //
     // @param $T time                    hh:mm:ss
     // @param $H hour                    hh
@@ -122,11 +130,100 @@ namespace AT::logger {
     void unregister_label_for_thread(std::thread::id thread_id = std::this_thread::get_id());
     
 
+    // THIS SHOULD NEVER BE DIRECTLY CALLED
+    // Copies the message into the ring buffer of the calling thread, no lock is taken unless the message is longer than a quarter of the ring.
+    // @note empty log messages will be ignored
+    void log_msg(const severity msg_sev, const char* file_name, const char* function_name, const int line, std::thread::id thread_id, const std::string_view message);
+
     // THIS SHOULD NEVER BE DIRECTLY CALLED
     // @note empty log messages will be ignored
     void log_msg(const severity msg_sev, const char* file_name, const char* function_name, const int line, std::thread::id thread_id, std::string&& message);
 
 
+    #define LOG_INLINE_MESSAGE_SIZE         256             // messages up to this size are formatted without allocating
+
+    // Builds the message of one LOG call, used by the LOG macros instead of std::ostringstream.
+    // Text, characters and numbers are written into an inline buffer (numbers formatted like std::ostream does by default),
+    // only messages longer than [LOG_INLINE_MESSAGE_SIZE] continue in a heap string.
+    // Every other type is formatted by its std::ostream operator<< on a stream that is reused per thread,
+    // stream manipulators other than std::endl therefore have no effect.
+    class message_stream {
+    public:
+
+        message_stream() = default;
+        DELETE_COPY_MOVE_CONSTRUCTOR(message_stream);
+
+        FORCEINLINE message_stream& operator<<(const std::string_view text) { append(text.data(), text.size()); return *this; }
+        FORCEINLINE message_stream& operator<<(const std::string& text) { append(text.data(), text.size()); return *this; }
+        FORCEINLINE message_stream& operator<<(const char* text) { if (text) append(text, std::strlen(text)); return *this; }
+        FORCEINLINE message_stream& operator<<(const char character) { append(&character, 1); return *this; }
+        FORCEINLINE message_stream& operator<<(const bool value) { return *this << (value ? '1' : '0'); }
+
+        template<typename T>
+            requires (std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>)
+        FORCEINLINE message_stream& operator<<(const T character) { return *this << static_cast<char>(character); }      // a character, like std::ostream prints it
+
+        template<std::integral T>
+            requires (!std::is_same_v<T, bool> && !std::is_same_v<T, char> && !std::is_same_v<T, signed char> && !std::is_same_v<T, unsigned char>)
+        message_stream& operator<<(const T value) {
+
+            char buffer[24];
+            const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            append(buffer, static_cast<size_t>(result.ptr - buffer));
+            return *this;
+        }
+
+        template<std::floating_point T>
+        message_stream& operator<<(const T value) {
+
+            char buffer[32];
+            const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 6);        // "%g", the std::ostream default
+            append(buffer, static_cast<size_t>(result.ptr - buffer));
+            return *this;
+        }
+
+        template<typename T>
+            requires (!std::is_arithmetic_v<T> && requires(std::ostream& stream, const T& value) { stream << value; })
+        message_stream& operator<<(const T& value) {
+
+            std::ostringstream& stream = begin_fallback();
+            stream << value;
+            end_fallback(stream);
+            return *this;
+        }
+
+        message_stream& operator<<(std::ostream& (*manipulator)(std::ostream&)) {
+
+            std::ostringstream& stream = begin_fallback();
+            manipulator(stream);
+            end_fallback(stream);
+            return *this;
+        }
+
+        // @return The message, valid as long as this stream.
+        FORCEINLINE std::string_view view() const { return m_overflow.empty() ? std::string_view(m_inline, m_size) : std::string_view(m_overflow); }
+
+    private:
+
+        FORCEINLINE void append(const char* data, const size_t size) {
+
+            if (m_overflow.empty() && m_size + size <= LOG_INLINE_MESSAGE_SIZE) {
+                std::memcpy(m_inline + m_size, data, size);
+                m_size += size;
+            } else
+                append_overflow(data, size);
+        }
+
+        void append_overflow(const char* data, const size_t size);
+        static std::ostringstream& begin_fallback();
+        void end_fallback(std::ostringstream& stream);
+
+        char                    m_inline[LOG_INLINE_MESSAGE_SIZE];
+        size_t                  m_size = 0;
+        std::string             m_overflow{};               // holds the whole message once it outgrew [m_inline]
+    };
+
+
     // An exception type that logs the error message immediately when constructed.
     // The exception stores the provided message and also forwards it to the logger
     // with context (file, function, line, thread).
@@ -173,29 +270,29 @@ namespace AT::logger {
 
 #define LOGGED_EXCEPTION(message)   { std::ostringstream oss{}; oss << "LOGGER EXCEPTION: " << message; throw AT::logger::logged_exception(__FILE__, __FUNCTION__, __LINE__, std::this_thread::get_id(), std::move(oss.str())); }
 
-#define LOG_Fatal(message)          { std::ostringstream oss{}; oss << message; AT::logger::log_msg(AT::logger::severity::Fatal, __FILE__, __FUNCTION__, __LINE__, std::this_thread::get_id(), std::move(oss.str())); }
-#define LOG_Error(message)          { std::ostringstream oss{}; oss << message; AT::logger::log_msg(AT::logger::severity::Error, __FILE__, __FUNCTION__, __LINE__, std::this_thread::get_id(), std::move(oss.str())); }
+#define LOG_Fatal(message)          { AT::logger::message_stream oss{}; oss << message; AT::logger::log_msg(AT::logger::severity::Fatal, __FILE__, __FUNCTION__, __LINE__, std::this_thread::get_id(), oss.view()); }
+#define LOG_Error(message)          { AT::logger::message_stream oss{}; oss << message; AT::logger::log_msg(AT::logger::severity::Error, __FILE__, __FUNCTION__, __LINE__, std::this_thread::get_id(), oss.view()); }
 
 #if LOG_LEVEL_ENABLED > 0
-    #define LOG_Warn(message)       { std::ostringstream oss{}; oss << message; AT::logger::log_msg(AT::logger::severity::Warn, __FILE__, __FUNCTION__, __LINE__, std::this_thread::get_id(), std::move(oss.str())); }
+    #define LOG_Warn(message)       { AT::logger::message_stream oss{}; oss << message; AT::logger::log_msg(AT::logger::severity::Warn, __FILE__, __FUNCTION__, __LINE__, std::this_thread::get_id(), oss.view()); }
 #else
     #define LOG_Warn(message)       { }
 #endif
 
 #if LOG_LEVEL_ENABLED > 1
-    #define LOG_Info(message)       { std::ostringstream oss{}; oss << message; AT::logger::log_msg(AT::logger::severity::Info, __FILE__, __FUNCTION__, __LINE__, std::this_thread::get_id(), std::move(oss.str())); }
+    #define LOG_Info(message)       { AT::logger::message_stream oss{}; oss << message; AT::logger::log_msg(AT::logger::severity::Info, __FILE__, __FUNCTION__, __LINE__, std::this_thread::get_id(), oss.view()); }
 #else
     #define LOG_Info(message)       { }
 #endif
 
 #if LOG_LEVEL_ENABLED > 2
-    #define LOG_Debug(message)      { std::ostringstream oss{}; oss << message; AT::logger::log_msg(AT::logger::severity::Debug, __FILE__, __FUNCTION__, __LINE__, std::this_thread::get_id(), std::move(oss.str())); }
+    #define LOG_Debug(message)      { AT::logger::message_stream oss{}; oss << message; AT::logger::log_msg(AT::logger::severity::Debug, __FILE__, __FUNCTION__, __LINE__, std::this_thread::get_id(), oss.view()); }
 #else
     #define LOG_Debug(message)      { }
 #endif
 
 #if LOG_LEVEL_ENABLED > 3
-    #define LOG_Trace(message)      { std::ostringstream oss{}; oss << message; AT::logger::log_msg(AT::logger::severity::Trace, __FILE__, __FUNCTION__, __LINE__, std::this_thread::get_id(), std::move(oss.str())); }
+    #define LOG_Trace(message)      { AT::logger::message_stream oss{}; oss << message; AT::logger::log_msg(AT::logger::severity::Trace, __FILE__, __FUNCTION__, __LINE__, std::this_thread::get_id(), oss.view()); }
 #else
     #define LOG_Trace(message)      { }
 #endif
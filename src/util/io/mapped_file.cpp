@@ -0,0 +1,106 @@
+#include "util/pch.h"
+
+#ifdef PLATFORM_WINDOWS
+
+	#include <Windows.h>
+
+#elif defined(PLATFORM_LINUX)
+
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+
+#else
+	#error undefined platform
+#endif
+
+#include "mapped_file.h"
+
+namespace AT::io {
+
+	mapped_file::mapped_file(const std::filesystem::path& path)
+		: m_path(path) {
+
+	#if defined(PLATFORM_LINUX)
+
+		const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		VALIDATE(fd >= 0, return, "", "Could not open [" << path.generic_string() << "] for mapping")
+
+		struct stat file_stat{};
+		if (::fstat(fd, &file_stat) != 0) {
+			LOG(Error, "Could not query size of [" << path.generic_string() << "]")
+			::close(fd);
+			return;
+		}
+
+		m_size = static_cast<size_t>(file_stat.st_size);
+		if (m_size == 0) {											// mmap() rejects zero-length mappings, an empty file is still a valid source
+			::close(fd);
+			m_valid = true;
+			return;
+		}
+
+		void* address = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);												// the mapping keeps its own reference to the file
+		VALIDATE(address != MAP_FAILED, m_size = 0; return, "", "Failed to map [" << path.generic_string() << "]")
+
+		m_data = static_cast<const u8*>(address);
+		m_valid = true;
+
+	#elif defined(PLATFORM_WINDOWS)
+
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		VALIDATE(file != INVALID_HANDLE_VALUE, return, "", "Could not open [" << path.generic_string() << "] for mapping")
+		m_file_handle = file;
+
+		LARGE_INTEGER file_size{};
+		VALIDATE(GetFileSizeEx(file, &file_size), return, "", "Could not query size of [" << path.generic_string() << "]")
+
+		m_size = static_cast<size_t>(file_size.QuadPart);
+		if (m_size == 0) {
+			m_valid = true;
+			return;
+		}
+
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		VALIDATE(mapping != nullptr, m_size = 0; return, "", "Failed to create file mapping for [" << path.generic_string() << "]")
+		m_mapping_handle = mapping;
+
+		m_data = static_cast<const u8*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		VALIDATE(m_data != nullptr, m_size = 0; return, "", "Failed to map [" << path.generic_string() << "]")
+		m_valid = true;
+
+	#endif
+	}
+
+
+	mapped_file::~mapped_file() {
+
+	#if defined(PLATFORM_LINUX)
+
+		if (m_data)
+			::munmap(const_cast<u8*>(m_data), m_size);
+
+	#elif defined(PLATFORM_WINDOWS)
+
+		if (m_data)
+			UnmapViewOfFile(m_data);
+		if (m_mapping_handle)
+			CloseHandle(m_mapping_handle);
+		if (m_file_handle)
+			CloseHandle(m_file_handle);
+
+	#endif
+	}
+
+
+	std::span<const u8> mapped_file::slice(const size_t offset, const size_t length) const {
+
+		if (offset > m_size || length > m_size - offset)
+			return {};
+
+		return std::span<const u8>(m_data + offset, length);
+	}
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+
+namespace AT::io {
+
+	// Read-only memory mapping of a complete file.
+	// The mapping is established in the constructor and released in the destructor, the content is only paged in when touched.
+	// Share it as ref<mapped_file> when views into the mapping can outlive the owner that created it.
+	class mapped_file {
+	public:
+
+		DELETE_COPY_MOVE_CONSTRUCTOR(mapped_file);
+
+		// Maps the file at [path] read-only. Check [is_valid()] afterwards, an empty file results in a valid but empty mapping.
+		// @param path The path to the file to be mapped.
+		mapped_file(const std::filesystem::path& path);
+
+		// Unmaps the file and closes all handles.
+		~mapped_file();
+
+		// @return true if the file could be opened and mapped (also true for empty files), false otherwise.
+		FORCEINLINE bool is_valid() const { return m_valid; }
+
+		// @return Pointer to the first byte of the mapping, nullptr for empty or invalid mappings.
+		FORCEINLINE const u8* data() const { return m_data; }
+
+		// @return The number of mapped bytes.
+		FORCEINLINE size_t size() const { return m_size; }
+
+		// @return A span covering the whole mapping.
+		FORCEINLINE std::span<const u8> get_span() const { return std::span<const u8>(m_data, m_size); }
+
+		// Returns a bounds-checked sub-range of the mapping.
+		// @param offset The byte offset of the slice.
+		// @param length The number of bytes in the slice.
+		// @return The requested span, or an empty span if [offset + length] exceeds the mapping.
+		std::span<const u8> slice(const size_t offset, const size_t length) const;
+
+		DEFAULT_GETTER_C(std::filesystem::path, path);
+
+	private:
+
+		std::filesystem::path		m_path{};
+		const u8*					m_data = nullptr;
+		size_t						m_size = 0;
+		bool						m_valid = false;
+	#if defined(PLATFORM_WINDOWS)
+		void*						m_file_handle = nullptr;
+		void*						m_mapping_handle = nullptr;
+	#endif
+	};
+
+}
@@ -1,24 +1,78 @@
-
 #include "util/pch.h"
 
 #include "serializer_binary.h"
 
 namespace AT::serializer {
 
-	binary::binary(const std::filesystem::path filename, const std::string& section_name, option option) 
+	#define BINARY_MAGIC						0x4E425441u			// "ATBN"
+	#define BINARY_BYTE_ORDER					0x0102u				// reads as 0x0201 on a machine with the other byte order
+	#define BINARY_FORMAT_VERSION				1u					// version of the container (header, sections), not of the content
+	#define BINARY_SECTION_MARKER				0x54434553u			// "SECT"
+	#define BINARY_SPARE_BUFFER_LIMIT			(16 * 1024 * 1024)	// larger buffers are released instead of kept for the next archive
+
+	struct file_header {
+		u32			magic = BINARY_MAGIC;
+		u16			byte_order = BINARY_BYTE_ORDER;
+		u16			format_version = BINARY_FORMAT_VERSION;
+		u32			version = 0;								// schema version of the caller
+		u32			name_hash = 0;
+	};
+
+	struct section_header {
+		u32			marker = BINARY_SECTION_MARKER;
+		u32			name_hash = 0;
+		u64			size = 0;									// payload bytes following this header
+	};
+
+	static_assert(sizeof(file_header) == 16 && sizeof(section_header) == 16, "binary layout changed, bump BINARY_FORMAT_VERSION");
+
+	thread_local std::vector<u8> binary::s_spare_buffer{};
+
+
+	// FNV-1a, stable across compilers and runs unlike std::hash
+	static u32 hash_name(const std::string& name) {
+
+		u32 hash = 0x811c9dc5;
+		for (const char character : name)
+			hash = (hash ^ static_cast<u8>(character)) * 0x01000193;
+		return hash;
+	}
+
+
+	bool binary::is_binary_file(const std::filesystem::path& filename, const std::string& section_name) {
+
+		std::ifstream stream(filename, std::ios::in | std::ios::binary);
+		file_header header{};
+		stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+		return stream.good() && header.magic == BINARY_MAGIC && header.byte_order == BINARY_BYTE_ORDER && header.format_version == BINARY_FORMAT_VERSION && header.name_hash == hash_name(section_name);
+	}
+
+
+	binary::binary(const std::filesystem::path filename, const std::string& section_name, option option, const u32 version) 
 	: m_filename(filename), m_name(section_name), m_option(option) {
 
-		// ASSERT(std::filesystem::is_regular_file(filename), "", "Provided filepath is not a file [" << filename.generic_string() << "]");
 		if (m_option == option::save_to_file) {
 
-			m_ostream = std::ofstream(m_filename, std::ios::out | std::ios::binary | std::ios::trunc);
-			VALIDATE(m_ostream, return, "", "Failed to save to file: [" << m_filename << "]");
+			m_buffer.swap(s_spare_buffer);									// starts with the capacity of the previous archive
+			m_buffer.clear();
+			m_valid = true;
+			m_version = version;
+			const file_header header{ BINARY_MAGIC, BINARY_BYTE_ORDER, BINARY_FORMAT_VERSION, m_version, hash_name(m_name) };
+			write(&header, sizeof(header));
 
 		} else {
 
-			m_istream = std::ifstream(m_filename, std::ios::in | std::ios::binary);
-			VALIDATE(m_istream, return, "", "Failed to load file: [" << m_filename << "]");
-
+			m_file = create_ref<io::mapped_file>(m_filename);
+			VALIDATE(m_file->is_valid(), return, "", "Failed to load file: [" << m_filename << "]");
+
+			m_file_size = m_file->size();
+			m_valid = true;
+			file_header header{};
+			VALIDATE(read(&header, sizeof(header)) && header.magic == BINARY_MAGIC, m_valid = false; return, "", "[" << m_filename.generic_string() << "] is not a binary file")
+			VALIDATE(header.byte_order == BINARY_BYTE_ORDER, m_valid = false; return, "", "[" << m_filename.generic_string() << "] was written with a different byte order")
+			VALIDATE(header.format_version == BINARY_FORMAT_VERSION, m_valid = false; return, "", "[" << m_filename.generic_string() << "] has unsupported format version [" << header.format_version << "]")
+			VALIDATE(header.name_hash == hash_name(m_name), m_valid = false; return, "", "[" << m_filename.generic_string() << "] does not contain [" << m_name << "]")
+			m_version = header.version;
 		}
 
 	}
@@ -27,12 +81,81 @@ namespace AT::serializer {
 
 		if (m_option == option::save_to_file) {
 
-			m_ostream.close();
+			flush();
+			m_buffer.clear();
+			if (m_buffer.capacity() > s_spare_buffer.capacity() && m_buffer.capacity() <= BINARY_SPARE_BUFFER_LIMIT)
+				m_buffer.swap(s_spare_buffer);
+		}
+	}
 
-		} else {
 
-			m_istream.close();
+	bool binary::flush() {
+
+		if (m_option != option::save_to_file || m_flushed)
+			return m_valid;
+
+		m_flushed = true;
+		std::ofstream stream(m_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+		stream.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+		stream.close();
+		m_valid = !stream.fail();
+		VALIDATE(m_valid, return false, "", "Failed to save to file: [" << m_filename << "]");
+		return true;
+	}
+
+
+	binary& binary::section(const std::string& name, std::function<void(AT::serializer::binary&)> section_function) {
+
+		section_header header{ BINARY_SECTION_MARKER, hash_name(name), 0 };
+		if (m_option == option::save_to_file) {
+
+			const size_t start = m_buffer.size();
+			write(&header, sizeof(header));
+			section_function(*this);
+
+			header.size = m_buffer.size() - start - sizeof(header);			// patch the size now that the payload is written
+			std::memcpy(m_buffer.data() + start, &header, sizeof(header));
+			return *this;
+		}
+
+		if (!m_valid)
+			return *this;
+
+		// skip sections a newer version added in front of this one
+		const u64 start = m_position;
+		while (get_remaining_bytes() >= sizeof(section_header)) {
+
+			section_header found{};
+			read(&found, sizeof(found));
+			if (found.marker != BINARY_SECTION_MARKER || found.size > get_remaining_bytes())
+				break;														// not a section (plain entries follow), or damaged
+
+			if (found.name_hash != header.name_hash) {
+				m_position += found.size;
+				continue;
+			}
+
+			const u64 end = m_position + found.size;
+			m_section_ends.push_back(end);
+			section_function(*this);
+			m_section_ends.pop_back();
+
+			if (m_valid)
+				m_position = end;											// skip data a newer version appended to the section
+			return *this;
 		}
+
+		LOG(Trace, "Section [" << name << "] not found in [" << m_filename.generic_string() << "], keeping defaults")
+		m_position = start;
+		return *this;
+	}
+
+
+	void binary::fail(const char* what, const u64 value) {
+
+		if (m_valid)
+			LOG(Error, what << " [" << value << "] exceeds the rest of [" << m_filename.generic_string() << "] at offset [" << m_position << "]")
+		m_valid = false;
 	}
 
 }
@@ -1,9 +1,22 @@
 #pragma once
 
 #include "serializer_data.h"
+#include "util/io/mapped_file.h"
 
 namespace AT::serializer {
 
+	// Binary (de)serializer for data that is read back by the same application (caches, project files).
+	//
+	// File layout:
+	//   [file header] u32 magic ("ATBN"), u16 byte order marker, u16 format version, u32 schema version, u32 hash of the section name
+	//   [payload]     the entries in the order they were written, sections are stored as
+	//                 u32 marker ("SECT"), u32 hash of the name, u64 payload size, payload
+	//
+	// The schema version is chosen by the caller when saving and reported by [get_version()] when loading, so readers can branch on it.
+	// Unknown sections are skipped and bytes a newer writer appended to a section are ignored, so adding data stays readable by older versions.
+	// Files are written in the byte order of the machine, loading a file of the other byte order fails (see [is_valid()]).
+	// Saving assembles the file in a memory buffer that is written with one call in [flush()], loading maps the file and copies
+	// out of bounds-checked slices of the mapping, reading past the end of the file or the current section fails the archive.
 	class binary {
 	public:
 
@@ -14,33 +27,59 @@ namespace AT::serializer {
 		// @return The current serialization option.
 		DEFAULT_GETTER(option, option);
 
+		// The schema version, the one passed to the constructor when saving, the one stored in the file when loading.
+		// @return The schema version, 0 if the file header could not be read.
+		DEFAULT_GETTER_C(u32, version);
+
+		// The mapping of the loaded file, hold it to keep spans returned by [view()] valid after the archive is destroyed.
+		// @return The mapping, nullptr when saving.
+		DEFAULT_GETTER_C(ref<io::mapped_file>, file);
+
+
+		// Reports whether the file could be opened and every read/write so far succeeded.
+		// @return false after a failed open, a missing or foreign file header, a short read (truncated file) or a failed [flush()].
+		FORCEINLINE bool is_valid() const { return m_valid; }
+
+
+		// Checks the file header without reading the payload.
+		// @param filename The file to check.
+		// @param section_name The section name the file was saved with.
+		// @return true if [filename] was written by [binary] with [section_name] in the byte order of this machine.
+		static bool is_binary_file(const std::filesystem::path& filename, const std::string& section_name);
+
 
 		// Constructs a binary serializer/deserializer for the given file and section.
-		// When [option] is save_to_file the object opens the file for binary output;
-		// otherwise it opens the file for binary input.
+		// When [option] is save_to_file the object starts the file buffer with the file header, the file itself is only touched by [flush()];
+		// otherwise it maps the file and validates the file header.
 		// @param filename The path to the file to read from or write to.
-		// @param section_name A human-readable name for the section being (de)serialized.
+		// @param section_name A human-readable name for the section being (de)serialized, loading a file saved with a different name fails.
 		// @param option Controls whether the instance is used to save to or load from file.
+		// @param version Schema version stored in the header when saving, ignored when loading.
 		// @return Constructs a binary object ready to perform (de)serialization.
-		binary(const std::filesystem::path filename, const std::string& section_name, option option);
+		binary(const std::filesystem::path filename, const std::string& section_name, option option, const u32 version = 0);
 
 
-		// Destroys the binary (de)serializer and closes any open file streams.
-		// If the object opened an output stream it will be closed; likewise for input streams.
+		// Destroys the binary (de)serializer, saving calls [flush()] if it was not called yet.
 		// @return None.
 		~binary();
 
 
+		// Writes the buffered file with a single write, replacing the file. Entries added afterwards are not written.
+		// Call it explicitly to learn whether the write succeeded, the destructor calls it otherwise.
+		// @return true if the file was written (always true when loading, unless the archive is invalid).
+		bool flush();
+
+
 		// Serializes or deserializes a single value depending on the configured option.
 		// If saving:
 		//   - For std::filesystem::path: converts to a string and serializes that string.
-		//   - For std::string: writes a length (size_t) followed by the raw characters.
+		//   - For std::string: writes a length (size_t) followed by the raw characters (UTF-8, no length limit).
 		//   - For other types: writes raw bytes of sizeof(T).
 		// If loading:
 		//   - For std::filesystem::path: reads a string and constructs the path from it.
-		//   - For std::string: reads a length then fills the string buffer from the stream.
+		//   - For std::string: reads a length then copies the characters out of the mapping.
 		//   - For other types: reads raw bytes into the provided value.
-		// @tparam T The type of the value to (de)serialize.
+		// @tparam T The type of the value to (de)serialize, must be trivially copyable unless it is a string or path.
 		// @param value Reference to the value to serialize (when saving) or to receive the value (when loading).
 		// @return A reference to *this to allow chaining of entry(...) calls.
 		template<typename T>
@@ -56,11 +95,14 @@ namespace AT::serializer {
 				} else if constexpr (std::is_same_v<T, std::string>) {
 
 					size_t length = value.size();
-					m_ostream.write(reinterpret_cast<const char*>(&length), sizeof(length));
-					m_ostream.write(reinterpret_cast<const char*>(value.data()), length);
+					write(&length, sizeof(length));
+					write(value.data(), length);
+
+				} else {
 
-				} else
-					m_ostream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+					static_assert(std::is_trivially_copyable_v<T>, "binary::entry() writes raw bytes, use section() or vector() with a callback for this type");
+					write(&value, sizeof(T));
+				}
 
 			} else {
 
@@ -73,25 +115,29 @@ namespace AT::serializer {
 				} else if constexpr (std::is_same_v<T, std::string>) {
 
 					size_t length = 0;
-					m_istream.read(reinterpret_cast<char*>(&length), sizeof(length));
-					
-					ASSERT(length < 65565, "", "Corrupted path length")
+					if (read(&length, sizeof(length)) && length <= get_remaining_bytes()) {
+
+						value.assign(reinterpret_cast<const char*>(m_file->data() + m_position), length);
+						m_position += length;
+					} else
+						fail("String length", length);
 
-					value.resize(length);
-					m_istream.read(value.data(), length);
+				} else {
 
-				} else
-					m_istream.read(reinterpret_cast<char*>(&value), sizeof(T));
+					static_assert(std::is_trivially_copyable_v<T>, "binary::entry() reads raw bytes, use section() or vector() with a callback for this type");
+					read(&value, sizeof(T));
+				}
 			}
 
 			return *this;
 		}
 
 
-		// Serializes or deserializes a contiguous std::vector<T>.
-		// If saving: writes the vector's size (size_t) followed by the raw element bytes (sizeof(T) * size).
-		// If loading: reads the size, resizes the vector, then reads raw element bytes into vector.data().
-		// NOTE: This assumes T is trivially copyable / safely writable as raw bytes.
+		// Serializes or deserializes a std::vector<T>.
+		// Trivially copyable elements are written as one block: the vector's size (size_t) followed by the raw element bytes (sizeof(T) * size).
+		// Other elements (e.g. std::string) are written one by one through [entry()] after the size.
+		// If loading: reads the size, then fills the vector the same way.
+		//             A size larger than the rest of the file fails the stream (see [is_valid()]) instead of allocating.
 		// @tparam T The vector element type.
 		// @param vector The vector to write (when saving) or to fill (when loading).
 		// @return A reference to *this to allow chaining.
@@ -101,15 +147,41 @@ namespace AT::serializer {
 			if (m_option == option::save_to_file) {
 
 				size_t size = vector.size();
-				m_ostream.write(reinterpret_cast<const char*>(&size), sizeof(size_t));
-				m_ostream.write(reinterpret_cast<const char*>(vector.data()), sizeof(T) * size);
+				write(&size, sizeof(size_t));
+				if constexpr (std::is_trivially_copyable_v<T>)
+					write(vector.data(), sizeof(T) * size);
+				else
+					for (auto& element : vector)
+						entry(element);
 
 			} else {
 
 				size_t vector_size = 0;
-				m_istream.read(reinterpret_cast<char*>(&vector_size), sizeof(size_t));
-				vector.resize(vector_size);
-				m_istream.read(reinterpret_cast<char*>(vector.data()), sizeof(T) * vector_size);
+				if (!read(&vector_size, sizeof(size_t)))
+					return *this;
+
+				if constexpr (std::is_trivially_copyable_v<T>) {
+
+					if (vector_size > get_remaining_bytes() / sizeof(T)) {
+						fail("Vector size", vector_size);
+						return *this;
+					}
+
+					vector.resize(vector_size);
+					read(vector.data(), sizeof(T) * vector_size);
+
+				} else {
+
+					if (vector_size > get_remaining_bytes()) {
+						fail("Vector size", vector_size);
+						return *this;
+					}
+
+					vector.clear();
+					vector.reserve(vector_size);
+					for (size_t x = 0; x < vector_size && m_valid; x++)
+						entry(vector.emplace_back());
+				}
 			}
 
 			return *this;
@@ -117,7 +189,7 @@ namespace AT::serializer {
 
 
 		// Serializes or deserializes a raw array region of known size.
-		// If saving: writes the array data (sizeof(T) * array_size) from array_start to the output stream.
+		// If saving: writes the array data (sizeof(T) * array_size) from array_start to the file buffer.
 		// If loading: allocates a buffer with malloc(sizeof(T) * array_size), reads bytes into it,
 		//             and assigns the pointer to array_start. Caller becomes the owner and is responsible for freeing it.
 		// WARNING: On load ownership transfers to the caller; memory is allocated with malloc.
@@ -130,43 +202,139 @@ namespace AT::serializer {
 
 			const size_t total_bytes = sizeof(T) * array_size;
 			if (m_option == option::save_to_file) {
-				m_ostream.write(reinterpret_cast<const char*>(array_start), total_bytes);
+				write(array_start, total_bytes);
 			} else {
 
 				array_start = (T*)malloc(total_bytes);
 				LOG(Trace, "Deserializing [" << total_bytes << "] bytes into [" << (void*)array_start << "]")
-				m_istream.read(reinterpret_cast<char*>(array_start), total_bytes);
+				read(array_start, total_bytes);
 			}
 
 			return *this;
 		}
 
 
-		// Placeholder for serializing/deserializing a vector with a custom per-element callback.
-		// Currently unimplemented — logs an error and returns immediately.
-		// Intended behavior (when implemented): iterate elements and call vector_function for each element,
-		// allowing custom (de)serialization logic for complex element types.
-		// @tparam T The vector element type.
+		// Returns the next [size] bytes of the loaded file without copying them and moves the read position past them.
+		// Only valid when loading, pair it with a raw write of the same bytes (e.g. [entry()] of a std::vector<char> after its size).
+		// @param size The number of bytes.
+		// @return A span into the mapping (see [get_file()]), empty and the archive invalid if fewer than [size] bytes are left.
+		std::span<const u8> view(const size_t size) {
+
+			if (m_option == option::save_to_file)
+				return {};
+
+			if (!m_valid || size > get_remaining_bytes()) {
+				fail("View size", size);
+				return {};
+			}
+
+			const std::span<const u8> result = m_file->slice(m_position, size);
+			m_position += size;
+			return result;
+		}
+
+
+		// Serializes or deserializes a vector whose elements need custom (de)serialization (nested structures, strings, ...).
+		// If saving: writes the element count (u64), then calls [vector_function] for every element.
+		// If loading: reads the count, then appends one default constructed element per iteration before calling [vector_function],
+		//             so the callback can fill [vector[iteration]]. Stops early if the stream fails.
+		// @tparam T The vector element type, must be default constructible.
 		// @param vector The vector to operate on.
 		// @param vector_function A callback that performs (de)serialization per element.
 		//                        Signature: void(AT::serializer::binary&, const u64 iteration)
-		// @return A reference to *this (currently the function returns immediately after logging).
+		// @return A reference to *this to allow chaining.
 		template<typename T>
 		binary& vector(std::vector<T>& vector, std::function<void(AT::serializer::binary&, const u64 iteration)> vector_function) {
 
-			LOG(Error, "NOT IMPLEMENTED YET");
+			if (m_option == option::save_to_file) {
+
+				u64 size = vector.size();
+				entry(size);
+				for (u64 x = 0; x < size; x++)
+					vector_function(*this, x);
+
+			} else {
+
+				u64 size = 0;
+				if (!read(&size, sizeof(size)))
+					return *this;
+
+				vector.clear();
+				vector.reserve(static_cast<size_t>(std::min<u64>(size, get_remaining_bytes())));		// a damaged count can not reserve more than the file holds
+				for (u64 x = 0; x < size && m_valid; x++) {
+
+					vector.emplace_back();
+					vector_function(*this, x);
+				}
+			}
+
 			return *this;
 		}
 
 
+		// Groups entries into a named section that readers can skip.
+		// If saving: writes the section header, calls [section_function] and patches the payload size into the header.
+		// If loading: skips unknown sections until one with [name] is found, calls [section_function] and moves to the end of the section,
+		//             so data a newer version appended to the section is ignored. If the section is missing (older file) the callback is
+		//             not called, the read position stays where it was and the values keep their defaults.
+		// Sections have to be read in the order they were written, they can be nested.
+		// @param name The name of the section, only its hash is stored.
+		// @param section_function A callback that performs the (de)serialization of the section content.
+		//                         Signature: void(AT::serializer::binary&)
+		// @return A reference to *this to allow chaining.
+		binary& section(const std::string& name, std::function<void(AT::serializer::binary&)> section_function);
+
+
 	private:
 
+		// Logs the first failed read and invalidates the archive, every later read fails without touching the mapping.
+		void fail(const char* what, const u64 value);
+
+		// Appends [size] bytes to the file buffer.
+		FORCEINLINE void write(const void* data, const size_t size) {
+
+			const u8* bytes = static_cast<const u8*>(data);
+			m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+		}
+
+		// Copies [size] bytes from the read position, fails the archive instead of reading past the end of the current section or file.
+		// @return true if the bytes were read.
+		FORCEINLINE bool read(void* data, const size_t size) {
+
+			if (!m_valid || size > get_remaining_bytes()) {
+				fail("Read size", size);
+				return false;
+			}
+
+			if (size)
+				std::memcpy(data, m_file->data() + m_position, size);
+			m_position += size;
+			return true;
+		}
+
+		// @return The bytes between the read position and the end of the current section (or file), guards sizes read from the file before allocating.
+		FORCEINLINE u64 get_remaining_bytes() const {
+
+			const u64 end = m_section_ends.empty() ? m_file_size : m_section_ends.back();
+			return (m_position < end) ? end - m_position : 0;
+		}
+
 		std::filesystem::path 		m_filename{};
 		std::string 				m_name{};
 		option 						m_option;
-		std::ofstream 				m_ostream{};
-		std::ifstream 				m_istream{};
-
+		u32 						m_version = 0;
+		bool 						m_valid = false;
+
+		// saving
+		std::vector<u8> 			m_buffer{};					// the whole file, written by [flush()]
+		bool 						m_flushed = false;
+		static thread_local std::vector<u8> s_spare_buffer;		// capacity of the last buffer, reused by the next archive on this thread
+
+		// loading
+		ref<io::mapped_file> 		m_file{};
+		u64 						m_file_size = 0;
+		u64 						m_position = 0;				// read offset into [m_file]
+		std::vector<u64> 			m_section_ends{};			// end offset of every section that is currently read, innermost last
 	};
 
 }
\ No newline at end of file
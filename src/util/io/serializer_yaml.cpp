@@ -9,6 +9,8 @@ namespace AT::serializer {
 
 	// ================================================== yaml ==================================================
 
+	thread_local std::string yaml::s_spare_output{};
+
 	yaml::yaml(const std::filesystem::path filename, const std::string& section_name, option option)
 		: m_filename(filename), m_name(section_name), m_option(option) {
 
@@ -28,7 +30,9 @@ namespace AT::serializer {
 
 		else {
 
-			m_file_content << section_name << ":\n";
+			m_output.swap(s_spare_output);							// reuse the capacity of the previous save on this thread
+			m_output.clear();
+			write_key(0, {}, section_name);
 			m_level_of_indention = 1;
 		}
 
@@ -36,201 +40,240 @@ namespace AT::serializer {
 
 	yaml::~yaml() {
 
-		if (m_option == option::save_to_file)
+		if (m_option == option::save_to_file) {
+
 			serialize();
+			if (m_output.capacity() > s_spare_output.capacity())
+				s_spare_output.swap(m_output);
+		}
 	}
 
+	// Splices the written section into the file: one read of the old content, one write of the result.
+	// The section replaces the top-level block with the same name (up to the next line at indentation 0) or is appended.
 	void yaml::serialize() {
 
-		auto istream = std::ifstream(m_filename);
-		ASSERT(istream.is_open(), "", "input-file-stream is not open");
-
-		// make new stream to buffer updated file
-		std::ostringstream updated_file;
-
-		// copy content of file that is not the focus of this serialization
-		bool found = false;				// ensure only one section can be skipped
-		std::string line = "";
-		while (std::getline(istream, line)) {
-
-			// is correct section
-			if (!found && (line.find(m_name + ":") != std::string::npos) && (util::measure_indentation(line, NUM_OF_INDENTING_SPACES) == 0)) {
+		std::string content;
+		{
+			std::ifstream istream(m_filename, std::ios::binary | std::ios::ate);
+			ASSERT(istream.is_open(), "", "input-file-stream is not open");
+			content.resize(static_cast<size_t>(istream.tellg()));
+			istream.seekg(0);
+			istream.read(content.data(), static_cast<std::streamsize>(content.size()));
+		}
 
-				found = true;
+		size_t section_begin = std::string::npos;
+		size_t section_end = content.size();
+		for (size_t line_start = 0; line_start < content.size();) {
 
-				// override section with new content
-				updated_file << m_file_content.str();
+			size_t line_end = content.find('\n', line_start);
+			if (line_end == std::string::npos)
+				line_end = content.size();
 
-				// SKIP CONTENT
-				while (std::getline(istream, line)) {
+			std::string_view line(content.data() + line_start, line_end - line_start);
+			if (!line.empty() && line.back() == '\r')
+				line.remove_suffix(1);
 
-					if (line.back() == ':' && util::measure_indentation(line, NUM_OF_INDENTING_SPACES) == 0) {	// still in section ??
+			if (!line.empty() && line.front() != ' ' && line.front() != '#') {				// top-level key
 
-						updated_file << line + "\n";
-						break;
-					}
+				if (section_begin != std::string::npos) {
+					section_end = line_start;
+					break;
 				}
-			}
 
-			else
-				updated_file << line + "\n";
+				if (line.size() > m_name.size() && line.compare(0, m_name.size(), m_name) == 0 && line[m_name.size()] == ':'
+					&& line.find_first_not_of(' ', m_name.size() + 1) == std::string_view::npos)
+					section_begin = line_start;
+			}
+			line_start = line_end + 1;
 		}
 
-		// apend if section not found
-		if (!found)
-			updated_file << m_file_content.str();
+		if (section_begin == std::string::npos) {										// apend if section not found
 
-		istream.close();
+			if (!content.empty() && content.back() != '\n')
+				content.push_back('\n');
+			content.append(m_output);
 
-		auto ostream = std::ofstream(m_filename);
-		ASSERT(ostream.is_open(), "", "output-file-stream is not open");
+		} else
+			content.replace(section_begin, section_end - section_begin, m_output);
 
-		ostream << updated_file.str();
-		ostream.close();
+		// written next to the file and renamed over it, a crash mid-write leaves the previous version intact
+		std::filesystem::path temp_filename = m_filename;
+		temp_filename += ".tmp";
+		{
+			auto ostream = std::ofstream(temp_filename, std::ios::binary | std::ios::trunc);
+			ASSERT(ostream.is_open(), "", "output-file-stream is not open");
+			ostream.write(content.data(), static_cast<std::streamsize>(content.size()));
+			VALIDATE(ostream.flush(), std::filesystem::remove(temp_filename); return, "", "Could not write [" << temp_filename.generic_string() << "]")
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temp_filename, m_filename, error);
+		VALIDATE(!error, return, "", "Could not replace [" << m_filename.generic_string() << "]: " << error.message())
 	}
 
 	yaml& yaml::deserialize() {
 
 		ASSERT(!m_name.empty(), "", "name of section to find is empty");
 
-		m_istream = std::ifstream(m_filename);
-		VALIDATE(m_istream.is_open(), return *this, "", "file-stream is not open");
+		std::ifstream istream(m_filename, std::ios::binary | std::ios::ate);
+		VALIDATE(istream.is_open(), return *this, "", "file-stream is not open");
 
-		const u32 SECTION_INDENTATION = 0;
-		bool found_section = false;
-		std::string line;
-		while (std::getline(m_istream, line)) {
+		m_buffer.resize(static_cast<size_t>(istream.tellg()));
+		istream.seekg(0);
+		istream.read(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+		istream.close();
 
-			// skip empty lines or comments
-			if (line.empty() || line.front() == '#')
-				continue;
+		tokenize(m_buffer);
+		m_scope = { m_nodes.empty() ? INVALID_NODE : 0, INVALID_NODE };
+		return *this;
+	}
+
+	// Builds the node tree of section [m_name] in a single pass over the file.
+	// Nesting follows the indentation: a line belongs to the closest open "key:" that is less indented, sequence items ("- ")
+	// may sit at the same indentation as their key. Every other top-level section is skipped without creating nodes.
+	void yaml::tokenize(const std::string_view content) {
 
-			// if line contains desired section enter inner-loop
-			if (line.find(m_name + ":") != std::string::npos && util::measure_indentation(line, NUM_OF_INDENTING_SPACES) == 0) {
+		struct open_node {
+			u32			node;
+			size_t		column;			// column of the key, or of the dash for sequence items
+			bool		is_item;
+		};
+		std::vector<open_node> stack;
 
-				found_section = true;
+		bool in_section = false;
+		size_t line_start = 0;
+		while (line_start < content.size()) {
 
-				//     not end of file                   line has more leading spaces
-				while (std::getline(m_istream, line) && (util::measure_indentation(line, NUM_OF_INDENTING_SPACES) > SECTION_INDENTATION)) {
+			size_t line_end = content.find('\n', line_start);
+			if (line_end == std::string_view::npos)
+				line_end = content.size();
+
+			std::string_view line = content.substr(line_start, line_end - line_start);
+			line_start = line_end + 1;
+			if (!line.empty() && line.back() == '\r')
+				line.remove_suffix(1);
+
+			// skip empty lines or comments
+			const size_t column = line.find_first_not_of(' ');
+			if (column == std::string_view::npos || line[column] == '#')
+				continue;
 
-					line = line.substr(NUM_OF_INDENTING_SPACES);
+			if (column == 0) {
 
-					//  more indented                                         is sub-section        is array-element
-					if ((util::measure_indentation(line, NUM_OF_INDENTING_SPACES) > SECTION_INDENTATION) || line.back() == ':' || line.front() == '-') {
+				if (in_section)												// the next top-level section starts, done
+					break;
 
-						m_file_content << line << '\n';
-						continue;
-					}
+				const size_t colon = line.find(':');
+				if (colon != std::string_view::npos && line.substr(0, colon) == m_name && line.find_first_not_of(' ', colon + 1) == std::string_view::npos) {
 
-					std::string key, value;
-					extract_key_value(key, value, line);
-					m_key_value_pares[key] = value;
+					in_section = true;
+					m_nodes.push_back(node{ line.substr(0, colon) });
+					stack.push_back({ 0, 0, false });
 				}
+				continue;
 			}
 
-			// exit outer loop if inner-loop already done
-			if (found_section)
-				break;
-
-		}
-		return *this;
-	}
+			if (!in_section)
+				continue;
 
-	void yaml::extract_key_value(std::string& key, std::string& value, std::string& line) {
+			std::string_view text = line.substr(column);
+			const bool is_item = (text.front() == '-') && (text.size() == 1 || text[1] == ' ');
 
-		std::istringstream iss(line);
-		std::getline(iss, key, ':');
-		std::getline(iss, value);
+			// close every node this line is not part of
+			while (stack.size() > 1) {
 
-		if (const u32 indentation = util::measure_indentation(key, 1); indentation > 0)
-			key = key.substr(indentation);
+				const open_node& top = stack.back();
+				if (column > top.column || (is_item && !top.is_item && column == top.column))
+					break;
 
-		if (!value.empty() && value.front() == ' ')
-			value.erase(0, 1);
-	}
+				stack.pop_back();
+			}
 
-	yaml& yaml::sub_section(const std::string& section_name, std::function<void(serializer::yaml&)> sub_section_function) {
+			u32 parent = stack.back().node;
+			size_t key_column = column;
+			if (is_item) {
 
-		m_level_of_indention++;
+				text = (text.size() > 2) ? text.substr(2) : std::string_view{};
+				parent = add_node(parent, {}, text);						// keeps the raw element text for plain vectors/sets
+				stack.push_back({ parent, column, true });
+				key_column = column + NUM_OF_INDENTING_SPACES;				// "- key: value" opens a map inside the element
+			}
 
-		if (m_option == serializer::option::save_to_file) {
+			const size_t colon = text.find(':');
+			if (colon == std::string_view::npos)
+				continue;
 
-			m_file_content << util::add_spaces(m_level_of_indention + static_cast<u32>(vector_func_index -1), NUM_OF_INDENTING_SPACES) << section_name << ":\n";
-			sub_section_function(*this);
+			std::string_view value = text.substr(colon + 1);
+			const bool is_container = value.empty();						// "key:" starts a sub-section, vector or map
+			if (!value.empty() && value.front() == ' ')
+				value.remove_prefix(1);
 
-		} else {	// load from file
+			const u32 index = add_node(parent, text.substr(0, colon), value);
+			if (is_container)
+				stack.push_back({ index, key_column, false });
+		}
+	}
 
-			// buffer [m_key_value_pares] for duration of function
-			std::unordered_map<std::string, std::string> key_value_pares_buffer = m_key_value_pares;
-			m_key_value_pares = {};
+	u32 yaml::add_node(const u32 parent, const std::string_view key, const std::string_view value) {
 
-			// buffer [m_file_content] for duration of function
-			std::stringstream file_content_buffer;
-			file_content_buffer << m_file_content.str();
-			m_file_content = {};
+		const u32 index = static_cast<u32>(m_nodes.size());
+		m_nodes.push_back(node{ key, value });
 
-			// deserialize content of subsections				
-			// const u32 section_indentation = 0;
-			bool found_section = false;
-			std::string line;
-			//m_level_of_indention++;
-			while (std::getline(file_content_buffer, line)) {
+		node& parent_node = m_nodes[parent];
+		if (parent_node.last_child == INVALID_NODE)
+			parent_node.first_child = index;
+		else
+			m_nodes[parent_node.last_child].next_sibling = index;
+		parent_node.last_child = index;
+		return index;
+	}
 
-				// skip empty lines or comments
-				if (line.empty() || line.front() == '#')
-					continue;
+	u32 yaml::find_child(const std::string_view key) {
 
-				// if line contains desired section enter inner-loop
-				//   has incorrect indentaion											ends NOT with double-point
-				if ((util::measure_indentation(line, NUM_OF_INDENTING_SPACES) != 0) || (line.back() != ':'))
-					continue;
+		if (m_scope.node == INVALID_NODE)
+			return INVALID_NODE;
 
-				// remove leading and trailing whitespace
-				auto trimmed = line;
-				trimmed.erase(trimmed.begin(), std::find_if(trimmed.begin(), trimmed.end(), [](unsigned char ch) {
-					return !std::isspace(ch);
-				}));
-				trimmed.erase(std::find_if(trimmed.rbegin(), trimmed.rend(), [](unsigned char ch) {
-					return !std::isspace(ch);
-				}).base(), trimmed.end());
+		const u32 first = m_nodes[m_scope.node].first_child;
+		const u32 start = (m_scope.hint != INVALID_NODE) ? m_scope.hint : first;
+		for (u32 child = start; child != INVALID_NODE; child = m_nodes[child].next_sibling)
+			if (m_nodes[child].key == key) {
+				m_scope.hint = m_nodes[child].next_sibling;
+				return child;
+			}
 
-				// Remove the trailing colon
-				if (!trimmed.empty() && trimmed.back() == ':')
-					trimmed.pop_back();
+		for (u32 child = first; child != start; child = m_nodes[child].next_sibling)		// wrap around for out-of-order reads
+			if (m_nodes[child].key == key) {
+				m_scope.hint = m_nodes[child].next_sibling;
+				return child;
+			}
 
-				if (trimmed != section_name)		// has incorrect section_name
-					continue;
+		return INVALID_NODE;
+	}
 
-				found_section = true;
+	yaml::scope yaml::enter_scope(const u32 node) {
 
-				while (std::getline(file_content_buffer, line)) {
+		const scope previous = m_scope;
+		m_scope = { node, INVALID_NODE };
+		return previous;
+	}
 
-					if (util::measure_indentation(line, NUM_OF_INDENTING_SPACES) < m_level_of_indention)	// exit inner loop after section is finished
-						break;		
+	yaml& yaml::sub_section(const std::string& section_name, std::function<void(serializer::yaml&)> sub_section_function) {
 
-					line = line.substr(NUM_OF_INDENTING_SPACES);
+		m_level_of_indention++;
 
-					//  more indented																		beginning of new sub-section
-					if (util::measure_indentation(line, NUM_OF_INDENTING_SPACES) > m_level_of_indention -1 || line.back() == ':' || line.front() == '-') {
+		if (m_option == serializer::option::save_to_file) {
 
-						m_file_content << line << "\n";
-						continue;
-					}
+			write_key(m_level_of_indention + static_cast<u32>(vector_func_index -1), {}, section_name);
+			sub_section_function(*this);
 
-					std::string key, value;
-					extract_key_value(key, value, line);
-					m_key_value_pares[key] = value;
-				}
+		} else {	// load from file
 
-				if (found_section)
-					break;
-			}
+			if (const u32 found = find_child(section_name); found != INVALID_NODE) {
 
-			if (found_section)
+				const scope outer_scope = enter_scope(found);
 				sub_section_function(*this);
-
-			m_key_value_pares = key_value_pares_buffer;
-			m_file_content << file_content_buffer.str();
+				m_scope = outer_scope;
+			}
 		}
 
 		m_level_of_indention--;
@@ -40,71 +40,38 @@ namespace AT::serializer {
 
 			if (m_option == serializer::option::save_to_file) {
 
-				std::string buffer{};
 				if constexpr (is_vector<T>::value) {			// value is a vector
 
-					m_file_content << util::add_spaces(m_level_of_indention) << m_prefix << key_name << ":\n";
-					for (auto interation : value) {
+					write_key(m_level_of_indention, m_prefix, key_name);
+					for (const auto& interation : value) {
 
-						util::convert_to_string<T::value_type>(interation, buffer);
-						m_file_content << util::add_spaces(m_level_of_indention + 1) << "- " << buffer << "\n";
+						util::convert_to_string<typename T::value_type>(interation, m_value_buffer);
+						write_element(m_level_of_indention + 1, m_value_buffer);
 					}
 
 				} else {
 
-					util::convert_to_string<T>(value, buffer);
-					m_file_content << util::add_spaces(m_level_of_indention) << m_prefix << key_name << ": " << buffer << "\n";
+					util::convert_to_string<T>(value, m_value_buffer);
+					write_key_value(m_level_of_indention, m_prefix, key_name, m_value_buffer);
 				}
 
 			} else {				// load from file
 
-				if constexpr (is_vector<T>::value) {			// value is a vector
-
-					// deserialize content of subsections				
-					T buffer{};
-					u32 section_indentation = 0;
-					bool found_section = false;
-					std::string line;
-					while (std::getline(m_file_content, line)) {
-
-						// skip empty lines or comments
-						if (line.empty() || line.front() == '#')
-							continue;
-
-						// if line contains desired section enter inner-loop
-						//   has correct indentaion                                 has correct section_name                      ends with double-point
-						if ((util::measure_indentation(line) == 0) && (line.find(key_name) != std::string::npos) && (line.back() == ':')) {
-
-							found_section = true;
-							//LOG(Debug, "sub_section() found section => line: [" << line << "]");
-
-							//     not end of content                     has correct indentaion                                 doesn't end in double-points              
-							while (std::getline(m_file_content, line) && (util::measure_indentation(line) == 1) && (line.back() != ':')) {
+				const u32 found = find_child(key_name);
+				if (found == INVALID_NODE)										// key is not in this section
+					return *this;
 
-								// remove indentation                       remove "- " (array element marker)
-								line = line.substr(NUM_OF_INDENTING_SPACES + 2);
-								util::convert_from_string(line, buffer);
-								value.emplace_back(buffer);
-							}
+				if constexpr (is_vector<T>::value) {			// value is a vector
 
-							//LOG(Debug, "END OF SUB-SECTION");
-						}
+					typename T::value_type buffer{};
+					for (u32 item = m_nodes[found].first_child; item != INVALID_NODE; item = m_nodes[item].next_sibling) {
 
-						// skip rest of content if section found
-						if (found_section)
-							break;
+						util::convert_from_string(std::string(m_nodes[item].value), buffer);
+						value.emplace_back(buffer);
 					}
 
-				} else {
-
-					std::string buffer{};
-					auto iterator = m_key_value_pares.find(key_name);
-					if (iterator == m_key_value_pares.end())				// key is not in map
-						return *this;
-
-					buffer = iterator->second;
-					util::convert_from_string(buffer, value);
-				}
+				} else
+					util::convert_from_string(std::string(m_nodes[found].value), value);
 			}
 
 			m_prefix = m_prefix_fallback;
@@ -135,7 +102,7 @@ namespace AT::serializer {
 			if (m_option == serializer::option::save_to_file) {			// save to file
 
 				const u32 indent_buffer = vector_func_index != 1 ? m_level_of_indention - 1 : m_level_of_indention;
-				m_file_content << util::add_spaces(indent_buffer) << m_prefix << vector_name << ":\n";
+				write_key(indent_buffer, m_prefix, vector_name);
 				for (u64 x = 0; x < vector.size(); x++) {
 
 					// start of array element
@@ -149,78 +116,24 @@ namespace AT::serializer {
 
 			} else {		// load from file
 
-				// buffer [m_key_value_pares] for duration of function
-				std::unordered_map<std::string, std::string> key_value_pares_buffer = m_key_value_pares;
-				std::vector<std::unordered_map<std::string, std::string>> vector_of_key_value_pares{};
-				m_key_value_pares = {};
-
-				// buffer [m_file_content] for duration of function
-				std::stringstream file_content_buffer;
-				std::vector<std::stringstream> vector_of_file_content{};		// for array element in file
-				file_content_buffer << m_file_content.str();
-				m_file_content = {};
-
-				// deserialize content of subsections				
-				int64 index = -1;
-				std::string line;
-				while (std::getline(file_content_buffer, line)) {
-
-					// skip empty lines or comments
-					if (line.empty() || line.front() == '#')
-						continue;
-
-					// if line contains desired section enter inner-loop
-					//   has correct indentaion              has correct vector_name                          ends with double-point
-					if ((util::measure_indentation(line, NUM_OF_INDENTING_SPACES) == 0) && (line.find(vector_name) != std::string::npos) && (line.back() == ':')) {
-
-						//     not end of content
-						while (std::getline(file_content_buffer, line)) {
-
-							if (line.front() == '-') {
-
-								vector_of_key_value_pares.push_back({});
-								vector_of_file_content.push_back({});
-								index++;
-							}
-
-							// remove array-prefix "- " or "  "
-							line = line.substr(NUM_OF_INDENTING_SPACES);
-
-							//  more indented                                        beginning of new sub-section
-							if (util::measure_indentation(line, NUM_OF_INDENTING_SPACES) != 0 || line.back() == ':' || line.front() == '-') {
-
-								//m_file_content << line << "\n";
-								vector_of_file_content[index] << line << "\n";
-								continue;
-							}
-
-							std::string key, value;
-							extract_key_value(key, value, line);
-							vector_of_key_value_pares[index][key] = value;
-						}
-					}
-				}
+				const u32 found = find_child(vector_name);
+				u64 count = 0;
+				if (found != INVALID_NODE)
+					for (u32 item = m_nodes[found].first_child; item != INVALID_NODE; item = m_nodes[item].next_sibling)
+						count++;
 
-				ASSERT(vector_of_key_value_pares.size() == vector_of_file_content.size(), "", "two buffers are of diffrent size");
+				if (count > 0) {
 
-				if (vector_of_key_value_pares.size() > 0) {
+					vector.resize(count);
+					const scope outer_scope = m_scope;
+					u32 item = m_nodes[found].first_child;
+					for (u64 x = 0; x < count; x++, item = m_nodes[item].next_sibling) {
 
-					vector.resize(vector_of_key_value_pares.size());
-					for (u64 x = 0; x < vector.size(); x++) {
-
-						m_key_value_pares = vector_of_key_value_pares[x];
-						m_file_content = {};
-						auto temp_buffer = vector_of_file_content[x].str();
-						m_file_content << temp_buffer;
+						enter_scope(item);							// every array element is its own scope
 						vector_function(*this, x);
 					}
+					m_scope = outer_scope;
 				}
-
-				// restore
-				m_key_value_pares = key_value_pares_buffer;
-				auto temp_buffer = file_content_buffer.str();
-				m_file_content << temp_buffer;
-
 			}
 
 			if (vector_func_index != 1)
@@ -249,39 +162,26 @@ namespace AT::serializer {
 		yaml& unordered_map(const std::string& map_name, std::unordered_map<T, K>& map) {
 
 			if (m_option == serializer::option::save_to_file) {											// Serialize the map
-				m_file_content << util::add_spaces(m_level_of_indention) << map_name << ":\n";
-				for (const auto& [key, value] : map)
-					m_file_content << util::add_spaces(m_level_of_indention + 1) << util::to_string<T>(key) << ": " << util::to_string<K>(value) << "\n";
+				write_key(m_level_of_indention, {}, map_name);
+				for (const auto& [key, value] : map) {
+
+					util::convert_to_string<T>(key, m_key_buffer);
+					util::convert_to_string<K>(value, m_value_buffer);
+					write_key_value(m_level_of_indention + 1, {}, m_key_buffer, m_value_buffer);
+				}
 				
 			} else {																					// Deserialize the map
-				
-				// Deserialize map from YAML
-				std::unordered_map<std::string, std::string> temp_map;
-				std::string line;
-				
-				// Read until we find the map section
-				while (std::getline(m_file_content, line)) {
-					if (line.find(map_name + ":") != std::string::npos && 
-						util::measure_indentation(line) == m_level_of_indention) {
-						break;
-					}
-				}
 
-				while (std::getline(m_file_content, line)) {							// Read key-value pairs
-					if (util::measure_indentation(line) <= m_level_of_indention)		// End of map section
-						break;
-					
-					std::string key, value;
-					extract_key_value(key, value, line);
-					temp_map.emplace(std::move(key), std::move(value));
-				}
+				const u32 found = find_child(map_name);
+				if (found == INVALID_NODE)
+					return *this;
+
+				for (u32 child = m_nodes[found].first_child; child != INVALID_NODE; child = m_nodes[child].next_sibling) {
 
-				// Convert strings to actual types
-				for (const auto& [key_str, value_str] : temp_map) {
 					T key;
 					K value;
-					util::convert_from_string(key_str, key);
-					util::convert_from_string(value_str, value);
+					util::convert_from_string(std::string(m_nodes[child].key), key);
+					util::convert_from_string(std::string(m_nodes[child].value), value);
 					map.emplace(std::move(key), std::move(value));
 				}
 			}
@@ -305,33 +205,20 @@ namespace AT::serializer {
 
 			if (m_option == option::save_to_file) {
 				// Serialize the set as a YAML sequence
-				m_file_content << util::add_spaces(m_level_of_indention) << set_name << ":\n";
+				write_key(m_level_of_indention, {}, set_name);
 				for (const auto& element : set) {
-					std::string buffer;
-					util::convert_to_string<T>(element, buffer);
-					m_file_content << util::add_spaces(m_level_of_indention + 1) << "- " << buffer << "\n";
+					util::convert_to_string<T>(element, m_value_buffer);
+					write_element(m_level_of_indention + 1, m_value_buffer);
 				}
 			} else {																	// Deserialize the set from YAML
 
 				std::unordered_set<T> temp_set;
-				std::string line;
-				while (std::getline(m_file_content, line)) {							// Read until we find the set section
-					if (line.find(set_name + ":") != std::string::npos && 
-						util::measure_indentation(line) == m_level_of_indention) {
-						break;
-					}
-				}
+				if (const u32 found = find_child(set_name); found != INVALID_NODE) {
 
-				while (std::getline(m_file_content, line)) {							// Read sequence elements
-					if (util::measure_indentation(line) <= m_level_of_indention) 		// End of set section
-						break;
-					
-					if (line.find("- ") != std::string::npos) {							// Extract element value
+					for (u32 item = m_nodes[found].first_child; item != INVALID_NODE; item = m_nodes[item].next_sibling) {
 
-						size_t dash_pos = line.find("- ");
-						std::string element_str = line.substr(dash_pos + 2);
 						T element;
-						util::convert_from_string(element_str, element);
+						util::convert_from_string(std::string(m_nodes[item].value), element);
 						temp_set.insert(element);
 					}
 				}
@@ -343,28 +230,72 @@ namespace AT::serializer {
 		
 	private:
 
+		static constexpr u32 INVALID_NODE = std::numeric_limits<u32>::max();
+
+		// One line of the loaded section. Keys and values are views into [m_buffer], nothing is copied while parsing.
+		// A sequence item ("- ...") has no key, its value is the raw text after the dash and its children are the keys on and below it.
+		struct node {
+			std::string_view		key{};
+			std::string_view		value{};
+			u32						first_child = INVALID_NODE;
+			u32						last_child = INVALID_NODE;
+			u32						next_sibling = INVALID_NODE;
+		};
+
+		// The node whose children [entry()], [vector()], ... look up, and where the last lookup succeeded
+		struct scope {
+			u32						node = INVALID_NODE;
+			u32						hint = INVALID_NODE;
+		};
+
 		void serialize();
 		yaml& deserialize();
-		void extract_key_value(std::string& key, std::string& value, std::string& line);
+
+		// Appenders for the section being written, indentation is given in levels of [NUM_OF_INDENTING_SPACES]
+		FORCEINLINE void write_indentation(const u32 level) { m_output.append(static_cast<size_t>(level) * NUM_OF_INDENTING_SPACES, ' '); }
+		FORCEINLINE void write_key(const u32 level, const std::string_view prefix, const std::string_view key) { write_indentation(level); m_output.append(prefix).append(key).append(":\n"); }
+		FORCEINLINE void write_element(const u32 level, const std::string_view value) { write_indentation(level); m_output.append("- ").append(value).push_back('\n'); }
+		FORCEINLINE void write_key_value(const u32 level, const std::string_view prefix, const std::string_view key, const std::string_view value) {
+			write_indentation(level);
+			m_output.append(prefix).append(key).append(": ").append(value).push_back('\n');
+		}
+
+		void tokenize(const std::string_view content);
+		u32 add_node(const u32 parent, const std::string_view key, const std::string_view value);
+
+		// Finds the child of the current scope with the given key. Starts at the sibling after the previous match,
+		// so reading keys in file order costs O(1) each.
+		// @return The node index or [INVALID_NODE].
+		u32 find_child(const std::string_view key);
+
+		// Makes [node] the current scope.
+		// @return The previous scope, restore it by assigning to [m_scope].
+		scope enter_scope(const u32 node);
 
 		static const u32 NUM_OF_INDENTING_SPACES = 2;		// should not change
 
 		u32 m_level_of_indention = 0;
 		u64 vector_func_index = 0;
-		std::string m_prefix{};				// can maybe be a [char*]
-		std::string m_prefix_fallback{};	// can maybe be a [char*]
+		std::string_view m_prefix{};
+		std::string_view m_prefix_fallback{};
 
 		// file data
 		std::filesystem::path m_filename{};
-		std::ofstream m_ostream{};
-		std::ifstream m_istream{};
 		
 		// content data
-		bool m_is_correct_struct = false;
 		std::string m_name{};
 		option m_option;
-		std::stringstream m_file_content{};
-		std::unordered_map<std::string, std::string> m_key_value_pares{};
+
+		// written data
+		std::string m_output{};					// the section being written, taken from [s_spare_output] to keep its capacity between saves
+		std::string m_key_buffer{};				// reused conversion buffers
+		std::string m_value_buffer{};
+		static thread_local std::string s_spare_output;
+
+		// loaded data
+		std::string m_buffer{};					// the whole file, [node]s point into it
+		std::vector<node> m_nodes{};			// [0] is the section itself
+		scope m_scope{};
 
 	};
 
@@ -0,0 +1,158 @@
+#include "util/pch.h"
+
+#ifdef PLATFORM_WINDOWS
+
+    #include <Windows.h>
+
+#elif defined(PLATFORM_LINUX)
+
+    #include <time.h>
+
+#else
+    #error undefined platform
+#endif
+
+#include "frame_pacer.h"
+
+namespace AT::util {
+
+    #define MIN_SPIN_MARGIN             std::chrono::microseconds(50)
+    #define MAX_SPIN_MARGIN             std::chrono::microseconds(2000)
+
+
+    frame_pacer::frame_pacer(const u32 target_fps, const pacing_policy policy)
+        : m_policy(policy), m_spin_margin(std::chrono::microseconds(500)) {
+
+        set_target_fps(target_fps);
+
+    #if defined(PLATFORM_WINDOWS)
+        m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (!m_timer)                                                                               // high resolution timers need Windows 10 1803+
+            m_timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+        VALIDATE(m_timer, , "", "Could not create waitable timer, falling back to sleep_for()")
+    #endif
+    }
+
+
+    frame_pacer::~frame_pacer() {
+
+    #if defined(PLATFORM_WINDOWS)
+        if (m_timer)
+            CloseHandle(m_timer);
+    #endif
+    }
+
+
+    void frame_pacer::wait() {
+
+        const clock::time_point now = clock::now();
+        if (m_vsync || m_deadline == clock::time_point{} || now >= m_deadline) {                  // vsync paces in the swap, missed deadlines restart the schedule
+
+            m_deadline = now + m_period;
+            return;
+        }
+
+        sleep_until(m_deadline);
+        const f32 lateness_ms = std::chrono::duration<f32, std::milli>(clock::now() - m_deadline).count();
+        record_jitter(math::max(lateness_ms, 0.f));
+        m_deadline += m_period;
+    }
+
+
+    void frame_pacer::reset() { m_deadline = clock::time_point{}; }
+
+
+    void frame_pacer::set_target_fps(const u32 target_fps) {
+
+        m_target_fps = math::max<u32>(target_fps, 1);
+        m_period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<f64>(1.0 / m_target_fps));
+        reset();
+    }
+
+
+    void frame_pacer::set_policy(const pacing_policy policy) {
+
+        m_policy = policy;
+        reset();
+    }
+
+
+    void frame_pacer::set_vsync(const bool vsync) {
+
+        m_vsync = vsync;
+        reset();
+    }
+
+
+    f32 frame_pacer::get_average_jitter_ms() const {
+
+        if (m_jitter_count == 0)
+            return 0.f;
+
+        f32 sum = 0.f;
+        for (u32 x = 0; x < m_jitter_count; x++)
+            sum += m_jitter_ms[x];
+        return sum / m_jitter_count;
+    }
+
+
+    f32 frame_pacer::get_max_jitter_ms() const {
+
+        f32 max = 0.f;
+        for (u32 x = 0; x < m_jitter_count; x++)
+            max = math::max(max, m_jitter_ms[x]);
+        return max;
+    }
+
+
+    void frame_pacer::sleep_until(const clock::time_point deadline) {
+
+        const clock::time_point wake_up = (m_policy == pacing_policy::precise) ? deadline - m_spin_margin : deadline;
+
+    #if defined(PLATFORM_LINUX)
+
+        // steady_clock is CLOCK_MONOTONIC on linux, so its epoch matches the kernel's absolute timer
+        const auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(wake_up.time_since_epoch()).count();
+        timespec target{};
+        target.tv_sec = static_cast<time_t>(since_epoch / 1'000'000'000);
+        target.tv_nsec = static_cast<long>(since_epoch % 1'000'000'000);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) == EINTR)
+            ;
+
+    #elif defined(PLATFORM_WINDOWS)
+
+        const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(wake_up - clock::now()).count();
+        if (remaining > 0) {
+
+            if (m_timer) {
+                LARGE_INTEGER due_time{};
+                due_time.QuadPart = -static_cast<LONGLONG>(remaining / 100);                           // relative, in 100ns units
+                if (SetWaitableTimerEx(m_timer, &due_time, 0, nullptr, nullptr, nullptr, 0))
+                    WaitForSingleObject(m_timer, INFINITE);
+            } else
+                std::this_thread::sleep_for(std::chrono::nanoseconds(remaining));
+        }
+
+    #endif
+
+        if (m_policy != pacing_policy::precise)
+            return;
+
+        // adapt the margin to how late the kernel woke us: twice the observed oversleep, within sane bounds
+        const clock::duration oversleep = clock::now() - wake_up;
+        const clock::duration target_margin = math::clamp<clock::duration>(oversleep * 2, MIN_SPIN_MARGIN, MAX_SPIN_MARGIN);
+        m_spin_margin = (m_spin_margin * 7 + target_margin) / 8;
+
+        while (clock::now() < deadline)
+            _mm_pause();
+    }
+
+
+    void frame_pacer::record_jitter(const f32 jitter_ms) {
+
+        m_jitter_ms[m_jitter_index] = jitter_ms;
+        m_jitter_index = (m_jitter_index + 1) % JITTER_SAMPLE_COUNT;
+        m_jitter_count = math::min(m_jitter_count + 1, JITTER_SAMPLE_COUNT);
+    }
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+
+namespace AT::util {
+
+    // How a [frame_pacer] reaches its deadline
+    enum class pacing_policy : u8 {
+        low_power = 0,              // sleep until the deadline and accept the scheduler's wake-up latency (no spinning)
+        precise,                    // sleep until shortly before the deadline, spin for the measured wake-up latency
+    };
+
+    // @brief Paces the main loop to a fixed frame rate using absolute deadlines, so sleep errors do not accumulate.
+    //        Linux uses clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME), Windows a high resolution waitable timer.
+    //        When vsync is enabled the swap already blocks, the pacer then only measures.
+    //        The wake-up lateness (jitter) of the last [JITTER_SAMPLE_COUNT] frames is tracked and exposed for diagnostics.
+    class frame_pacer {
+    public:
+
+        static constexpr u32 JITTER_SAMPLE_COUNT = 120;
+
+        frame_pacer(const u32 target_fps = 60, const pacing_policy policy = pacing_policy::low_power);
+        ~frame_pacer();
+
+        DELETE_COPY_MOVE_CONSTRUCTOR(frame_pacer);
+
+        // @brief Blocks until the deadline of the current frame and schedules the next one.
+        //        If the frame already missed its deadline (long frame, idle wait) the schedule restarts from now instead of catching up.
+        void wait();
+
+        // @brief Drops the current schedule, the next [wait()] starts a new one.
+        void reset();
+
+        void set_target_fps(const u32 target_fps);
+        void set_policy(const pacing_policy policy);
+        void set_vsync(const bool vsync);
+
+        DEFAULT_GETTER_C(u32, target_fps);
+        DEFAULT_GETTER_C(pacing_policy, policy);
+        DEFAULT_GETTER_C(bool, vsync);
+
+        // @return Average wake-up lateness over the last frames in milliseconds.
+        f32 get_average_jitter_ms() const;
+
+        // @return Largest wake-up lateness over the last frames in milliseconds.
+        f32 get_max_jitter_ms() const;
+
+    private:
+
+        using clock = std::chrono::steady_clock;
+
+        void sleep_until(const clock::time_point deadline);
+        void record_jitter(const f32 jitter_ms);
+
+        u32                                         m_target_fps = 60;
+        pacing_policy                               m_policy = pacing_policy::low_power;
+        bool                                        m_vsync = false;
+        clock::duration                             m_period{};
+        clock::time_point                           m_deadline{};                   // [clock::time_point{}] = no schedule yet
+        clock::duration                             m_spin_margin{};                // [precise]: wake up this early and spin the rest, adapted to the measured oversleep
+        std::array<f32, JITTER_SAMPLE_COUNT>        m_jitter_ms{};
+        u32                                         m_jitter_index = 0;
+        u32                                         m_jitter_count = 0;
+    #if defined(PLATFORM_WINDOWS)
+        void*                                       m_timer = nullptr;
+    #endif
+    };
+
+}
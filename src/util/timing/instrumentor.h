@@ -97,6 +97,15 @@ namespace AT {
 	};
 
 
+	// Aggregated timing of one profiled scope over an interval, collected in memory for the live performance overlay.
+	struct scope_stats {
+		const char* 				name = nullptr;	// Name passed to PROFILE_SCOPE(), scopes are identified by its content.
+		u64 						calls = 0;      // Number of times the scope finished in the interval.
+		f64 						total_us = 0.0; // Summed duration.
+		f64 						max_us = 0.0;   // Longest single duration.
+	};
+
+
 	// Represents an active profiling session.
 	struct instrumentation_session {
 		std::string 				name; 			// The session's display name.
@@ -173,6 +182,41 @@ namespace AT {
             }
         }
 
+		// Enables or disables the in-memory aggregation of finished scopes (see [take_live_stats()]). Works without a session.
+		// @param enabled While false, profiled scopes that have no session to write to cost a single atomic load.
+		void set_live_stats(const bool enabled) { m_live_stats_enabled.store(enabled, std::memory_order_release); }
+
+		// @return true if a session or the live aggregation consumes timing data.
+		FORCEINLINE bool is_recording() const { return m_session_active.load(std::memory_order_relaxed) || m_live_stats_enabled.load(std::memory_order_relaxed); }
+
+		// @return true if finished scopes should be passed to [record_live_stat()].
+		FORCEINLINE bool is_live_stats_enabled() const { return m_live_stats_enabled.load(std::memory_order_relaxed); }
+
+		// Adds one finished scope to the live aggregation.
+		// @param name The name of the scope, must outlive the instrumentor (string literal / __PRETTY_FUNCTION__).
+		// @param duration_us The duration of the scope in microseconds.
+		void record_live_stat(const char* name, const f64 duration_us) {
+
+			std::lock_guard lock(m_live_stats_mutex);
+			scope_stats& stats = m_live_stats[name];
+			stats.name = name;
+			stats.calls++;
+			stats.total_us += duration_us;
+			stats.max_us = std::max(stats.max_us, duration_us);
+		}
+
+		// Moves everything aggregated since the last call into [stats] and starts a new interval.
+		// @param stats Cleared, then filled with one entry per scope that finished in the interval.
+		void take_live_stats(std::vector<scope_stats>& stats) {
+
+			stats.clear();
+			std::lock_guard lock(m_live_stats_mutex);
+			stats.reserve(m_live_stats.size());
+			for (const auto& [name, entry] : m_live_stats)
+				stats.push_back(entry);
+			m_live_stats.clear();
+		}
+
 		// Returns the singleton instance of the instrumentor.
 		// @return A reference to the global instrumentor instance.
         static instrumentor& get() {
@@ -223,6 +267,9 @@ namespace AT {
 		instrumentation_session*  	m_current_session = nullptr; 	// Active profiling session.
 		std::ofstream            	m_output_stream;     			// Output stream for writing profiling data.
 		std::atomic<bool>        	m_session_active = false; 		// Indicates if a session is active.
+		std::atomic<bool>        	m_live_stats_enabled = false; 	// Aggregate finished scopes in memory.
+		std::mutex 					m_live_stats_mutex;
+		std::unordered_map<std::string_view, scope_stats>	m_live_stats{};	// Aggregation of the current interval, key: scope name (by content, a name can be compiled into several translation units).
 	};
 
 	// ==================================================================== instrumentor_timer ====================================================================
@@ -231,11 +278,13 @@ namespace AT {
 	public:
 
 		// Constructs an instrumentor_timer, starting timing immediately.
+		// Does nothing if neither a session nor the live aggregation is active.
 		// @param name The name of the timed scope or function.
 		instrumentor_timer(const char* name)
-			: m_name(name), m_stopped(false) {
+			: m_name(name), m_stopped(!instrumentor::get().is_recording()) {
 
-			m_start_timepoint = std::chrono::steady_clock::now();
+			if (!m_stopped)
+				m_start_timepoint = std::chrono::steady_clock::now();
 		}
 		
 		// Destructor. Automatically stops timing if it hasn't been stopped already.
@@ -252,7 +301,10 @@ namespace AT {
 			auto high_res_start = float_microseconds{ m_start_timepoint.time_since_epoch() };
 			auto elapsed_time = std::chrono::time_point_cast<std::chrono::microseconds>(end_timepoint).time_since_epoch() - std::chrono::time_point_cast<std::chrono::microseconds>(m_start_timepoint).time_since_epoch();
 
-			instrumentor::get().write_profile({ m_name, high_res_start, elapsed_time, std::this_thread::get_id() });
+			instrumentor& profiler = instrumentor::get();
+			profiler.write_profile({ m_name, high_res_start, elapsed_time, std::this_thread::get_id() });
+			if (profiler.is_live_stats_enabled())
+				profiler.record_live_stat(m_name, std::chrono::duration<f64, std::micro>(end_timepoint - m_start_timepoint).count());
 			m_stopped = true;
 		}
 
@@ -266,7 +318,7 @@ namespace AT {
 
 
 // ==================================== profiler ENABLED ====================================
-#if PROFILE
+#if PROFILE || PROFILE_LIVE
 
     // Resolves to the compiler-specific macro or built-in variable that represents the current
     #if defined(__GNUC__) || (defined(__MWERKS__) && (__MWERKS__ >= 0x3000)) || (defined(__ICC) && (__ICC >= 600)) || defined(__ghs__)
@@ -309,6 +361,7 @@ namespace AT {
     //   - When the timer goes out of scope, it stops and records the result.
    	#define PROFILE_SCOPE_LINE(name, line)						constexpr auto fixed_name##line = name;    	AT::instrumentor_timer benchmark_timer##line(fixed_name##line)
 
+    #if PROFILE
     // Begins a new profiling session and writes results to a JSON file.
     //
     // @param name       The name of the profiling session.
@@ -324,6 +377,12 @@ namespace AT {
     // Usage example:
     //     PROFILER_SESSION_END();
 	#define PROFILER_SESSION_END()                            	AT::instrumentor::get().end_session()
+    #else
+	// trace files DISABLED, PROFILE_LIVE only aggregates in memory. To enable change [PROFILE] in [util/core_config.h]
+	#define PROFILER_SESSION_BEGIN(name, directory, filename)
+	// trace files DISABLED, PROFILE_LIVE only aggregates in memory. To enable change [PROFILE] in [util/core_config.h]
+	#define PROFILER_SESSION_END()
+    #endif
     
 	// Creates a profiling timer for current scope that automatically times a section of code.
     //
@@ -0,0 +1,363 @@
+#include "util/pch.h"
+
+#include <imgui.h>
+#include <imgui_internal.h>
+
+#include "document_editor.h"
+
+namespace AT::UI {
+
+	static FORCEINLINE bool is_utf8_continuation(const char c) { return (static_cast<u8>(c) & 0xC0) == 0x80; }
+
+	static FORCEINLINE bool is_blank_line(const std::string_view line) { return line.find_first_not_of(" \t\r") == std::string_view::npos; }
+
+	static void append_utf8(std::string& target, const u32 code_point) {
+
+		if (code_point < 0x80) {
+			target += static_cast<char>(code_point);
+		} else if (code_point < 0x800) {
+			target += static_cast<char>(0xC0 | (code_point >> 6));
+			target += static_cast<char>(0x80 | (code_point & 0x3F));
+		} else if (code_point < 0x10000) {
+			target += static_cast<char>(0xE0 | (code_point >> 12));
+			target += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+			target += static_cast<char>(0x80 | (code_point & 0x3F));
+		} else {
+			target += static_cast<char>(0xF0 | (code_point >> 18));
+			target += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+			target += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+			target += static_cast<char>(0x80 | (code_point & 0x3F));
+		}
+	}
+
+
+	document_editor::document_editor(std::string text)
+		: m_document(std::move(text)) {}
+
+
+	bool document_editor::draw(const char* label, const ImVec2& size) {
+
+		bool edited = false;
+		ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImGui::GetStyle().FramePadding);
+		ImGui::PushStyleColor(ImGuiCol_ChildBg, ImGui::GetStyleColorVec4(ImGuiCol_FrameBg));
+		const bool visible = ImGui::BeginChild(label, size, true, ImGuiWindowFlags_HorizontalScrollbar | ImGuiWindowFlags_NoMove);
+		ImGui::PopStyleColor();
+		ImGui::PopStyleVar();
+		if (!visible) {
+			ImGui::EndChild();
+			return false;
+		}
+
+		const ImGuiIO& io = ImGui::GetIO();
+		const f32 line_height = ImGui::GetTextLineHeight();
+		const ImVec2 origin = ImGui::GetCursorScreenPos();
+		const bool focused = ImGui::IsWindowFocused();
+
+		if (focused) {
+			handle_keyboard(edited);
+			ImGui::GetCurrentContext()->WantTextInputNextFrame = 1;								// keeps the app loop responsive and shows the on-screen keyboard
+		}
+
+		// mouse: click places the caret, shift+click and dragging select
+		if (ImGui::IsWindowHovered() && ImGui::IsMouseClicked(ImGuiMouseButton_Left) && ImGui::GetCurrentWindow()->InnerClipRect.Contains(io.MousePos)) {
+
+			m_mouse_selecting = true;
+			const size_t line = static_cast<size_t>(math::clamp((io.MousePos.y - origin.y) / line_height, 0.f, static_cast<f32>(m_document.line_count() - 1)));
+			set_cursor(get_offset_at_x(line, io.MousePos.x - origin.x), io.KeyShift);
+		} else if (!ImGui::IsMouseDown(ImGuiMouseButton_Left)) {
+
+			m_mouse_selecting = false;
+		} else if (m_mouse_selecting && focused && ImGui::IsMouseDragging(ImGuiMouseButton_Left)) {
+
+			const size_t line = static_cast<size_t>(math::clamp((io.MousePos.y - origin.y) / line_height, 0.f, static_cast<f32>(m_document.line_count() - 1)));
+			set_cursor(get_offset_at_x(line, io.MousePos.x - origin.x), true);
+		}
+
+		// only lines inside the window are fetched and drawn
+		const size_t line_count = m_document.line_count();
+		const f32 scroll_y = ImGui::GetScrollY();
+		const size_t first_line = math::min(static_cast<size_t>(scroll_y / line_height), line_count - 1);
+		const size_t end_line = math::min(first_line + static_cast<size_t>(ImGui::GetWindowHeight() / line_height) + 2, line_count);
+
+		ImDrawList* draw_list = ImGui::GetWindowDrawList();
+		const ImU32 text_color = ImGui::GetColorU32(ImGuiCol_Text);
+		const ImU32 selection_color = ImGui::GetColorU32(ImGuiCol_TextSelectedBg);
+		const size_t selection_begin = math::min(m_cursor, m_anchor);
+		const size_t selection_end = math::max(m_cursor, m_anchor);
+		const size_t cursor_line = m_document.line_of(m_cursor);
+		for (size_t line = first_line; line < end_line; line++) {
+
+			const size_t line_begin = m_document.line_start(line);
+			const std::string& text = fetch_line(line);
+			const ImVec2 position(origin.x, origin.y + line * line_height);
+
+			if (selection_begin != selection_end && selection_begin <= line_begin + text.size() && selection_end >= line_begin) {
+
+				const size_t local_begin = math::max(selection_begin, line_begin) - line_begin;
+				const size_t local_end = math::min(selection_end, line_begin + text.size()) - line_begin;
+				const f32 x_begin = ImGui::CalcTextSize(text.data(), text.data() + local_begin).x;
+				f32 x_end = ImGui::CalcTextSize(text.data(), text.data() + local_end).x;
+				if (selection_end > line_begin + text.size())												// selected line break
+					x_end += ImGui::GetFontSize() * 0.4f;
+				draw_list->AddRectFilled(ImVec2(position.x + x_begin, position.y), ImVec2(position.x + x_end, position.y + line_height), selection_color);
+			}
+
+			draw_list->AddText(position, text_color, text.data(), text.data() + text.size());
+			m_content_width = math::max(m_content_width, ImGui::CalcTextSize(text.data(), text.data() + text.size()).x + ImGui::GetFontSize());
+
+			if (focused && line == cursor_line && std::fmod(ImGui::GetTime(), 1.2) < 0.8) {				// blinking caret
+				const f32 x = position.x + ImGui::CalcTextSize(text.data(), text.data() + (m_cursor - line_begin)).x;
+				draw_list->AddLine(ImVec2(x, position.y), ImVec2(x, position.y + line_height), text_color);
+			}
+		}
+
+		if (m_scroll_to_cursor) {
+
+			const f32 cursor_y = cursor_line * line_height;
+			if (cursor_y < scroll_y)
+				ImGui::SetScrollY(cursor_y);
+			else if (cursor_y + line_height > scroll_y + ImGui::GetWindowHeight() - ImGui::GetStyle().ScrollbarSize)
+				ImGui::SetScrollY(cursor_y + line_height - ImGui::GetWindowHeight() + ImGui::GetStyle().ScrollbarSize);
+
+			const f32 cursor_x = get_x_of_offset(cursor_line, m_cursor);
+			if (cursor_x < ImGui::GetScrollX())
+				ImGui::SetScrollX(cursor_x);
+			else if (cursor_x > ImGui::GetScrollX() + ImGui::GetWindowWidth() - ImGui::GetFontSize() * 2)
+				ImGui::SetScrollX(cursor_x - ImGui::GetWindowWidth() + ImGui::GetFontSize() * 2);
+			m_scroll_to_cursor = false;
+		}
+
+		ImGui::Dummy(ImVec2(m_content_width, line_count * line_height));
+		ImGui::EndChild();
+		return edited;
+	}
+
+
+	std::vector<std::string> document_editor::get_paragraphs() const {
+
+		std::vector<std::string> paragraphs;
+		std::string current;
+		const std::string text = m_document.to_string();
+		for (size_t begin = 0; begin <= text.size(); ) {
+
+			size_t end = text.find('\n', begin);
+			if (end == std::string::npos)
+				end = text.size();
+
+			const std::string_view line(text.data() + begin, end - begin);
+			if (is_blank_line(line)) {
+				if (!current.empty())
+					paragraphs.push_back(std::move(current));
+				current.clear();
+			} else {
+				if (!current.empty())
+					current += '\n';
+				current.append(line);
+			}
+			begin = end + 1;
+		}
+		if (!current.empty())
+			paragraphs.push_back(std::move(current));
+
+		for (auto& paragraph : paragraphs) {
+			paragraph.erase(0, paragraph.find_first_not_of(" \t\r\n"));
+			paragraph.erase(paragraph.find_last_not_of(" \t\r\n") + 1);
+		}
+		return paragraphs;
+	}
+
+
+	void document_editor::handle_keyboard(bool& edited) {
+
+		ImGuiIO& io = ImGui::GetIO();
+		const bool ctrl = io.KeyCtrl;
+		const bool shift = io.KeyShift;
+		const size_t size_before = m_document.size();
+		const u64 revision_before = m_document.get_revision();
+
+		if (!ctrl && !io.InputQueueCharacters.empty()) {
+
+			std::string typed;
+			for (const ImWchar character : io.InputQueueCharacters) {
+				if (character < 32 && character != '\t')
+					continue;
+				append_utf8(typed, character);
+			}
+			if (!typed.empty())
+				insert_text(typed);
+		}
+		io.InputQueueCharacters.resize(0);
+
+		if (ImGui::IsKeyPressed(ImGuiKey_Enter) || ImGui::IsKeyPressed(ImGuiKey_KeypadEnter))
+			insert_text("\n");
+
+		if (ImGui::IsKeyPressed(ImGuiKey_Backspace) && !erase_selection() && m_cursor > 0) {
+			const size_t previous = get_previous_char(m_cursor);
+			m_document.erase(previous, m_cursor - previous);
+			m_cursor = m_anchor = previous;
+		}
+
+		if (ImGui::IsKeyPressed(ImGuiKey_Delete) && !erase_selection() && m_cursor < m_document.size())
+			m_document.erase(m_cursor, get_next_char(m_cursor) - m_cursor);
+
+		// navigation
+		const size_t line = m_document.line_of(m_cursor);
+		if (ImGui::IsKeyPressed(ImGuiKey_LeftArrow))
+			set_cursor((!shift && m_cursor != m_anchor) ? math::min(m_cursor, m_anchor) : get_previous_char(m_cursor), shift);
+		if (ImGui::IsKeyPressed(ImGuiKey_RightArrow))
+			set_cursor((!shift && m_cursor != m_anchor) ? math::max(m_cursor, m_anchor) : get_next_char(m_cursor), shift);
+		if (ImGui::IsKeyPressed(ImGuiKey_Home))
+			set_cursor(ctrl ? 0 : m_document.line_start(line), shift);
+		if (ImGui::IsKeyPressed(ImGuiKey_End))
+			set_cursor(ctrl ? m_document.size() : m_document.line_end(line), shift);
+
+		const bool up = ImGui::IsKeyPressed(ImGuiKey_UpArrow);
+		const bool down = ImGui::IsKeyPressed(ImGuiKey_DownArrow);
+		const int64 page = static_cast<int64>(ImGui::GetWindowHeight() / ImGui::GetTextLineHeight()) - 1;
+		const int64 line_delta = (up ? -1 : 0) + (down ? 1 : 0) + (ImGui::IsKeyPressed(ImGuiKey_PageUp) ? -page : 0) + (ImGui::IsKeyPressed(ImGuiKey_PageDown) ? page : 0);
+		if (line_delta != 0) {
+
+			const f32 x = (m_preferred_x >= 0.f) ? m_preferred_x : get_x_of_offset(line, m_cursor);
+			const size_t target_line = static_cast<size_t>(math::clamp<int64>(static_cast<int64>(line) + line_delta, 0, static_cast<int64>(m_document.line_count()) - 1));
+			set_cursor(get_offset_at_x(target_line, x), shift);
+			m_preferred_x = x;
+		}
+
+		// shortcuts
+		if (ctrl && ImGui::IsKeyPressed(ImGuiKey_A)) {
+			m_anchor = 0;
+			m_cursor = m_document.size();
+			m_document.break_undo_group();
+		}
+
+		if (ctrl && (ImGui::IsKeyPressed(ImGuiKey_C) || ImGui::IsKeyPressed(ImGuiKey_X)) && m_cursor != m_anchor) {
+			ImGui::SetClipboardText(m_document.substr(math::min(m_cursor, m_anchor), math::max(m_cursor, m_anchor) - math::min(m_cursor, m_anchor)).c_str());
+			if (ImGui::IsKeyPressed(ImGuiKey_X))
+				erase_selection();
+		}
+
+		if (ctrl && ImGui::IsKeyPressed(ImGuiKey_V)) {
+			const char* clipboard = ImGui::GetClipboardText();
+			if (clipboard && *clipboard) {
+				std::string text(clipboard);
+				std::erase(text, '\r');																	// windows line endings
+				m_document.break_undo_group();
+				insert_text(text);
+				m_document.break_undo_group();
+			}
+		}
+
+		size_t cursor = m_cursor;
+		if (ctrl && ImGui::IsKeyPressed(ImGuiKey_Z) && (shift ? m_document.redo(cursor) : m_document.undo(cursor)))
+			m_cursor = m_anchor = cursor;
+		if (ctrl && ImGui::IsKeyPressed(ImGuiKey_Y) && m_document.redo(cursor))
+			m_cursor = m_anchor = cursor;
+
+		if (m_document.get_revision() != revision_before) {
+			edited = true;
+			m_preferred_x = -1.f;
+			m_scroll_to_cursor = true;
+			if (m_document.size() < size_before)
+				m_content_width = 0.f;																		// re-measured from the visible lines
+		}
+	}
+
+
+	void document_editor::insert_text(const std::string_view text) {
+
+		erase_selection();
+		m_document.insert(m_cursor, text);
+		m_cursor += text.size();
+		m_anchor = m_cursor;
+	}
+
+
+	bool document_editor::erase_selection() {
+
+		if (m_cursor == m_anchor)
+			return false;
+
+		const size_t begin = math::min(m_cursor, m_anchor);
+		m_document.break_undo_group();
+		m_document.erase(begin, math::max(m_cursor, m_anchor) - begin);
+		m_cursor = m_anchor = begin;
+		return true;
+	}
+
+
+	void document_editor::set_cursor(const size_t offset, const bool extend_selection) {
+
+		m_cursor = math::min(offset, m_document.size());
+		if (!extend_selection)
+			m_anchor = m_cursor;
+		m_preferred_x = -1.f;
+		m_scroll_to_cursor = true;
+		m_document.break_undo_group();
+	}
+
+
+	size_t document_editor::get_previous_char(size_t offset) const {
+
+		if (offset == 0)
+			return 0;
+		offset--;
+		while (offset > 0 && is_utf8_continuation(m_document.at(offset)))
+			offset--;
+		return offset;
+	}
+
+
+	size_t document_editor::get_next_char(size_t offset) const {
+
+		const size_t size = m_document.size();
+		if (offset >= size)
+			return size;
+		offset++;
+		while (offset < size && is_utf8_continuation(m_document.at(offset)))
+			offset++;
+		return offset;
+	}
+
+
+	f32 document_editor::get_x_of_offset(const size_t line, const size_t offset) {
+
+		const std::string& text = fetch_line(line);
+		const size_t local = math::min(offset - math::min(offset, m_document.line_start(line)), text.size());
+		return ImGui::CalcTextSize(text.data(), text.data() + local).x;
+	}
+
+
+	size_t document_editor::get_offset_at_x(const size_t line, const f32 x) {
+
+		const std::string& text = fetch_line(line);
+		const size_t line_begin = m_document.line_start(line);
+		f32 width = 0.f;
+		for (size_t index = 0; index < text.size(); ) {
+
+			size_t next = index + 1;
+			while (next < text.size() && is_utf8_continuation(text[next]))
+				next++;
+			const f32 char_width = ImGui::CalcTextSize(text.data() + index, text.data() + next).x;
+			if (x < width + char_width * 0.5f)
+				return line_begin + index;
+			width += char_width;
+			index = next;
+		}
+		return line_begin + text.size();
+	}
+
+
+	const std::string& document_editor::fetch_line(const size_t line) {
+
+		if (line != m_line_buffer_line || m_document.get_revision() != m_line_buffer_revision) {
+
+			const size_t begin = m_document.line_start(line);
+			m_line_buffer.clear();
+			m_document.for_each_chunk(begin, m_document.line_end(line) - begin, [this](const std::string_view chunk) { m_line_buffer.append(chunk); });
+			m_line_buffer_line = line;
+			m_line_buffer_revision = m_document.get_revision();
+		}
+		return m_line_buffer;
+	}
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "util/data_structures/piece_table.h"
+
+struct ImVec2;
+
+
+namespace AT::UI {
+
+	// Editor widget for long texts (a whole chapter), backed by a [util::piece_table].
+	// Only the visible lines are fetched and drawn and every keystroke is a single piece table edit,
+	// so the cost of typing does not depend on the document size. Lines are not soft-wrapped, the view scrolls horizontally.
+	// Supports selection, clipboard, undo/redo (Ctrl+Z / Ctrl+Y) and UTF-8 text.
+	class document_editor {
+	public:
+
+		document_editor(std::string text = {});
+
+		DELETE_COPY_MOVE_CONSTRUCTOR(document_editor);
+
+		// Draws the editor as a child window and processes input while it is focused.
+		// @param label The ImGui ID of the editor.
+		// @param size The size of the child window, see ImGui::BeginChild().
+		// @return true if the text was changed this frame.
+		bool draw(const char* label, const ImVec2& size);
+
+		// Splits the document into paragraphs, separated by one or more empty lines. Leading and trailing whitespace is trimmed.
+		// @return The non-empty paragraphs in document order.
+		std::vector<std::string> get_paragraphs() const;
+
+		FORCEINLINE const util::piece_table& get_document() const { return m_document; }
+
+	private:
+
+		void handle_keyboard(bool& edited);
+		void insert_text(const std::string_view text);
+		bool erase_selection();
+		void set_cursor(const size_t offset, const bool extend_selection);
+		size_t get_previous_char(const size_t offset) const;
+		size_t get_next_char(const size_t offset) const;
+		f32 get_x_of_offset(const size_t line, const size_t offset);
+		size_t get_offset_at_x(const size_t line, const f32 x);
+		const std::string& fetch_line(const size_t line);
+
+		util::piece_table					m_document;
+		size_t								m_cursor = 0;					// byte offset of the caret
+		size_t								m_anchor = 0;					// other end of the selection, == [m_cursor] if nothing is selected
+		f32									m_preferred_x = -1.f;			// x position kept while moving up/down, -1 = use the caret position
+		f32									m_content_width = 0.f;			// widest line drawn so far, sets the horizontal scroll range
+		bool								m_scroll_to_cursor = false;
+		bool								m_mouse_selecting = false;		// the left button was pressed inside the text, dragging selects
+		std::string							m_line_buffer{};				// text of the line last fetched by [fetch_line()]
+		size_t								m_line_buffer_line = SIZE_MAX;
+		u64									m_line_buffer_revision = 0;
+	};
+
+}
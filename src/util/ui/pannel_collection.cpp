@@ -10,6 +10,7 @@
 #include <imgui_internal.h>
 
 #include "config/imgui_config.h"
+#include "util/audio/peaks.h"
 
 #include "pannel_collection.h"
 
@@ -297,6 +298,17 @@ namespace AT::UI {
 	}
 
 
+	const char* calc_word_wrap_position(const f32 font_size, const char* text, const char* text_end, const f32 wrap_width) {
+
+		ImFont* font = ImGui::GetFont();
+	#if IMGUI_VERSION_NUM >= 19200
+		return font->CalcWordWrapPosition(font_size, text, text_end, wrap_width);
+	#else
+		return font->CalcWordWrapPositionA(font_size / font->FontSize, text, text_end, wrap_width);
+	#endif
+	}
+
+
 	void set_next_window_pos(const window_pos location, const f32 padding) {
 
 		if (location == window_pos::center)
@@ -508,6 +520,7 @@ namespace AT::UI {
 		if (!ImGui::ItemAdd(bb, id))
 			return;
 		
+		application::request_animation_frame();		// only animates while visible, lazy redraw may sleep otherwise
 		window->DrawList->PathClear();		// Render
 		
 		const int num_segments = 60;
@@ -541,6 +554,7 @@ namespace AT::UI {
 		if (!ImGui::ItemAdd(bb, id))
 			return;
 		
+		application::request_animation_frame();
 		const f32 t = g.Time;
 		const auto degree_offset = 2.0f * IM_PI / circle_count;
 		for (int i = 0; i < circle_count; ++i) {
@@ -556,6 +570,37 @@ namespace AT::UI {
 		}
 	}
 
+	void waveform(const char* label, std::span<const audio::peak> peaks, const ImVec2& size, const ImU32 color) {
+
+		ImGuiWindow* window = ImGui::GetCurrentWindow();
+		if (window->SkipItems)
+			return;
+
+		const ImGuiID id = window->GetID(label);
+		const ImVec2 pos = window->DC.CursorPos;
+		const ImRect bb(pos, pos + size);
+		ImGui::ItemSize(bb);
+		if (!ImGui::ItemAdd(bb, id) || peaks.empty())
+			return;
+
+		const u32 columns = static_cast<u32>(size.x);
+		const f32 center_y = pos.y + size.y * 0.5f;
+		const f32 scale_y = (size.y * 0.5f) / 127.f;
+		for (u32 x = 0; x < columns; x++) {
+
+			const size_t start = (x * peaks.size()) / columns;							// at most a couple of buckets per column when drawing the matching pyramid level
+			const size_t end = math::max(((x + 1) * peaks.size()) / columns, start + 1);
+			int8 min = peaks[start].min;
+			int8 max = peaks[start].max;
+			for (size_t y = start + 1; y < end; y++) {
+				min = math::min(min, peaks[y].min);
+				max = math::max(max, peaks[y].max);
+			}
+
+			window->DrawList->AddRectFilled(ImVec2(pos.x + x, center_y - max * scale_y), ImVec2(pos.x + x + 1, center_y - min * scale_y + 1), color);
+		}
+	}
+
 	// ============================================================================================================
 	// TEXT
 	// ============================================================================================================
@@ -1014,6 +1059,47 @@ namespace AT::UI {
 		return false;
 	}
 
+
+	struct string_input_data {
+		std::string*				text;
+		ImGuiInputTextCallback		chained_callback;
+		void*						chained_user_data;
+	};
+
+	static int string_input_callback(ImGuiInputTextCallbackData* data) {
+
+		auto* input_data = static_cast<string_input_data*>(data->UserData);
+		if (data->EventFlag == ImGuiInputTextFlags_CallbackResize) {
+
+			// ImGui asks for more capacity: resize the string and hand back its (possibly moved) buffer
+			std::string* text = input_data->text;
+			IM_ASSERT(data->Buf == text->c_str());
+			text->resize(static_cast<size_t>(data->BufTextLen));
+			data->Buf = text->data();
+			return 0;
+		}
+
+		if (!input_data->chained_callback)
+			return 0;
+
+		data->UserData = input_data->chained_user_data;
+		return input_data->chained_callback(data);
+	}
+
+	bool input_text(const char* label, std::string& text, ImGuiInputTextFlags flags, ImGuiInputTextCallback callback, void* user_data) {
+
+		IM_ASSERT((flags & ImGuiInputTextFlags_CallbackResize) == 0);
+		string_input_data input_data{ &text, callback, user_data };
+		return ImGui::InputText(label, text.data(), text.capacity() + 1, flags | ImGuiInputTextFlags_CallbackResize, string_input_callback, &input_data);
+	}
+
+	bool input_text_multiline(const char* label, std::string& text, const ImVec2& size, ImGuiInputTextFlags flags, ImGuiInputTextCallback callback, void* user_data) {
+
+		IM_ASSERT((flags & ImGuiInputTextFlags_CallbackResize) == 0);
+		string_input_data input_data{ &text, callback, user_data };
+		return ImGui::InputTextMultiline(label, text.data(), text.capacity() + 1, size, flags | ImGuiInputTextFlags_CallbackResize, string_input_callback, &input_data);
+	}
+
 	bool table_row_slider_int(std::string_view label, int& value, int min_value, int max_value, ImGuiInputTextFlags flags) {
 
 		// ImGuiStyle& style = ImGui::GetStyle();
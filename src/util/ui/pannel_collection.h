@@ -29,6 +29,10 @@ static FORCEINLINE ImVec4  operator*(const ImVec4& lhs, const ImVec4& rhs) { ret
 static FORCEINLINE bool    operator==(const ImVec4& lhs, const ImVec4& rhs) { return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z && lhs.w == rhs.w; }
 static FORCEINLINE bool    operator!=(const ImVec4& lhs, const ImVec4& rhs) { return lhs.x != rhs.x || lhs.y != rhs.y || lhs.z != rhs.z || lhs.w != rhs.w; }
 
+namespace AT::audio {
+	struct peak;
+}
+
 namespace AT::UI {
 
 	enum class window_pos {
@@ -93,6 +97,12 @@ namespace AT::UI {
 	// @return The wrapped text as a string.
 	std::string wrap_text_at_underscore(const std::string& text, f32 wrap_width);
 
+	// @brief Finds where a line of the current font wraps, ImFont changed this search (name and scale/size argument) between imgui releases.
+	// @param [font_size] The size the text is drawn at, usually ImGui::GetFontSize().
+	// @param [wrap_width] The maximum line width.
+	// @return The first character of [text, text_end) that no longer fits on the line, [text_end] if all of it fits.
+	const char* calc_word_wrap_position(const f32 font_size, const char* text, const char* text_end, const f32 wrap_width);
+
 	// @brief Sets the position of the next ImGui window based on a predefined location.
 	// @param [location] The desired position of the window (e.g., center, top-left).
 	// @param [padding] The padding to apply around the window.
@@ -140,6 +150,13 @@ namespace AT::UI {
 	// this is an adapted version from [alexsr] from [https://github.com/ocornut/imgui/issues/1901]
 	void loading_indicator_circle(const char* label, const f32 indicator_radius = 20, const int circle_count = 10, const f32 speed = 7.f, const ImVec4& main_color = ImGui::GetColorU32(ImGuiCol_ButtonHovered), const ImVec4& backdrop_color = ImGui::GetColorU32(ImGuiCol_FrameBg));
 
+	// @brief Draws a min/max waveform thumbnail as one vertical bar per pixel column. Nothing is drawn if the item is clipped.
+	// @param [label] Used to generate the item ID.
+	// @param [peaks] The level of a peak pyramid to draw, should contain at least [size.x] peaks (see audio::peak_view::get_level_for_width()).
+	// @param [size] The size of the thumbnail.
+	// @param [color] The color of the waveform bars.
+	void waveform(const char* label, std::span<const audio::peak> peaks, const ImVec2& size, const ImU32 color = ImGui::GetColorU32(ImGuiCol_PlotLines));
+
 	// ============================================================================================================
 	// TEXT
 	// ============================================================================================================
@@ -204,6 +221,18 @@ namespace AT::UI {
 	// @return true if the search text was changed, false otherwise.
 	bool serach_input(const char* lable, std::string& search_text);
 
+	// @brief InputText bound directly to a std::string, the string grows through ImGuiInputTextFlags_CallbackResize instead of being copied into a fixed buffer.
+	// @param [label] The ImGui label of the widget.
+	// @param [text] The string that is edited in place, it has no length limit.
+	// @param [flags] Additional flags, ImGuiInputTextFlags_CallbackResize is added internally.
+	// @param [callback] Optional user callback, receives every event except the resize.
+	// @param [user_data] Passed to [callback] as ImGuiInputTextCallbackData::UserData.
+	// @return true if the text was changed.
+	bool input_text(const char* label, std::string& text, ImGuiInputTextFlags flags = 0, ImGuiInputTextCallback callback = nullptr, void* user_data = nullptr);
+
+	// @brief Multiline version of [input_text()].
+	bool input_text_multiline(const char* label, std::string& text, const ImVec2& size = ImVec2(0, 0), ImGuiInputTextFlags flags = 0, ImGuiInputTextCallback callback = nullptr, void* user_data = nullptr);
+
 	
 	void color_picker(ImVec4& color);
 
@@ -0,0 +1,125 @@
+#include "util/pch.h"
+
+#include <imgui.h>
+#include <implot.h>
+
+#include "application.h"
+#include "render/renderer.h"
+
+#include "performance_overlay.h"
+
+namespace AT::UI {
+
+	performance_overlay::~performance_overlay() {
+
+		if (m_open)
+			instrumentor::get().set_live_stats(false);
+	}
+
+
+	void performance_overlay::set_open(const bool open) {
+
+		if (open == m_open)
+			return;
+
+		m_open = open;
+		instrumentor::get().set_live_stats(open);
+		m_top_scopes.clear();
+		m_interval_start = 0.0;
+	}
+
+
+	void performance_overlay::draw() {
+
+		if (!m_open)
+			return;
+
+		PROFILE_SCOPE("performance_overlay::draw");
+
+		// scope aggregation runs in one second intervals, the overlay shows the last complete one
+		const f64 now = ImGui::GetTime();
+		if (m_interval_start == 0.0 || now - m_interval_start >= 1.0) {
+
+			m_interval_duration = (m_interval_start == 0.0) ? 1.0 : now - m_interval_start;
+			instrumentor::get().take_live_stats(m_top_scopes);
+			std::sort(m_top_scopes.begin(), m_top_scopes.end(), [](const scope_stats& a, const scope_stats& b) { return a.total_us > b.total_us; });
+			if (m_top_scopes.size() > TOP_SCOPE_COUNT)
+				m_top_scopes.resize(TOP_SCOPE_COUNT);
+			m_interval_start = now;
+		}
+
+		auto& app = application::get();
+		const render::general_performance_metrik& metrik = app.get_renderer()->get_general_performance_metrik_ref();
+		const util::frame_pacer& pacer = app.get_frame_pacer();
+
+		const ImGuiViewport* viewport = ImGui::GetMainViewport();
+		ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + viewport->WorkSize.x - 10.f, viewport->WorkPos.y + 10.f), ImGuiCond_FirstUseEver, ImVec2(1.f, 0.f));
+		ImGui::SetNextWindowSize(ImVec2(480.f, 0.f), ImGuiCond_FirstUseEver);
+		ImGui::SetNextWindowBgAlpha(0.9f);
+		bool open = m_open;
+		if (ImGui::Begin("Performance##performance_overlay", &open, ImGuiWindowFlags_NoCollapse)) {
+
+			ImGui::Text("FPS: %u   work: %.2f ms   sleep: %.2f ms", app.get_fps(), metrik.work_time, metrik.sleep_time);
+			ImGui::Text("pacer jitter: avg %.3f ms   max %.3f ms", pacer.get_average_jitter_ms(), pacer.get_max_jitter_ms());
+			ImGui::Text("ImGui: %u draw calls   %llu vertices", metrik.draw_calls, static_cast<unsigned long long>(metrik.vertices));
+
+			// unroll the ring buffers, oldest sample first
+			const u32 sample_count = GENERAL_PERFORMANCE_METRIK_ARRAY_SIZE;
+			m_work_ms.resize(sample_count);
+			m_sleep_ms.resize(sample_count);
+			for (u32 x = 0; x < sample_count; x++) {
+				const u32 index = (metrik.current_index + x) % sample_count;
+				m_work_ms[x] = metrik.renderer_draw_time[index];
+				m_sleep_ms[x] = metrik.waiting_idle_time[index];
+			}
+
+			if (ImPlot::BeginPlot("##frame_times", ImVec2(-1, 160), ImPlotFlags_NoMenus | ImPlotFlags_NoBoxSelect | ImPlotFlags_NoMouseText)) {
+
+				ImPlot::SetupAxes(nullptr, "ms", ImPlotAxisFlags_NoTickLabels, ImPlotAxisFlags_AutoFit);
+				ImPlot::SetupAxisLimits(ImAxis_X1, 0, sample_count, ImPlotCond_Always);
+				ImPlot::SetNextFillStyle(IMPLOT_AUTO_COL, 0.35f);
+				ImPlot::PlotShaded("work", m_work_ms.data(), sample_count);
+				ImPlot::PlotLine("work", m_work_ms.data(), sample_count);
+				ImPlot::PlotLine("sleep", m_sleep_ms.data(), sample_count);
+				ImPlot::EndPlot();
+			}
+
+			ImGui::Spacing();
+			ImGui::TextDisabled("Most expensive scopes (last second)");
+			ImGui::Separator();
+			if (m_top_scopes.empty())
+				ImGui::TextDisabled("No PROFILE_SCOPE() finished in the last interval");
+			else if (ImGui::BeginTable("##top_scopes", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingStretchProp)) {
+
+				ImGui::TableSetupColumn("scope", ImGuiTableColumnFlags_WidthStretch, 4.f);
+				ImGui::TableSetupColumn("ms/s", ImGuiTableColumnFlags_WidthStretch, 1.f);
+				ImGui::TableSetupColumn("calls/s", ImGuiTableColumnFlags_WidthStretch, 1.f);
+				ImGui::TableSetupColumn("avg us", ImGuiTableColumnFlags_WidthStretch, 1.f);
+				ImGui::TableSetupColumn("max us", ImGuiTableColumnFlags_WidthStretch, 1.f);
+				ImGui::TableHeadersRow();
+				for (const scope_stats& stats : m_top_scopes) {
+
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(stats.name);
+					if (ImGui::IsItemHovered())
+						ImGui::SetTooltip("%s", stats.name);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.2f", stats.total_us / 1000.0 / m_interval_duration);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.0f", stats.calls / m_interval_duration);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.1f", stats.total_us / static_cast<f64>(stats.calls));
+					ImGui::TableNextColumn();
+					ImGui::Text("%.1f", stats.max_us);
+				}
+				ImGui::EndTable();
+			}
+		}
+		ImGui::End();
+
+		if (!open)
+			set_open(false);
+	}
+
+}
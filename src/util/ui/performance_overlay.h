@@ -0,0 +1,35 @@
+#pragma once
+
+
+namespace AT::UI {
+
+	// In-app performance overlay for live diagnosis without trace files.
+	// Shows the work vs. sleep time of the last frames (application::limit_fps), the ImGui vertex and draw call count
+	// of the last submitted frame, the frame pacer jitter and the most expensive PROFILE_SCOPE()s of the last second.
+	// Scope timing is only collected while the overlay is open (see [instrumentor::set_live_stats()]).
+	class performance_overlay {
+	public:
+
+		~performance_overlay();
+
+		// Opens or closes the overlay and starts/stops the scope aggregation.
+		void set_open(const bool open);
+		FORCEINLINE void toggle() { set_open(!m_open); }
+		DEFAULT_GETTER_C(bool, open);
+
+		// Draws the overlay window, does nothing while closed. Call once per frame inside the ImGui frame.
+		void draw();
+
+	private:
+
+		static constexpr u32 TOP_SCOPE_COUNT = 12;
+
+		bool								m_open = false;
+		f64									m_interval_start = 0.0;			// ImGui time at which the current aggregation interval started
+		f64									m_interval_duration = 1.0;		// length of the interval in [m_top_scopes], normalizes calls/s
+		std::vector<scope_stats>			m_top_scopes{};					// most expensive scopes of the last complete interval, sorted by total time
+		std::vector<f32>					m_work_ms{};					// unrolled copies of the ring buffers for plotting
+		std::vector<f32>					m_sleep_ms{};
+	};
+
+}
@@ -0,0 +1,74 @@
+#include "util/pch.h"
+
+#include <imgui.h>
+
+#include "pannel_collection.h"
+
+#include "text_layout_cache.h"
+
+namespace AT::UI {
+
+	static FORCEINLINE bool is_blank(const char c) { return c == ' ' || c == '\t'; }
+
+
+	void compute_line_starts(const std::string_view text, const f32 wrap_width, std::vector<u32>& line_starts) {
+
+		line_starts.clear();
+		line_starts.push_back(0);
+
+		const f32 font_size = ImGui::GetFontSize();
+		const char* begin = text.data();
+		const char* end = begin + text.size();
+		const char* cursor = begin;
+		while (cursor < end) {
+
+			const char* paragraph_end = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+			if (!paragraph_end)
+				paragraph_end = end;
+
+			const char* wrap_position = (wrap_width > 0.f) ? calc_word_wrap_position(font_size, cursor, paragraph_end, wrap_width) : paragraph_end;
+			if (wrap_position < paragraph_end) {
+
+				cursor = (wrap_position == cursor) ? cursor + 1 : wrap_position;		// a single glyph wider than the wrap width still advances
+				while (cursor < end && is_blank(*cursor))								// wrapping swallows the following blanks and one newline, like ImGui does
+					cursor++;
+				if (cursor < end && *cursor == '\n')
+					cursor++;
+
+			} else {
+
+				if (paragraph_end == end)
+					break;
+				cursor = paragraph_end + 1;
+			}
+			line_starts.push_back(static_cast<u32>(cursor - begin));
+		}
+	}
+
+
+	const text_layout& text_layout_cache::get(const UUID ID, const u64 revision, const std::string_view text, const f32 wrap_width) {
+
+		const f32 font_size = ImGui::GetFontSize();
+		text_layout& layout = m_layouts[ID];
+		if (layout.line_starts.empty() || layout.revision != revision || layout.wrap_width != wrap_width || layout.font_size != font_size || layout.generation != m_generation) {
+
+			compute_line_starts(text, wrap_width, layout.line_starts);
+			layout.revision = revision;
+			layout.wrap_width = wrap_width;
+			layout.font_size = font_size;
+			layout.generation = m_generation;
+			layout.height = static_cast<f32>(layout.line_starts.size()) * font_size;
+		}
+		return layout;
+	}
+
+
+	void text_layout_cache::erase(const UUID ID) { m_layouts.erase(ID); }
+
+
+	void text_layout_cache::invalidate_all() { m_generation++; }
+
+
+	void text_layout_cache::clear() { m_layouts.clear(); }
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "util/data_structures/UUID.h"
+
+
+namespace AT::UI {
+
+	// Word-wrapped layout of one text, as ImGui would break it at [wrap_width] with the font that was active when it was measured
+	struct text_layout {
+		u64							revision = 0;					// content revision the layout was computed for
+		f32							wrap_width = 0.f;
+		f32							font_size = 0.f;
+		u32							generation = 0;					// cache generation, see [text_layout_cache::invalidate_all()]
+		f32							height = 0.f;					// [line_starts.size()] * font size, a trailing newline counts as a line like in InputText
+		std::vector<u32>			line_starts{};					// byte offset of every visual line, always starts with 0
+	};
+
+	// Caches the wrapped layout of texts identified by a UUID, e.g. input_field contents.
+	// An entry is reused as long as (revision, wrap width, font size) match, so steady-state frames do no glyph walks.
+	// Owners bump the revision from their edit callback; resize events call [invalidate_all()].
+	class text_layout_cache {
+	public:
+
+		// Returns the layout of [text], measuring it only if the cached entry does not match.
+		// Must be called between ImGui::NewFrame() and ImGui::Render(), the current font is used for measuring.
+		// @param ID Identifies the text.
+		// @param revision Incremented by the owner whenever [text] changes.
+		// @param text The text to lay out.
+		// @param wrap_width The width at which lines are wrapped, <= 0 disables wrapping.
+		// @return The cached layout, valid until the next call for the same [ID].
+		const text_layout& get(const UUID ID, const u64 revision, const std::string_view text, const f32 wrap_width);
+
+		// Drops the layout of [ID], used when the text is deleted.
+		void erase(const UUID ID);
+
+		// Marks all layouts as outdated (window resize, font change). Entries are re-measured lazily when queried.
+		void invalidate_all();
+
+		// Removes all entries.
+		void clear();
+
+		FORCEINLINE size_t size() const { return m_layouts.size(); }
+
+		// @return Changes with every [invalidate_all()], lets owners of derived values (e.g. row offsets) notice outdated layouts.
+		FORCEINLINE u32 get_generation() const { return m_generation; }
+
+	private:
+
+		std::unordered_map<UUID, text_layout>	m_layouts{};
+		u32										m_generation = 0;
+	};
+
+	// Computes the byte offsets at which ImGui's word wrapping starts a new visual line.
+	// @param text The text to wrap.
+	// @param wrap_width The width at which lines are wrapped, <= 0 only breaks at '\n'.
+	// @param line_starts Receives the offsets, the first entry is always 0.
+	void compute_line_starts(const std::string_view text, const f32 wrap_width, std::vector<u32>& line_starts);
+
+}